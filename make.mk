@@ -21,10 +21,12 @@ DOXYGEN := $(shell which doxygen 2> /dev/null)
 DOT := $(shell which dot 2> /dev/null)
 
 MODULES = $(TOPDIR)/src/rtplf/$(PLF) $(TOPDIR)/src/rtfifo $(TOPDIR)/src/rthsm \
+           $(TOPDIR)/src/rtheap $(TOPDIR)/src/rtpool \
            $(TOPDIR)/src/rttest
 
 # Path for make to search for source files
-VPATH = $(foreach i,$(MODULES),$(i)/src) $(foreach i,$(MODULES),$(i)/test)
+VPATH = $(foreach i,$(MODULES),$(i)/src) $(foreach i,$(MODULES),$(i)/test) \
+        $(foreach i,$(MODULES),$(i)/bench)
 
 # Output libraries
 OUTPUT_LIBS = librtsys.a librttest.a
@@ -36,11 +38,26 @@ INCS = $(foreach i,$(MODULES),-I$(i)/include)
 HDRS = $(foreach i,$(MODULES),$(wildcard $(i)/include/*.h))
 
 # List of object files for various targets
-LIBRTSYS_OBJS = rtplf.o rtfifo.o rthsm.o
+LIBRTSYS_OBJS = rtplf.o rtfifo.o rtspscfifo.o rtmpscfifo.o \
+                rtmpmcfifo.o rtpow2fifo.o rtmsgring.o \
+                rtlargefifo.o rtshmfifo.o rtmirrorfifo.o rtpriofifo.o \
+                rtbroadcastring.o rtstealdeque.o rtshardedqueue.o \
+                rtjournalfifo.o rthsm.o rtheap.o rtpool.o
 LIBRTTEST_OBJS = rttest.o
 RTTEST_MAIN_OBJ = rttestmain.o
 RTTEST_TEST_OBJS = unittest1.o unittest2.o testme.o
-RTSYS_TEST_OBJS = test-rtplf.o test-rtfifo.o test-rthsm.o
+RTSYS_TEST_OBJS = test-rtplf.o test-rtfifo.o test-rtspscfifo.o \
+                  test-rtmpscfifo.o test-rtmpmcfifo.o test-rtpow2fifo.o \
+                  test-rtmsgring.o test-rtlargefifo.o test-rtshmfifo.o \
+                  test-rtmirrorfifo.o test-rtpriofifo.o \
+                  test-rtbroadcastring.o test-rtstealdeque.o \
+                  test-rtshardedqueue.o test-rtjournalfifo.o test-rthsm.o \
+                  test-rtheap.o test-rtpool.o
+
+# Benchmark programs; each is built from a single source file of the same name
+BENCH_PROGS = bench-rtbigmem bench-rtfifo bench-rtspscfifo bench-rtmpmcfifo \
+              bench-rtpow2fifo bench-rtstealdeque bench-rtshardedqueue \
+              bench-rtjournalfifo bench-rtheap
 
 
 # Standard targets
@@ -102,9 +119,54 @@ rtplf.o: rtplf.c
 rtfifo.o: rtfifo.c
 	@$(call RUN_CC_P,$@,$<)
 
+rtspscfifo.o: rtspscfifo.c
+	@$(call RUN_CC_P,$@,$<)
+
+rtmpscfifo.o: rtmpscfifo.c
+	@$(call RUN_CC_P,$@,$<)
+
+rtmpmcfifo.o: rtmpmcfifo.c
+	@$(call RUN_CC_P,$@,$<)
+
+rtpow2fifo.o: rtpow2fifo.c
+	@$(call RUN_CC_P,$@,$<)
+
+rtmsgring.o: rtmsgring.c
+	@$(call RUN_CC_P,$@,$<)
+
+rtlargefifo.o: rtlargefifo.c
+	@$(call RUN_CC_P,$@,$<)
+
+rtshmfifo.o: rtshmfifo.c
+	@$(call RUN_CC_P,$@,$<)
+
+rtmirrorfifo.o: rtmirrorfifo.c
+	@$(call RUN_CC_P,$@,$<)
+
+rtpriofifo.o: rtpriofifo.c
+	@$(call RUN_CC_P,$@,$<)
+
+rtbroadcastring.o: rtbroadcastring.c
+	@$(call RUN_CC_P,$@,$<)
+
+rtstealdeque.o: rtstealdeque.c
+	@$(call RUN_CC_P,$@,$<)
+
+rtshardedqueue.o: rtshardedqueue.c
+	@$(call RUN_CC_P,$@,$<)
+
+rtjournalfifo.o: rtjournalfifo.c
+	@$(call RUN_CC_P,$@,$<)
+
 rthsm.o: rthsm.c
 	@$(call RUN_CC_P,$@,$<)
 
+rtheap.o: rtheap.c
+	@$(call RUN_CC_P,$@,$<)
+
+rtpool.o: rtpool.c
+	@$(call RUN_CC_P,$@,$<)
+
 librtsys.a: $(LIBRTSYS_OBJS)
 
 librttest.a: $(LIBRTTEST_OBJS)
@@ -115,6 +177,9 @@ rttest_unit_tests: $(RTTEST_TEST_OBJS) $(RTTEST_MAIN_OBJ) $(OUTPUT_LIBS)
 rtsys_unit_tests: $(RTSYS_TEST_OBJS) $(RTTEST_MAIN_OBJ) $(OUTPUT_LIBS)
 	@$(call RUN_LINK,$@,$(filter %.o,$^),-lrttest -lrtsys)
 
+bench-%: bench-%.o librtsys.a
+	@$(call RUN_LINK,$@,$(filter %.o,$^),-lrtsys)
+
 
 doc/html/index.html: $(HDRS)
 ifeq ($(DOXYGEN),)
@@ -140,6 +205,13 @@ endif
 
 test: test_rttest test_rtsys
 
+bench: $(BENCH_PROGS)
+	@set -eu; \
+	for i in $^; do \
+		echo "BENCH $$i"; \
+		./$$i; \
+	done
+
 test_rttest: rttest_unit_tests
 	@set -eu; \
 	./$< > rttest.rtt; \
@@ -202,7 +274,7 @@ dbg:
 # Automatic header dependencies
 
 OBJS = $(LIBRTSYS_OBJS) $(LIBRTTEST_OBJS) $(RTTEST_MAIN_OBJ) \
-		$(RTTEST_TEST_OBJS) $(RTSYS_TEST_OBJS)
+		$(RTTEST_TEST_OBJS) $(RTSYS_TEST_OBJS) $(BENCH_PROGS:=.o)
 
 -include $(OBJS:.o=.d)
 
@@ -0,0 +1,362 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/** Throughput and latency of regular FIFOs
+ *
+ * `RTSmallFifo` and `RTFifo` are measured across item sizes and capacities, in
+ * two modes:
+ *  - "single": one thread pushes a burst of items then pops them all, over and
+ *    over; each latency sample is the average time of one push or pop over a
+ *    burst, because a single operation is too short to be timed on its own
+ *  - "pingpong": one thread pushes an item into a FIFO, a second thread pops it
+ *    and pushes it back into another FIFO, and the first thread pops it; each
+ *    latency sample is one round trip, and so is an operation. As these
+ *    FIFOs are not thread-safe, every access is protected by a mutex.
+ *
+ * The results are printed as CSV on stdout, one line per measurement, so they
+ * can be compared across releases. The columns are: FIFO type, mode, item size
+ * in bytes, capacity in items, number of operations, elapsed time in seconds,
+ * millions of operations per second, and the 50th, 90th, 99th and 99.9th
+ * percentiles and the maximum of the latency samples, in nanoseconds.
+ */
+
+#define _GNU_SOURCE
+#include "rtfifo.h"
+#include "rtplf.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+
+/** Number of bytes to push per "single" measurement */
+#define BENCH_SINGLE_BYTES (256u * 1024u * 1024u)
+#define BENCH_SINGLE_MIN_OPS 100000u
+#define BENCH_SINGLE_MAX_OPS 4000000u
+#define BENCH_BURST 32u
+#define BENCH_PINGPONG_ROUNDS 20000u
+#define BENCH_PINGPONG_CAPACITY 16u
+#define BENCH_MAX_ITEM_B 4096u
+
+
+typedef struct {
+    RTBool      small;
+    RTSmallFifo smallFifo;
+    RTFifo      fifo;
+    uint16_t    itemSize_B;
+    uint16_t    capacity;
+    RTByte*     buffer;
+} BenchFifo;
+
+typedef struct {
+    BenchFifo       ping;
+    BenchFifo       pong;
+    pthread_mutex_t pingMutex;
+    pthread_mutex_t pongMutex;
+    uint32_t        rounds;
+} BenchPingPong;
+
+static const uint16_t gItemSizes[] = { 1, 8, 64, 255, 256, 1024, 4096 };
+static const uint16_t gCapacities[] = { 16, 255, 256, 4096 };
+static RTByte gItem[BENCH_MAX_ITEM_B];
+static RTByte gEchoItem[BENCH_MAX_ITEM_B];
+
+
+static uint64_t benchNow_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+
+static void benchPin(long cpu)
+{
+    cpu_set_t set;
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpus > 1) {
+        CPU_ZERO(&set);
+        CPU_SET((int)(cpu % ncpus), &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+}
+
+
+static RTBool benchFifoInit(BenchFifo* b, RTBool small, uint16_t itemSize_B,
+        uint16_t capacity)
+{
+    RTBool ok = RTFalse;
+
+    if (!small || ((itemSize_B <= 255u) && (capacity <= 255u))) {
+        b->small = small;
+        b->itemSize_B = itemSize_B;
+        b->capacity = capacity;
+        b->buffer = malloc((size_t)itemSize_B * capacity);
+        RTASSERT(b->buffer != NULL);
+        if (small) {
+            RTSmallFifoInit(&b->smallFifo, (uint8_t)capacity,
+                    (uint8_t)itemSize_B, b->buffer);
+        } else {
+            RTFifoInit(&b->fifo, capacity, itemSize_B, b->buffer);
+        }
+        ok = RTTrue;
+    }
+    return ok;
+}
+
+
+static void benchFifoDestroy(BenchFifo* b)
+{
+    free(b->buffer);
+}
+
+
+static RTBool benchFifoPush(BenchFifo* b, const void* item)
+{
+    RTBool pushed;
+    if (b->small) {
+        pushed = RTSmallFifoPush(&b->smallFifo, item, (uint8_t)b->itemSize_B);
+    } else {
+        pushed = RTFifoPush(&b->fifo, item, b->itemSize_B);
+    }
+    return pushed;
+}
+
+
+static RTBool benchFifoPop(BenchFifo* b, void* item)
+{
+    RTBool popped;
+    if (b->small) {
+        popped = RTSmallFifoPop(&b->smallFifo, item, (uint8_t)b->itemSize_B);
+    } else {
+        popped = RTFifoPop(&b->fifo, item, b->itemSize_B);
+    }
+    return popped;
+}
+
+
+/** Push `n` items then pop them; the type test is out of the inner loops */
+static void benchBurst(BenchFifo* b, uint32_t n)
+{
+    uint32_t i;
+
+    if (b->small) {
+        uint8_t size = (uint8_t)b->itemSize_B;
+        for (i = 0; i < n; i++) {
+            RTSmallFifoPush(&b->smallFifo, gItem, size);
+        }
+        for (i = 0; i < n; i++) {
+            RTSmallFifoPop(&b->smallFifo, gItem, size);
+        }
+    } else {
+        uint16_t size = b->itemSize_B;
+        for (i = 0; i < n; i++) {
+            RTFifoPush(&b->fifo, gItem, size);
+        }
+        for (i = 0; i < n; i++) {
+            RTFifoPop(&b->fifo, gItem, size);
+        }
+    }
+}
+
+
+static int benchCompare(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+
+static uint32_t benchPercentile(const uint32_t* sorted, uint32_t count,
+        uint32_t perMille)
+{
+    return sorted[(uint64_t)(count - 1) * perMille / 1000u];
+}
+
+
+static void benchReport(const BenchFifo* b, const char* mode, uint32_t ops,
+        uint64_t elapsed_ns, uint32_t* samples, uint32_t count)
+{
+    double seconds = (double)elapsed_ns / 1e9;
+
+    qsort(samples, count, sizeof(samples[0]), benchCompare);
+    printf("%s,%s,%u,%u,%u,%.6f,%.3f,%u,%u,%u,%u,%u\n",
+            b->small ? "RTSmallFifo" : "RTFifo", mode,
+            (unsigned)b->itemSize_B, (unsigned)b->capacity, (unsigned)ops,
+            seconds, ((double)ops / seconds) / 1e6,
+            (unsigned)benchPercentile(samples, count, 500),
+            (unsigned)benchPercentile(samples, count, 900),
+            (unsigned)benchPercentile(samples, count, 990),
+            (unsigned)benchPercentile(samples, count, 999),
+            (unsigned)samples[count - 1]);
+    fflush(stdout);
+}
+
+
+static void benchSingle(RTBool small, uint16_t itemSize_B, uint16_t capacity)
+{
+    BenchFifo b;
+    uint32_t burst = capacity < BENCH_BURST ? capacity : BENCH_BURST;
+    uint32_t ops = BENCH_SINGLE_BYTES / itemSize_B;
+    uint32_t rounds;
+    uint32_t* samples;
+    uint64_t start;
+    uint64_t t0;
+    uint64_t t1;
+    uint32_t i;
+
+    if (benchFifoInit(&b, small, itemSize_B, capacity)) {
+        if (ops < BENCH_SINGLE_MIN_OPS) {
+            ops = BENCH_SINGLE_MIN_OPS;
+        } else if (ops > BENCH_SINGLE_MAX_OPS) {
+            ops = BENCH_SINGLE_MAX_OPS;
+        }
+        rounds = ops / (2u * burst);
+        samples = malloc(rounds * sizeof(samples[0]));
+        RTASSERT(samples != NULL);
+
+        benchBurst(&b, burst); /* Warm up */
+        start = benchNow_ns();
+        t0 = start;
+        for (i = 0; i < rounds; i++) {
+            benchBurst(&b, burst);
+            t1 = benchNow_ns();
+            samples[i] = (uint32_t)((t1 - t0) / (2u * burst));
+            t0 = t1;
+        }
+        benchReport(&b, "single", rounds * 2u * burst, t0 - start, samples,
+                rounds);
+        free(samples);
+        benchFifoDestroy(&b);
+    }
+}
+
+
+static RTBool benchLockedPush(BenchFifo* b, pthread_mutex_t* mutex,
+        const void* item)
+{
+    RTBool pushed;
+    pthread_mutex_lock(mutex);
+    pushed = benchFifoPush(b, item);
+    pthread_mutex_unlock(mutex);
+    return pushed;
+}
+
+
+static RTBool benchLockedPop(BenchFifo* b, pthread_mutex_t* mutex,
+        void* item)
+{
+    RTBool popped;
+    pthread_mutex_lock(mutex);
+    popped = benchFifoPop(b, item);
+    pthread_mutex_unlock(mutex);
+    return popped;
+}
+
+
+static void* benchEcho(void* arg)
+{
+    BenchPingPong* pp = arg;
+    uint32_t i;
+
+    benchPin(1);
+    for (i = 0; i < pp->rounds; i++) {
+        while (!benchLockedPop(&pp->ping, &pp->pingMutex, gEchoItem)) {
+            sched_yield();
+        }
+        while (!benchLockedPush(&pp->pong, &pp->pongMutex, gEchoItem)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+
+static void benchPingPong(RTBool small, uint16_t itemSize_B)
+{
+    BenchPingPong pp;
+    pthread_t echo;
+    uint32_t* samples;
+    uint64_t start;
+    uint64_t t0;
+    uint64_t t1;
+    uint32_t i;
+
+    if (benchFifoInit(&pp.ping, small, itemSize_B, BENCH_PINGPONG_CAPACITY)) {
+        RTASSERT(benchFifoInit(&pp.pong, small, itemSize_B,
+                    BENCH_PINGPONG_CAPACITY));
+        pthread_mutex_init(&pp.pingMutex, NULL);
+        pthread_mutex_init(&pp.pongMutex, NULL);
+        pp.rounds = BENCH_PINGPONG_ROUNDS;
+        samples = malloc(pp.rounds * sizeof(samples[0]));
+        RTASSERT(samples != NULL);
+
+        benchPin(0);
+        RTASSERT(pthread_create(&echo, NULL, benchEcho, &pp) == 0);
+        start = benchNow_ns();
+        t0 = start;
+        for (i = 0; i < pp.rounds; i++) {
+            while (!benchLockedPush(&pp.ping, &pp.pingMutex, gItem)) {
+                sched_yield();
+            }
+            while (!benchLockedPop(&pp.pong, &pp.pongMutex, gItem)) {
+                sched_yield();
+            }
+            t1 = benchNow_ns();
+            samples[i] = (uint32_t)(t1 - t0);
+            t0 = t1;
+        }
+        pthread_join(echo, NULL);
+        benchReport(&pp.ping, "pingpong", pp.rounds, t0 - start, samples,
+                pp.rounds);
+
+        free(samples);
+        pthread_mutex_destroy(&pp.pingMutex);
+        pthread_mutex_destroy(&pp.pongMutex);
+        benchFifoDestroy(&pp.ping);
+        benchFifoDestroy(&pp.pong);
+    }
+}
+
+
+int main(void)
+{
+    unsigned s;
+    unsigned c;
+    int small;
+
+    memset(gItem, 0x5A, sizeof(gItem));
+    printf("fifo,mode,item_B,capacity,ops,seconds,mops_per_s,"
+            "p50_ns,p90_ns,p99_ns,p999_ns,max_ns\n");
+    for (small = 1; small >= 0; small--) {
+        for (s = 0; s < RTARRAYSIZE(gItemSizes); s++) {
+            for (c = 0; c < RTARRAYSIZE(gCapacities); c++) {
+                benchSingle((RTBool)small, gItemSizes[s], gCapacities[c]);
+            }
+        }
+    }
+    for (small = 1; small >= 0; small--) {
+        for (s = 0; s < RTARRAYSIZE(gItemSizes); s++) {
+            benchPingPong((RTBool)small, gItemSizes[s]);
+        }
+    }
+    return 0;
+}
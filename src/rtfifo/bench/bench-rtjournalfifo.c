@@ -0,0 +1,94 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Throughput of a journal FIFO depending on how many items a commit covers
+ *
+ * Items are pushed and committed in batches, then popped and committed in
+ * batches. The journal file is created in the current directory, so the
+ * results depend on the storage device it is on.
+ */
+
+#include "rtjournalfifo.h"
+#include "rtplf.h"
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+
+#define BENCH_PATH "bench-rtjournalfifo.jnl"
+#define BENCH_ITEMS 20000u
+#define BENCH_CAPACITY 4096u
+
+
+typedef struct {
+    uint32_t seq;
+    uint32_t payload[15];
+} BenchItem;
+
+
+static double benchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+
+static void benchRun(RTJournalFifo* fifo, uint32_t batch)
+{
+    BenchItem item;
+    uint32_t done = 0;
+    uint32_t i;
+    double start;
+    double elapsed;
+
+    item.payload[0] = 0;
+    start = benchNow();
+    while (done < BENCH_ITEMS) {
+        for (i = 0; i < batch; i++) {
+            item.seq = done + i;
+            RTASSERT(RTJournalFifoPush(fifo, &item, sizeof(item)));
+        }
+        RTASSERT(RTJournalFifoCommit(fifo));
+        for (i = 0; i < batch; i++) {
+            RTASSERT(RTJournalFifoPop(fifo, &item, sizeof(item)));
+        }
+        RTASSERT(RTJournalFifoCommit(fifo));
+        done += batch;
+    }
+    elapsed = benchNow() - start;
+
+    printf("batch=%-5u items=%u commits=%u seconds=%.3f kitems/s=%.1f\n",
+            batch, done, 2u * (done / batch), elapsed,
+            ((double)done / elapsed) / 1e3);
+}
+
+
+int main(void)
+{
+    RTJournalFifo fifo;
+    uint32_t batch;
+
+    (void)unlink(BENCH_PATH);
+    RTASSERT(RTJournalFifoOpen(&fifo, BENCH_PATH, BENCH_CAPACITY,
+                sizeof(BenchItem)));
+    for (batch = 1; batch <= BENCH_CAPACITY; batch *= 4) {
+        benchRun(&fifo, batch);
+    }
+    RTJournalFifoClose(&fifo);
+    (void)unlink(BENCH_PATH);
+    return 0;
+}
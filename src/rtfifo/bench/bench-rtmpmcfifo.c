@@ -0,0 +1,157 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Contention benchmark of an MPMC FIFO vs a mutex-protected regular FIFO
+ *
+ * Each thread repeatedly pushes an item and pops an item, so every thread is
+ * both a producer and a consumer. Thread `i` is pinned to CPU `i` (modulo the
+ * number of CPUs).
+ */
+
+#define _GNU_SOURCE
+#include "rtmpmcfifo.h"
+#include "rtfifo.h"
+#include "rtplf.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+
+#define BENCH_OPS_PER_THREAD 500000u
+#define BENCH_CAPACITY 1024u
+#define BENCH_MAX_THREADS 16
+
+
+typedef struct {
+    uint32_t seq;
+    uint32_t payload[3];
+} BenchItem;
+
+static BenchItem gMpmcBuffer[BENCH_CAPACITY];
+static uint32_t gMpmcSeqs[BENCH_CAPACITY];
+static RTMpmcFifo gMpmcFifo = RT_MPMC_FIFO_INIT(gMpmcBuffer, gMpmcSeqs);
+
+static BenchItem gBuffer[BENCH_CAPACITY];
+static RTFifo gFifo = RT_FIFO_INIT(gBuffer);
+static pthread_mutex_t gMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+static double benchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+
+static void benchPin(long cpu)
+{
+    cpu_set_t set;
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpus > 1) {
+        CPU_ZERO(&set);
+        CPU_SET((int)(cpu % ncpus), &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+}
+
+
+static void* benchMpmcThread(void* arg)
+{
+    BenchItem item;
+    uint32_t i;
+
+    benchPin((long)arg);
+    item.payload[0] = item.payload[1] = item.payload[2] = 0;
+    for (i = 0; i < BENCH_OPS_PER_THREAD; i++) {
+        item.seq = i;
+        while (!RTMpmcFifoPush(&gMpmcFifo, &item, sizeof(item))) {
+            sched_yield();
+        }
+        while (!RTMpmcFifoPop(&gMpmcFifo, &item, sizeof(item))) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+
+static void* benchMutexThread(void* arg)
+{
+    BenchItem item;
+    uint32_t i;
+    RTBool ok;
+
+    benchPin((long)arg);
+    item.payload[0] = item.payload[1] = item.payload[2] = 0;
+    for (i = 0; i < BENCH_OPS_PER_THREAD; i++) {
+        item.seq = i;
+        do {
+            pthread_mutex_lock(&gMutex);
+            ok = RTFifoPush(&gFifo, &item, sizeof(item));
+            pthread_mutex_unlock(&gMutex);
+            if (!ok) {
+                sched_yield();
+            }
+        } while (!ok);
+        do {
+            pthread_mutex_lock(&gMutex);
+            ok = RTFifoPop(&gFifo, &item, sizeof(item));
+            pthread_mutex_unlock(&gMutex);
+            if (!ok) {
+                sched_yield();
+            }
+        } while (!ok);
+    }
+    return NULL;
+}
+
+
+static void benchRun(const char* name, void* (*thread)(void*), long nthreads)
+{
+    pthread_t threads[BENCH_MAX_THREADS];
+    double start;
+    double elapsed;
+    double ops;
+    long i;
+
+    start = benchNow();
+    for (i = 0; i < nthreads; i++) {
+        RTASSERT(pthread_create(&threads[i], NULL, thread, (void*)i) == 0);
+    }
+    for (i = 0; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    elapsed = benchNow() - start;
+
+    ops = 2.0 * (double)BENCH_OPS_PER_THREAD * (double)nthreads;
+    printf("%-12s threads=%-2ld ops=%.0f seconds=%.3f Mops/s=%.2f\n", name,
+            nthreads, ops, elapsed, (ops / elapsed) / 1e6);
+}
+
+
+int main(void)
+{
+    long nthreads;
+
+    for (nthreads = 1; nthreads <= BENCH_MAX_THREADS; nthreads *= 2) {
+        benchRun("mpmc", benchMpmcThread, nthreads);
+        benchRun("fifo+mutex", benchMutexThread, nthreads);
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Single-threaded throughput of a power-of-two FIFO vs a regular FIFO
+ *
+ * Both FIFOs have the same geometry. The FIFO is kept half full while items
+ * are pushed and popped, so the indices keep wrapping around.
+ */
+
+#define _GNU_SOURCE
+#include "rtpow2fifo.h"
+#include "rtfifo.h"
+#include "rtplf.h"
+#include <stdio.h>
+#include <time.h>
+
+
+#define BENCH_ITEMS 50000000u
+#define BENCH_CAPACITY 1024u
+
+
+typedef struct {
+    uint32_t seq;
+    uint32_t payload[3];
+} BenchItem;
+
+static BenchItem gPow2Buffer[BENCH_CAPACITY];
+static RTPow2Fifo gPow2Fifo = RT_POW2_FIFO_INIT(gPow2Buffer);
+
+static BenchItem gBuffer[BENCH_CAPACITY];
+static RTFifo gFifo = RT_FIFO_INIT(gBuffer);
+
+
+static double benchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+
+static void benchReport(const char* name, double elapsed)
+{
+    printf("%-12s items=%u seconds=%.3f ns/item=%.2f\n", name, BENCH_ITEMS,
+            elapsed, (elapsed * 1e9) / (double)BENCH_ITEMS);
+}
+
+
+static void benchPow2(void)
+{
+    BenchItem item;
+    uint32_t i;
+    double start;
+
+    item.payload[0] = item.payload[1] = item.payload[2] = 0;
+    for (i = 0; i < (BENCH_CAPACITY / 2u); i++) {
+        item.seq = i;
+        RTASSERT(RTPow2FifoPush(&gPow2Fifo, &item, sizeof(item)));
+    }
+    start = benchNow();
+    for (i = 0; i < BENCH_ITEMS; i++) {
+        RTPow2FifoPush(&gPow2Fifo, &item, sizeof(item));
+        RTPow2FifoPop(&gPow2Fifo, &item, sizeof(item));
+    }
+    benchReport("pow2fifo", benchNow() - start);
+}
+
+
+static void benchFifo(void)
+{
+    BenchItem item;
+    uint32_t i;
+    double start;
+
+    item.payload[0] = item.payload[1] = item.payload[2] = 0;
+    for (i = 0; i < (BENCH_CAPACITY / 2u); i++) {
+        item.seq = i;
+        RTASSERT(RTFifoPush(&gFifo, &item, sizeof(item)));
+    }
+    start = benchNow();
+    for (i = 0; i < BENCH_ITEMS; i++) {
+        RTFifoPush(&gFifo, &item, sizeof(item));
+        RTFifoPop(&gFifo, &item, sizeof(item));
+    }
+    benchReport("fifo", benchNow() - start);
+}
+
+
+int main(void)
+{
+    benchPow2();
+    benchFifo();
+    return 0;
+}
@@ -0,0 +1,176 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Ingestion benchmark of a sharded queue vs a single MPSC FIFO
+ *
+ * Producer `i` is pinned to CPU `i + 1` (modulo the number of CPUs) and pushes
+ * as fast as it can; one consumer pinned to CPU 0 pops in batches. With a
+ * sharded queue, there is one shard per CPU and each producer binds to the
+ * shard of its CPU once, so producers don't contend on the head ticket of a
+ * single FIFO.
+ */
+
+#define _GNU_SOURCE
+#include "rtshardedqueue.h"
+#include "rtmpscfifo.h"
+#include "rtplf.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+
+#define BENCH_ITEMS_PER_PRODUCER 500000u
+#define BENCH_CAPACITY 1024u
+#define BENCH_MAX_PRODUCERS 16
+#define BENCH_SHARDS 16
+#define BENCH_BATCH 32u
+
+
+typedef struct {
+    uint32_t seq;
+    uint32_t payload[3];
+} BenchItem;
+
+static BenchItem gBuffers[BENCH_SHARDS][BENCH_CAPACITY];
+static uint32_t gSeqs[BENCH_SHARDS][BENCH_CAPACITY];
+static RTMpscFifo gShards[BENCH_SHARDS];
+static RTShardedQueue gQueue;
+static uint16_t gShardCount;
+
+
+static double benchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+
+static void benchPin(long cpu)
+{
+    cpu_set_t set;
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpus > 1) {
+        CPU_ZERO(&set);
+        CPU_SET((int)(cpu % ncpus), &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+}
+
+
+static void* benchSingleProducer(void* arg)
+{
+    BenchItem item;
+    uint32_t i;
+
+    benchPin((long)arg + 1);
+    item.payload[0] = item.payload[1] = item.payload[2] = 0;
+    for (i = 0; i < BENCH_ITEMS_PER_PRODUCER; i++) {
+        item.seq = i;
+        while (!RTMpscFifoPush(&gShards[0], &item, sizeof(item))) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+
+static void* benchShardedProducer(void* arg)
+{
+    BenchItem item;
+    uint16_t shard;
+    uint32_t i;
+
+    benchPin((long)arg + 1);
+    shard = RTShardedQueueBind(&gQueue);
+    item.payload[0] = item.payload[1] = item.payload[2] = 0;
+    for (i = 0; i < BENCH_ITEMS_PER_PRODUCER; i++) {
+        item.seq = i;
+        while (!RTShardedQueuePushTo(&gQueue, shard, &item, sizeof(item))) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+
+static void benchRun(const char* name, void* (*thread)(void*),
+        long nproducers, RTBool sharded)
+{
+    pthread_t threads[BENCH_MAX_PRODUCERS];
+    BenchItem items[BENCH_BATCH];
+    uint32_t total = BENCH_ITEMS_PER_PRODUCER * (uint32_t)nproducers;
+    uint32_t popped = 0;
+    uint32_t n;
+    double start;
+    double elapsed;
+    long i;
+
+    for (i = 0; i < BENCH_SHARDS; i++) {
+        RTMpscFifoInit(&gShards[i], BENCH_CAPACITY, sizeof(BenchItem),
+                (RTByte*)gBuffers[i], gSeqs[i]);
+    }
+    RTShardedQueueInit(&gQueue, gShards, gShardCount);
+    benchPin(0);
+
+    start = benchNow();
+    for (i = 0; i < nproducers; i++) {
+        RTASSERT(pthread_create(&threads[i], NULL, thread, (void*)i) == 0);
+    }
+    while (popped < total) {
+        if (sharded) {
+            n = RTShardedQueuePopN(&gQueue, items, sizeof(items[0]),
+                    BENCH_BATCH, BENCH_BATCH);
+        } else {
+            n = 0;
+            while ((n < BENCH_BATCH)
+                    && RTMpscFifoPop(&gShards[0], &items[n], sizeof(items[0]))) {
+                n++;
+            }
+        }
+        popped += n;
+        if (n == 0) {
+            sched_yield();
+        }
+    }
+    for (i = 0; i < nproducers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    elapsed = benchNow() - start;
+
+    printf("%-8s producers=%-2ld items=%u seconds=%.3f Mitems/s=%.2f\n", name,
+            nproducers, total, elapsed, ((double)total / elapsed) / 1e6);
+}
+
+
+int main(void)
+{
+    long nproducers;
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    gShardCount = BENCH_SHARDS;
+    if ((ncpus > 0) && (ncpus < BENCH_SHARDS)) {
+        gShardCount = (uint16_t)ncpus;
+    }
+    printf("cpus=%ld shards=%u\n", ncpus, (unsigned)gShardCount);
+    for (nproducers = 1; nproducers <= BENCH_MAX_PRODUCERS; nproducers *= 2) {
+        benchRun("single", benchSingleProducer, nproducers, RTFalse);
+        benchRun("sharded", benchShardedProducer, nproducers, RTTrue);
+    }
+    return 0;
+}
@@ -0,0 +1,174 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Cross-core throughput of an SPSC FIFO vs a mutex-protected regular FIFO
+ *
+ * The producer thread is pinned to the first CPU and the consumer thread to
+ * the second one (if there is more than one CPU).
+ */
+
+#define _GNU_SOURCE
+#include "rtspscfifo.h"
+#include "rtfifo.h"
+#include "rtplf.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+
+#define BENCH_ITEMS 5000000u
+#define BENCH_CAPACITY 1024u
+
+
+typedef struct {
+    uint32_t seq;
+    uint32_t payload[3];
+} BenchItem;
+
+static BenchItem gSpscBuffer[BENCH_CAPACITY];
+static RTSpscFifo gSpscFifo = RT_SPSC_FIFO_INIT(gSpscBuffer);
+
+static BenchItem gBuffer[BENCH_CAPACITY];
+static RTFifo gFifo = RT_FIFO_INIT(gBuffer);
+static pthread_mutex_t gMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+static double benchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+
+static void benchPin(long cpu)
+{
+    cpu_set_t set;
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpus > 1) {
+        CPU_ZERO(&set);
+        CPU_SET((int)(cpu % ncpus), &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+}
+
+
+static void* benchSpscProducer(void* arg)
+{
+    BenchItem item;
+    uint32_t i;
+
+    benchPin(0);
+    item.payload[0] = item.payload[1] = item.payload[2] = 0;
+    for (i = 0; i < BENCH_ITEMS; i++) {
+        item.seq = i;
+        while (!RTSpscFifoPush(&gSpscFifo, &item, sizeof(item))) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+
+static void* benchSpscConsumer(void* arg)
+{
+    BenchItem item;
+    uint32_t i;
+
+    benchPin(1);
+    for (i = 0; i < BENCH_ITEMS; i++) {
+        while (!RTSpscFifoPop(&gSpscFifo, &item, sizeof(item))) {
+            sched_yield();
+        }
+        RTASSERT(item.seq == i);
+    }
+    return NULL;
+}
+
+
+static void* benchMutexProducer(void* arg)
+{
+    BenchItem item;
+    uint32_t i;
+
+    benchPin(0);
+    item.payload[0] = item.payload[1] = item.payload[2] = 0;
+    for (i = 0; i < BENCH_ITEMS; i++) {
+        RTBool pushed;
+        item.seq = i;
+        do {
+            pthread_mutex_lock(&gMutex);
+            pushed = RTFifoPush(&gFifo, &item, sizeof(item));
+            pthread_mutex_unlock(&gMutex);
+            if (!pushed) {
+                sched_yield();
+            }
+        } while (!pushed);
+    }
+    return NULL;
+}
+
+
+static void* benchMutexConsumer(void* arg)
+{
+    BenchItem item;
+    uint32_t i;
+
+    benchPin(1);
+    for (i = 0; i < BENCH_ITEMS; i++) {
+        RTBool popped;
+        do {
+            pthread_mutex_lock(&gMutex);
+            popped = RTFifoPop(&gFifo, &item, sizeof(item));
+            pthread_mutex_unlock(&gMutex);
+            if (!popped) {
+                sched_yield();
+            }
+        } while (!popped);
+        RTASSERT(item.seq == i);
+    }
+    return NULL;
+}
+
+
+static void benchRun(const char* name,
+        void* (*producer)(void*), void* (*consumer)(void*))
+{
+    pthread_t p;
+    pthread_t c;
+    double start;
+    double elapsed;
+
+    start = benchNow();
+    RTASSERT(pthread_create(&c, NULL, consumer, NULL) == 0);
+    RTASSERT(pthread_create(&p, NULL, producer, NULL) == 0);
+    pthread_join(p, NULL);
+    pthread_join(c, NULL);
+    elapsed = benchNow() - start;
+
+    printf("%-12s items=%u seconds=%.3f Mitems/s=%.2f\n", name,
+            BENCH_ITEMS, elapsed, ((double)BENCH_ITEMS / elapsed) / 1e6);
+}
+
+
+int main(void)
+{
+    benchRun("spsc", benchSpscProducer, benchSpscConsumer);
+    benchRun("fifo+mutex", benchMutexProducer, benchMutexConsumer);
+    return 0;
+}
@@ -0,0 +1,182 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/** Scaling of a fork-join workload over work-stealing deques
+ *
+ * Each worker thread owns a deque. The workload is a binary tree of tasks: a
+ * task either spawns two sub-tasks into the deque of the worker running it, or
+ * is a leaf which does a bit of computation. The root task is given to the
+ * first worker, so the other workers only get tasks by stealing them. Thread
+ * `i` is pinned to CPU `i` (modulo the number of CPUs).
+ */
+
+#define _GNU_SOURCE
+#include "rtstealdeque.h"
+#include "rtplf.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+
+#define BENCH_DEPTH 20u
+#define BENCH_LEAF_WORK 200u
+#define BENCH_CAPACITY 1024u
+#define BENCH_MAX_THREADS 16
+
+
+typedef struct {
+    uint32_t depth;
+} BenchTask;
+
+static BenchTask gBuffers[BENCH_MAX_THREADS][BENCH_CAPACITY];
+static RTStealDeque gDeques[BENCH_MAX_THREADS];
+static long gThreadCount;
+static uint32_t gLeavesDone;
+static uint32_t gSteals;
+
+
+static double benchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+
+static void benchPin(long cpu)
+{
+    cpu_set_t set;
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpus > 1) {
+        CPU_ZERO(&set);
+        CPU_SET((int)(cpu % ncpus), &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+}
+
+
+static void benchExecute(RTStealDeque* own, BenchTask task)
+{
+    volatile uint32_t x = task.depth;
+    uint32_t i;
+
+    if (task.depth == 0) {
+        for (i = 0; i < BENCH_LEAF_WORK; i++) {
+            x = (x * 1103515245u) + 12345u;
+        }
+        RTATOMIC_FETCH_ADD(&gLeavesDone, 1u);
+    } else {
+        BenchTask child;
+        child.depth = task.depth - 1u;
+        for (i = 0; i < 2; i++) {
+            if (!RTStealDequePush(own, &child, sizeof(child))) {
+                benchExecute(own, child);
+            }
+        }
+    }
+}
+
+
+static RTBool benchSteal(long self, uint32_t* seed, BenchTask* task)
+{
+    RTBool stolen = RTFalse;
+    long start;
+    long i;
+
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+    start = (long)(*seed % (uint32_t)gThreadCount);
+    for (i = 0; (i < gThreadCount) && !stolen; i++) {
+        long victim = (start + i) % gThreadCount;
+        if (victim != self) {
+            stolen = RTStealDequeSteal(&gDeques[victim], task, sizeof(*task));
+        }
+    }
+    return stolen;
+}
+
+
+static void* benchWorker(void* arg)
+{
+    long self = (long)arg;
+    uint32_t leaves = 1u << BENCH_DEPTH;
+    uint32_t seed = 2463534242u + (uint32_t)self;
+    uint32_t steals = 0;
+    BenchTask task;
+
+    benchPin(self);
+    while (RTATOMIC_LOAD_ACQUIRE(&gLeavesDone) < leaves) {
+        if (RTStealDequePop(&gDeques[self], &task, sizeof(task))) {
+            benchExecute(&gDeques[self], task);
+        } else if (benchSteal(self, &seed, &task)) {
+            steals++;
+            benchExecute(&gDeques[self], task);
+        } else {
+            sched_yield();
+        }
+    }
+    RTATOMIC_FETCH_ADD(&gSteals, steals);
+    return NULL;
+}
+
+
+static void benchRun(long nthreads)
+{
+    pthread_t threads[BENCH_MAX_THREADS];
+    BenchTask root;
+    double start;
+    double elapsed;
+    double tasks;
+    long i;
+
+    gThreadCount = nthreads;
+    gLeavesDone = 0;
+    gSteals = 0;
+    for (i = 0; i < nthreads; i++) {
+        RTStealDequeInit(&gDeques[i], BENCH_CAPACITY, sizeof(BenchTask),
+                (RTByte*)gBuffers[i]);
+    }
+    root.depth = BENCH_DEPTH;
+    RTASSERT(RTStealDequePush(&gDeques[0], &root, sizeof(root)));
+
+    start = benchNow();
+    for (i = 0; i < nthreads; i++) {
+        RTASSERT(pthread_create(&threads[i], NULL, benchWorker, (void*)i) == 0);
+    }
+    for (i = 0; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    elapsed = benchNow() - start;
+
+    tasks = (double)((2u << BENCH_DEPTH) - 1u);
+    printf("threads=%-2ld tasks=%.0f steals=%u seconds=%.3f Mtasks/s=%.2f\n",
+            nthreads, tasks, gSteals, elapsed, (tasks / elapsed) / 1e6);
+}
+
+
+int main(void)
+{
+    long nthreads;
+
+    for (nthreads = 1; nthreads <= BENCH_MAX_THREADS; nthreads *= 2) {
+        benchRun(nthreads);
+    }
+    return 0;
+}
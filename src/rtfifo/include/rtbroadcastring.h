@@ -0,0 +1,253 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/** Single-producer broadcast rings
+ *
+ * @defgroup rtbroadcastring Broadcast rings
+ * @addtogroup rtbroadcastring
+ * @{
+ *
+ * A broadcast ring is written by exactly one producer and read by a fixed
+ * number of consumers, all running concurrently and without any lock. Every
+ * consumer sees every item: an item is written once into the ring, and each
+ * consumer reads it in place. This replaces pushing the same item into one
+ * FIFO per consumer.
+ *
+ * Each consumer has its own cursor, which is the sequence number of the next
+ * item it will read. The producer can only overwrite an item once all the
+ * consumers have read it, so it is gated by the slowest consumer. A consumer
+ * can read in one go all the items published so far, and moves its cursor
+ * only once for the whole batch.
+ *
+ * The capacity of a broadcast ring must be a power of two.
+ */
+
+#ifndef RTBROADCASTRING_h_
+#define RTBROADCASTRING_h_
+
+#include "rtplf.h"
+#include "rtbroadcastring_priv.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** "Opaque" type that represents the cursor of one consumer
+ *
+ * *Important note*: Never access the structure directly!
+ */
+typedef struct RTBroadcastCursor RTBroadcastCursor;
+
+
+/** "Opaque" type that represents a broadcast ring
+ *
+ * This ring can take up to 32,768 items, and the capacity must be a power of
+ * two. Items must be of the same size, which can be up to 65,535 bytes. There
+ * can be up to 255 consumers.
+ *
+ * *Important note*: Never access the structure directly! Always use the
+ * broadcast ring functions.
+ */
+typedef struct RTBroadcastRing RTBroadcastRing;
+
+
+/** Macro initialiser for a statically-allocated broadcast ring
+ *
+ * This macro can be used to initialise a broadcast ring when the underlying
+ * buffer and the cursors have been previously *statically* declared as
+ * arrays. There is one consumer per element of `_cursors`, and `_cursors` must
+ * be zero-initialised. Compilation will fail if the number of elements of
+ * `_buffer` is not a power of two.
+ *
+ * The ring will then take ownership of the `_buffer` and `_cursors` arrays,
+ * which should then not be accessed by anything else.
+ *
+ * For example:
+ *   typedef struct { ... } MyEvent;
+ *   static MyEvent gMyBuffer[64];
+ *   static RTBroadcastCursor gMyCursors[3];
+ *   static RTBroadcastRing gMyRing
+ *       = RT_BROADCAST_RING_INIT(gMyBuffer, gMyCursors);
+ */
+#define RT_BROADCAST_RING_INIT(_buffer, _cursors) \
+    RTPRIV_BROADCAST_RING_INIT(_buffer, _cursors)
+
+
+/** Function called by `RTBroadcastRingRead()` for each item
+ *
+ * @param ctx  [in] Context, as passed to `RTBroadcastRingRead()`
+ * @param item [in] The item, in the ring buffer; it is only valid until this
+ *                  function returns
+ */
+typedef void (*RTBroadcastRingHandler)(void* ctx, const void* item);
+
+
+
+/*------------------------------+
+ | Public function declarations |
+ +------------------------------*/
+
+
+/** Dynamically initialise a broadcast ring
+ *
+ * **DO NOT** call this function on a ring that has been already initialised
+ * with `RT_BROADCAST_RING_INIT()`, nor while the ring is in use.
+ *
+ * @param ring          [in,out] Ring structure to initialise; must not be
+ *                               NULL.
+ * @param capacity      [in]     Ring capacity, in number of items; must be a
+ *                               power of two <= 32,768.
+ * @param itemSize_B    [in]     Size of a single item, in bytes; must be > 0.
+ * @param buffer        [in]     Where the items should be stored. `buffer`
+ *                               must not be NULL and must point to a memory
+ *                               area at least `capacity` * `itemSize_B` in
+ *                               size (in bytes).
+ * @param cursors       [out]    Array of `consumerCount` cursors; must not be
+ *                               NULL. This function initialises it.
+ * @param consumerCount [in]     Number of consumers; must be > 0.
+ *
+ * @return Nothing
+ */
+void RTBroadcastRingInit(RTBroadcastRing* ring, uint16_t capacity,
+        uint16_t itemSize_B, RTByte* buffer, RTBroadcastCursor* cursors,
+        uint8_t consumerCount);
+
+
+/** Get the capacity of a broadcast ring
+ *
+ * @param ring [in] Ring to query; must not be NULL.
+ *
+ * @return The maximum number of items the ring can hold
+ */
+uint16_t RTBroadcastRingCapacity(const RTBroadcastRing* ring);
+
+
+/** Get the number of consumers of a broadcast ring
+ *
+ * @param ring [in] Ring to query; must not be NULL.
+ *
+ * @return The number of consumers
+ */
+uint8_t RTBroadcastRingConsumerCount(const RTBroadcastRing* ring);
+
+
+/** Publish an item to all the consumers
+ *
+ * Must only be called by the producer.
+ *
+ * @param ring       [in,out] Ring where to publish the item; must not be NULL.
+ * @param item       [in]     The item to publish; must not be NULL. The item
+ *                            itself will be copied, so you retain the ownership
+ *                            of the `item`.
+ * @param itemSize_B [in]     The size of the `item`, in bytes. `itemSize_B`
+ *                            must be > 0 and <= the size of ring items (as set
+ *                            when the ring is initialised).
+ *
+ * @return `RTTrue` if success, `RTFalse` if the slowest consumer has not read
+ *         the oldest item yet
+ */
+RTBool RTBroadcastRingPublish(RTBroadcastRing* ring, const void* item,
+        uint16_t itemSize_B);
+
+
+/** Get a free slot, to be filled in and then published
+ *
+ * This function, along with `RTBroadcastRingCommit()`, allows the producer to
+ * build an item directly in the ring buffer instead of copying it there.
+ * Calling this function again without committing returns the same slot.
+ *
+ * Must only be called by the producer.
+ *
+ * @param ring [in,out] Ring where to publish an item; must not be NULL.
+ *
+ * @return A pointer to the free slot, or NULL if the slowest consumer has not
+ *         read the oldest item yet
+ */
+void* RTBroadcastRingClaim(RTBroadcastRing* ring);
+
+
+/** Publish the slot previously returned by `RTBroadcastRingClaim()`
+ *
+ * You must have called `RTBroadcastRingClaim()` and it must not have returned
+ * NULL.
+ *
+ * @param ring [in,out] Ring where to publish the slot; must not be NULL.
+ *
+ * @return Nothing
+ */
+void RTBroadcastRingCommit(RTBroadcastRing* ring);
+
+
+/** Get the number of items a consumer has not read yet
+ *
+ * Must only be called by the consumer itself. The returned value may be out of
+ * date if the producer is publishing items concurrently.
+ *
+ * @param ring     [in] Ring to query; must not be NULL.
+ * @param consumer [in] Index of the consumer; must be < the number of
+ *                      consumers.
+ *
+ * @return The number of items published that `consumer` has not read yet
+ */
+uint32_t RTBroadcastRingAvailable(const RTBroadcastRing* ring,
+        uint8_t consumer);
+
+
+/** Read the next item, as a consumer
+ *
+ * Must only be called by the consumer itself.
+ *
+ * @param ring       [in,out] Ring to read from; must not be NULL.
+ * @param consumer   [in]     Index of the consumer; must be < the number of
+ *                            consumers.
+ * @param item       [out]    Where to write the item; must not be NULL.
+ * @param itemSize_B [in]     Size of the `item` buffer, in bytes. `itemSize_B`
+ *                            must be >= the size of ring items.
+ *
+ * @return `RTTrue` if success, `RTFalse` if `consumer` has read all the items
+ *         published so far
+ */
+RTBool RTBroadcastRingPop(RTBroadcastRing* ring, uint8_t consumer,
+        void* item, uint16_t itemSize_B);
+
+
+/** Read all the items published so far, as a consumer
+ *
+ * Items are passed to `handler` in place, without copy, oldest first. The
+ * cursor of the consumer is moved once, after the last item has been handled.
+ * Must only be called by the consumer itself.
+ *
+ * @param ring     [in,out] Ring to read from; must not be NULL.
+ * @param consumer [in]     Index of the consumer; must be < the number of
+ *                          consumers.
+ * @param handler  [in]     Function to call for each item; must not be NULL.
+ *                          It must not access the ring.
+ * @param ctx      [in]     Passed as is to `handler`
+ * @param maxItems [in]     Maximum number of items to read
+ *
+ * @return The number of items read
+ */
+uint32_t RTBroadcastRingRead(RTBroadcastRing* ring, uint8_t consumer,
+        RTBroadcastRingHandler handler, void* ctx, uint32_t maxItems);
+
+
+
+#endif /* RTBROADCASTRING_h_ */
+/* @} */
@@ -0,0 +1,84 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/* You should not include this file directly; include "rtbroadcastring.h"
+ * instead. */
+
+#ifndef RTBROADCASTRING_PRIV_h_
+#define RTBROADCASTRING_PRIV_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Cursor of one consumer of a broadcast ring
+ *
+ * Each cursor is on its own cache line, so consumers don't slow each other
+ * down when they move their cursor.
+ */
+struct RTBroadcastCursor {
+    uint32_t next;               /**< Next sequence to read; consumer only */
+    uint32_t publishedCache;     /**< Last `published` seen by the consumer */
+    RTByte   pad[RTCACHELINE_B]; /**< Padding */
+};
+
+
+/** Broadcast ring structure
+ *
+ * Sequences are free-running: item number `s` is stored in slot
+ * `s & (capacity - 1)`, and the distance between two sequences is computed
+ * modulo 2^32, which works because the capacity is a power of two <= 2^15.
+ */
+struct RTBroadcastRing {
+    uint16_t  capacity;            /**< Capacity, in items */
+    uint16_t  itemSize_B;          /**< Size of one item, in bytes */
+    uint8_t   consumerCount;       /**< Number of consumers */
+    RTByte*   buffer;              /**< Where to store the items */
+    struct RTBroadcastCursor* cursors; /**< One cursor per consumer */
+    RTByte    pad0[RTCACHELINE_B]; /**< Padding */
+    uint32_t  published;           /**< Next sequence to publish */
+    uint32_t  gate;                /**< Last slowest cursor seen */
+    RTByte    pad1[RTCACHELINE_B]; /**< Padding */
+};
+
+
+/** Macro initialiser for a statically-allocated broadcast ring */
+#define RTPRIV_BROADCAST_RING_INIT(_buffer, _cursors)                        \
+    {                                                                        \
+        RTARRAYSIZE(_buffer)                                                 \
+            + RTSTATIC_CHECK(RTIS_POW2_15(RTARRAYSIZE(_buffer))),            \
+        sizeof((_buffer)[0]),                                                \
+        RTARRAYSIZE(_cursors)                                                \
+            + RTSTATIC_CHECK(                                                \
+                    (RTARRAYSIZE(_cursors) > 0)                              \
+                    && (RTARRAYSIZE(_cursors) <= 255u)),                     \
+        (RTByte*)(_buffer),                                                  \
+        (_cursors),                                                          \
+        { 0 },                                                               \
+        0,                                                                   \
+        0,                                                                   \
+        { 0 }                                                                \
+    }
+
+
+
+#endif /* RTBROADCASTRING_PRIV_h_ */
@@ -27,6 +27,7 @@
 #define RTFIFO_h_
 
 #include "rtplf.h"
+#include "rtfifostats.h"
 #include "rtfifo_priv.h"
 
 
@@ -94,6 +95,49 @@ typedef struct RTFifo RTFifo;
 #define RT_FIFO_INIT(_buffer) RTPRIV_FIFO_INIT(_buffer)
 
 
+/** Function called by `RTFifoDrain()` and `RTFifoForEach()` for each item
+ *
+ * @param ctx  [in] Context, as passed to `RTFifoDrain()` or `RTFifoForEach()`
+ * @param item [in] The item, in the FIFO buffer; it is only valid until this
+ *                  function returns
+ */
+typedef void (*RTFifoHandler)(void* ctx, const void* item);
+
+
+/** Declare a typed FIFO
+ *
+ * This macro declares a FIFO type named `_name` which holds up to `_capacity`
+ * items of type `_type`, along with the functions to use it. Both the item
+ * type and the capacity are known at compile-time, so items are copied by
+ * plain assignment and the functions can be inlined; this is faster than a
+ * regular FIFO, especially for small items.
+ *
+ * The following functions are declared, which behave like their `RTFifo`
+ * counterparts:
+ *   void     <_name>Init(<_name>* fifo);
+ *   uint16_t <_name>Size(const <_name>* fifo);
+ *   uint16_t <_name>Capacity(const <_name>* fifo);
+ *   RTBool   <_name>IsEmpty(const <_name>* fifo);
+ *   RTBool   <_name>IsFull(const <_name>* fifo);
+ *   RTBool   <_name>Push(<_name>* fifo, const <_type>* item);
+ *   RTBool   <_name>Pop(<_name>* fifo, <_type>* item);
+ *
+ * `_capacity` must be a constant between 1 and 65,535. The items are stored
+ * inside the FIFO structure itself. A zero-initialised FIFO is empty, so a FIFO
+ * with static storage does not need to be initialised. Please note there is no
+ * semicolon after this macro.
+ *
+ * For example:
+ *   typedef struct { ... } MyEvent;
+ *   RT_TYPED_FIFO(MyEventFifo, MyEvent, 32)
+ *   static MyEventFifo gMyFifo;
+ *   ...
+ *   MyEventFifoPush(&gMyFifo, &event);
+ */
+#define RT_TYPED_FIFO(_name, _type, _capacity) \
+    RTPRIV_TYPED_FIFO(_name, _type, _capacity)
+
+
 
 /*------------------------------+
  | Public function declarations |
@@ -189,6 +233,103 @@ RTBool RTSmallFifoPush(RTSmallFifo* fifo, const void* item, uint8_t itemSize_B);
 RTBool RTSmallFifoPop(RTSmallFifo* fifo, void* item, uint8_t itemSize_B);
 
 
+/** Push an item into a small FIFO, dropping the oldest item if it is full
+ *
+ * If the FIFO is full, its oldest item is removed to make room for `item`, and
+ * the drop counter of the FIFO is incremented (see `RTSmallFifoDropCount()`). This
+ * keeps the most recent items, at constant cost.
+ *
+ * @param fifo       [in,out] FIFO where to push the item; must not be NULL.
+ * @param item       [in]     The item to push; must not be NULL. The item
+ *                            itself will be copied, so you retain the ownership
+ *                            of the `item`.
+ * @param itemSize_B [in]     The size of the `item`, in bytes. `itemSize_B`
+ *                            must be > 0 and <= the size of FIFO items (as set
+ *                            when the FIFO is initialised).
+ *
+ * @return `RTTrue` if an item has been dropped, `RTFalse` if not
+ */
+RTBool RTSmallFifoPushOverwrite(RTSmallFifo* fifo, const void* item,
+        uint8_t itemSize_B);
+
+
+/** Get the number of items dropped by `RTSmallFifoPushOverwrite()`
+ *
+ * The counter saturates at its maximum value.
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The number of items dropped since the FIFO has been initialised or
+ *         the counter reset
+ */
+uint16_t RTSmallFifoDropCount(const RTSmallFifo* fifo);
+
+
+/** Reset the counter of dropped items to 0
+ *
+ * @param fifo [in,out] FIFO to modify; must not be NULL.
+ *
+ * @return Nothing
+ */
+void RTSmallFifoResetDropCount(RTSmallFifo* fifo);
+
+
+#if RTFIFO_STATS
+/** Read the counters of a small FIFO, and optionally reset them
+ *
+ * This function is only available if `RTFIFO_STATS` is set to 1. Reading and
+ * resetting is done in one call, so no event can be missed in between. After a
+ * reset, the high watermark is set to the current size of the FIFO and all the
+ * other counters are set to 0.
+ *
+ * @param fifo  [in,out] FIFO to query; must not be NULL.
+ * @param stats [out]    Where to write the counters; must not be NULL.
+ * @param reset [in]     Whether to reset the counters after reading them
+ *
+ * @return Nothing
+ */
+void RTSmallFifoReadStats(RTSmallFifo* fifo, RTFifoStats* stats, RTBool reset);
+#endif
+
+
+/** Push several items into a small FIFO
+ *
+ * As many items as possible are pushed, up to `count`. The items are copied
+ * with at most two copies, one up to the end of the FIFO buffer and one from
+ * its start.
+ *
+ * @param fifo  [in,out] FIFO where to push the items; must not be NULL.
+ * @param items [in]     Array of `count` items to push; must not be NULL. Each
+ *                       item must be exactly the size of the FIFO items (as
+ *                       set when the FIFO is initialised). The items will be
+ *                       copied, so you retain the ownership of `items`.
+ * @param count [in]     Number of items in `items`
+ *
+ * @return The number of items actually pushed, which is less than `count` if
+ *         the FIFO becomes full
+ */
+uint8_t RTSmallFifoPushN(RTSmallFifo* fifo, const void* items, uint8_t count);
+
+
+/** Pop several items from a small FIFO
+ *
+ * As many items as possible are popped, up to `count`. The items are copied
+ * with at most two copies, one up to the end of the FIFO buffer and one from
+ * its start.
+ *
+ * @param fifo  [in,out] FIFO from where to pop the items; must not be NULL.
+ * @param items [out]    Where to write the popped items; must not be NULL and
+ *                       must be large enough to hold `count` items of the size
+ *                       of the FIFO items (as set when the FIFO is
+ *                       initialised).
+ * @param count [in]     Maximum number of items to pop
+ *
+ * @return The number of items actually popped, which is less than `count` if
+ *         the FIFO becomes empty
+ */
+uint8_t RTSmallFifoPopN(RTSmallFifo* fifo, void* items, uint8_t count);
+
+
 
 /** Dynamically initialise a regular FIFO
  *
@@ -215,6 +356,29 @@ void RTFifoInit(RTFifo* fifo, uint16_t capacity,
         uint16_t itemSize_B, RTByte* buffer);
 
 
+/** Attach a notifier to a regular FIFO
+ *
+ * The notifier is raised whenever the FIFO goes from empty to non-empty, ie:
+ * once per burst of pushes rather than once per item. The consumer should
+ * lower the notifier with `RTNotifierClear()` *before* popping items until the
+ * FIFO is empty; otherwise, an item pushed after the last pop but before the
+ * notifier is lowered would go unnoticed.
+ *
+ * This is typically used to watch a FIFO from an epoll loop, using the file
+ * descriptor given by `RTNotifierFd()`. Please note that the FIFO is still not
+ * thread-safe; if it is shared between threads, they must serialise their
+ * access to it.
+ *
+ * @param fifo     [in,out] FIFO to modify; must not be NULL.
+ * @param notifier [in]     Notifier to raise, or NULL to detach the current
+ *                          one. You retain the ownership of the notifier,
+ *                          which must remain valid while it is attached.
+ *
+ * @return Nothing
+ */
+void RTFifoSetNotifier(RTFifo* fifo, RTNotifier* notifier);
+
+
 /** Get the size of a regular FIFO
  *
  * @param fifo [in] FIFO to query; must not be NULL.
@@ -279,6 +443,190 @@ RTBool RTFifoPush(RTFifo* fifo, const void* item, uint16_t itemSize_B);
 RTBool RTFifoPop(RTFifo* fifo, void* item, uint16_t itemSize_B);
 
 
+/** Push an item into a regular FIFO, dropping the oldest item if it is full
+ *
+ * If the FIFO is full, its oldest item is removed to make room for `item`, and
+ * the drop counter of the FIFO is incremented (see `RTFifoDropCount()`). This
+ * keeps the most recent items, at constant cost.
+ *
+ * @param fifo       [in,out] FIFO where to push the item; must not be NULL.
+ * @param item       [in]     The item to push; must not be NULL. The item
+ *                            itself will be copied, so you retain the ownership
+ *                            of the `item`.
+ * @param itemSize_B [in]     The size of the `item`, in bytes. `itemSize_B`
+ *                            must be > 0 and <= the size of FIFO items (as set
+ *                            when the FIFO is initialised).
+ *
+ * @return `RTTrue` if an item has been dropped, `RTFalse` if not
+ */
+RTBool RTFifoPushOverwrite(RTFifo* fifo, const void* item, uint16_t itemSize_B);
+
+
+/** Get the number of items dropped by `RTFifoPushOverwrite()`
+ *
+ * The counter saturates at its maximum value.
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The number of items dropped since the FIFO has been initialised or
+ *         the counter reset
+ */
+uint32_t RTFifoDropCount(const RTFifo* fifo);
+
+
+/** Reset the counter of dropped items to 0
+ *
+ * @param fifo [in,out] FIFO to modify; must not be NULL.
+ *
+ * @return Nothing
+ */
+void RTFifoResetDropCount(RTFifo* fifo);
+
+
+#if RTFIFO_STATS
+/** Read the counters of a regular FIFO, and optionally reset them
+ *
+ * This function is only available if `RTFIFO_STATS` is set to 1. Reading and
+ * resetting is done in one call, so no event can be missed in between. After a
+ * reset, the high watermark is set to the current size of the FIFO and all the
+ * other counters are set to 0.
+ *
+ * @param fifo  [in,out] FIFO to query; must not be NULL.
+ * @param stats [out]    Where to write the counters; must not be NULL.
+ * @param reset [in]     Whether to reset the counters after reading them
+ *
+ * @return Nothing
+ */
+void RTFifoReadStats(RTFifo* fifo, RTFifoStats* stats, RTBool reset);
+#endif
+
+
+/** Push several items into a regular FIFO
+ *
+ * As many items as possible are pushed, up to `count`. The items are copied
+ * with at most two copies, one up to the end of the FIFO buffer and one from
+ * its start.
+ *
+ * @param fifo  [in,out] FIFO where to push the items; must not be NULL.
+ * @param items [in]     Array of `count` items to push; must not be NULL. Each
+ *                       item must be exactly the size of the FIFO items (as
+ *                       set when the FIFO is initialised). The items will be
+ *                       copied, so you retain the ownership of `items`.
+ * @param count [in]     Number of items in `items`
+ *
+ * @return The number of items actually pushed, which is less than `count` if
+ *         the FIFO becomes full
+ */
+uint16_t RTFifoPushN(RTFifo* fifo, const void* items, uint16_t count);
+
+
+/** Pop several items from a regular FIFO
+ *
+ * As many items as possible are popped, up to `count`. The items are copied
+ * with at most two copies, one up to the end of the FIFO buffer and one from
+ * its start.
+ *
+ * @param fifo  [in,out] FIFO from where to pop the items; must not be NULL.
+ * @param items [out]    Where to write the popped items; must not be NULL and
+ *                       must be large enough to hold `count` items of the size
+ *                       of the FIFO items (as set when the FIFO is
+ *                       initialised).
+ * @param count [in]     Maximum number of items to pop
+ *
+ * @return The number of items actually popped, which is less than `count` if
+ *         the FIFO becomes empty
+ */
+uint16_t RTFifoPopN(RTFifo* fifo, void* items, uint16_t count);
+
+
+/** Reserve the next free slot of a regular FIFO
+ *
+ * This function, along with `RTFifoCommit()`, allows you to write an item
+ * directly into the FIFO buffer instead of copying it there from somewhere
+ * else. Fill in the slot returned by this function, then call
+ * `RTFifoCommit()` to actually push it.
+ *
+ * The FIFO is not modified by this function; calling it again before
+ * `RTFifoCommit()` returns the same slot.
+ *
+ * @param fifo [in] FIFO where to reserve a slot; must not be NULL.
+ *
+ * @return A pointer to a slot of the size of the FIFO items, or NULL if the
+ *         FIFO is full
+ */
+void* RTFifoReserve(RTFifo* fifo);
+
+
+/** Push the slot previously returned by `RTFifoReserve()`
+ *
+ * You must have called `RTFifoReserve()` and it must not have returned NULL.
+ *
+ * @param fifo [in,out] FIFO where to push the reserved slot; must not be NULL.
+ *
+ * @return Nothing
+ */
+void RTFifoCommit(RTFifo* fifo);
+
+
+/** Get a pointer to the oldest item of a regular FIFO
+ *
+ * This function, along with `RTFifoRelease()`, allows you to process an item
+ * directly from the FIFO buffer instead of copying it somewhere else first.
+ * Once you are done with the item, call `RTFifoRelease()` to actually pop it.
+ *
+ * The FIFO is not modified by this function.
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return A pointer to the oldest item, or NULL if the FIFO is empty. The
+ *         pointer remains valid until `RTFifoRelease()` is called.
+ */
+const void* RTFifoPeek(const RTFifo* fifo);
+
+
+/** Pop the item previously returned by `RTFifoPeek()`
+ *
+ * The FIFO must not be empty.
+ *
+ * @param fifo [in,out] FIFO from where to pop the item; must not be NULL.
+ *
+ * @return Nothing
+ */
+void RTFifoRelease(RTFifo* fifo);
+
+
+/** Pass items to a handler and pop them
+ *
+ * Items are passed in place, without copy, oldest first. The items are popped
+ * all at once after the last one has been handled.
+ *
+ * @param fifo     [in,out] FIFO to drain; must not be NULL.
+ * @param handler  [in]     Function to call for each item; must not be NULL.
+ *                          It must not access the FIFO.
+ * @param ctx      [in]     Passed as is to `handler`
+ * @param maxItems [in]     Maximum number of items to drain
+ *
+ * @return The number of items drained
+ */
+uint16_t RTFifoDrain(RTFifo* fifo, RTFifoHandler handler, void* ctx,
+        uint16_t maxItems);
+
+
+/** Pass all the items to a handler, without popping them
+ *
+ * Items are passed in place, without copy, oldest first. The FIFO is not
+ * modified by this function.
+ *
+ * @param fifo    [in] FIFO to inspect; must not be NULL.
+ * @param handler [in] Function to call for each item; must not be NULL. It
+ *                     must not modify the FIFO.
+ * @param ctx     [in] Passed as is to `handler`
+ *
+ * @return The number of items in the FIFO
+ */
+uint16_t RTFifoForEach(const RTFifo* fifo, RTFifoHandler handler, void* ctx);
+
+
 
 #endif /* RTFIFO_h_ */
 /* @} */
@@ -20,6 +20,7 @@
 #define RTFIFO_PRIV_h_
 
 #include "rtplf.h"
+#include "rtfifostats.h"
 
 
 
@@ -28,14 +29,26 @@
  +----------------*/
 
 
+/** Initialiser for the `stats` field, including the leading comma, if any */
+#if RTFIFO_STATS
+#define RTPRIV_FIFO_STATS_INIT , { 0, 0, 0, 0, 0, { 0 } }
+#else
+#define RTPRIV_FIFO_STATS_INIT
+#endif
+
+
 /** Small FIFO structure */
 struct RTSmallFifo {
-    uint8_t head;       /**< Head of the FIFO */
-    uint8_t tail;       /**< Tail of the FIFO */
-    uint8_t size;       /**< Size of the FIFO, in items */
-    uint8_t capacity;   /**< Capacity of the FIFO, in items */
-    uint8_t itemSize_B; /**< Size of one item, in bytes */
-    RTByte* buffer;     /**< Where to store the items */
+    uint8_t  head;       /**< Head of the FIFO */
+    uint8_t  tail;       /**< Tail of the FIFO */
+    uint8_t  size;       /**< Size of the FIFO, in items */
+    uint8_t  capacity;   /**< Capacity of the FIFO, in items */
+    uint8_t  itemSize_B; /**< Size of one item, in bytes */
+    uint16_t drops;      /**< Number of items dropped by overwriting pushes */
+    RTByte*  buffer;     /**< Where to store the items */
+#if RTFIFO_STATS
+    RTFifoStats stats;   /**< Usage counters */
+#endif
 };
 
 
@@ -47,18 +60,25 @@ struct RTSmallFifo {
         0,                              \
         RTARRAYSIZE(_buffer),           \
         sizeof((_buffer)[0]),           \
+        0,                              \
         (RTByte*)(_buffer)              \
+        RTPRIV_FIFO_STATS_INIT          \
     }
 
 
 /** Regular FIFO structure */
 struct RTFifo {
-    uint16_t head;       /**< Head of the FIFO */
-    uint16_t tail;       /**< Tail of the FIFO */
-    uint16_t size;       /**< Size of the FIFO, in items */
-    uint16_t capacity;   /**< Capacity of the FIFO, in items */
-    uint16_t itemSize_B; /**< Size of one item, in bytes */
-    RTByte*  buffer;     /**< Where to store the items */
+    uint16_t    head;       /**< Head of the FIFO */
+    uint16_t    tail;       /**< Tail of the FIFO */
+    uint16_t    size;       /**< Size of the FIFO, in items */
+    uint16_t    capacity;   /**< Capacity of the FIFO, in items */
+    uint16_t    itemSize_B; /**< Size of one item, in bytes */
+    uint32_t    drops;      /**< Number of items dropped by overwriting pushes */
+    RTByte*     buffer;     /**< Where to store the items */
+    RTNotifier* notifier;   /**< Raised when the FIFO becomes non-empty */
+#if RTFIFO_STATS
+    RTFifoStats stats;      /**< Usage counters */
+#endif
 };
 
 
@@ -70,7 +90,86 @@ struct RTFifo {
         0,                          \
         RTARRAYSIZE(_buffer),       \
         sizeof((_buffer)[0]),       \
-        (RTByte*)(_buffer)          \
+        0,                          \
+        (RTByte*)(_buffer),         \
+        NULL                        \
+        RTPRIV_FIFO_STATS_INIT      \
+    }
+
+
+/** Declare a typed FIFO and its functions */
+#define RTPRIV_TYPED_FIFO(_name, _type, _capacity)                          \
+    typedef struct {                                                        \
+        uint16_t head;                                                      \
+        uint16_t tail;                                                      \
+        uint16_t size;                                                      \
+        _type    items[_capacity];                                          \
+    } _name;                                                                \
+                                                                            \
+    RTINLINE void _name##Init(_name* fifo)                                  \
+    {                                                                       \
+        RTASSERT(fifo != NULL);                                             \
+        fifo->head = 0;                                                     \
+        fifo->tail = 0;                                                     \
+        fifo->size = 0;                                                     \
+    }                                                                       \
+                                                                            \
+    RTINLINE uint16_t _name##Size(const _name* fifo)                        \
+    {                                                                       \
+        RTASSERT(fifo != NULL);                                             \
+        return fifo->size;                                                  \
+    }                                                                       \
+                                                                            \
+    RTINLINE uint16_t _name##Capacity(const _name* fifo)                    \
+    {                                                                       \
+        RTASSERT(fifo != NULL);                                             \
+        return (uint16_t)(_capacity);                                       \
+    }                                                                       \
+                                                                            \
+    RTINLINE RTBool _name##IsEmpty(const _name* fifo)                       \
+    {                                                                       \
+        RTASSERT(fifo != NULL);                                             \
+        return fifo->size == 0;                                             \
+    }                                                                       \
+                                                                            \
+    RTINLINE RTBool _name##IsFull(const _name* fifo)                        \
+    {                                                                       \
+        RTASSERT(fifo != NULL);                                             \
+        return fifo->size >= (_capacity);                                   \
+    }                                                                       \
+                                                                            \
+    RTINLINE RTBool _name##Push(_name* fifo, const _type* item)             \
+    {                                                                       \
+        RTBool pushed = RTFalse;                                            \
+        RTASSERT(fifo != NULL);                                             \
+        RTASSERT(item != NULL);                                             \
+        if (fifo->size < (_capacity)) {                                     \
+            fifo->items[fifo->head] = *item;                                \
+            fifo->head++;                                                   \
+            if (fifo->head >= (_capacity)) {                                \
+                fifo->head = 0;                                             \
+            }                                                               \
+            fifo->size++;                                                   \
+            pushed = RTTrue;                                                \
+        }                                                                   \
+        return pushed;                                                      \
+    }                                                                       \
+                                                                            \
+    RTINLINE RTBool _name##Pop(_name* fifo, _type* item)                    \
+    {                                                                       \
+        RTBool popped = RTFalse;                                            \
+        RTASSERT(fifo != NULL);                                             \
+        RTASSERT(item != NULL);                                             \
+        if (fifo->size > 0) {                                               \
+            *item = fifo->items[fifo->tail];                                \
+            fifo->tail++;                                                   \
+            if (fifo->tail >= (_capacity)) {                                \
+                fifo->tail = 0;                                             \
+            }                                                               \
+            fifo->size--;                                                   \
+            popped = RTTrue;                                                \
+        }                                                                   \
+        return popped;                                                      \
     }
 
 
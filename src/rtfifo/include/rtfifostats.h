@@ -0,0 +1,88 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/** Instrumentation of regular FIFOs
+ *
+ * @defgroup rtfifostats FIFO statistics
+ * @addtogroup rtfifostats
+ * @{
+ *
+ * When `RTFIFO_STATS` is set to 1, every `RTSmallFifo` and `RTFifo` maintains a
+ * set of counters that tell how the FIFO has been used, and in particular how
+ * close it came to overflowing between two samples. They can be read and reset
+ * in one go with `RTSmallFifoReadStats()` and `RTFifoReadStats()`.
+ *
+ * When `RTFIFO_STATS` is set to 0 (the default), the FIFO structures and
+ * functions are exactly the same as if this feature did not exist, and the
+ * functions to read the counters are not available.
+ *
+ * `RTFIFO_STATS` must have the same value when compiling the library and when
+ * compiling the code that uses it. It is set by the `FIFO_STATS` parameter of
+ * the top-level Makefile.
+ */
+
+#ifndef RTFIFOSTATS_h_
+#define RTFIFOSTATS_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Set to 1 to instrument regular FIFOs */
+#ifndef RTFIFO_STATS
+#define RTFIFO_STATS 0
+#endif
+
+
+/** Number of bins of the occupancy histogram */
+#define RTFIFO_STATS_BINS 8
+
+
+/** FIFO counters
+ *
+ * All the counters wrap around when they overflow, except `highWatermark`
+ * which can not exceed the capacity of the FIFO.
+ *
+ * Bin `i` of the occupancy histogram counts the successful push operations
+ * after which the FIFO was filled to more than `i / RTFIFO_STATS_BINS` and up
+ * to `(i + 1) / RTFIFO_STATS_BINS` of its capacity. So the last bin counts the
+ * pushes that filled up the FIFO completely (or nearly so, for large FIFOs).
+ *
+ * Bulk operations (e.g. `RTFifoPushN()`) are counted item by item for `pushes`
+ * and `pops`, but as a single operation for the other counters.
+ *
+ * `RTFifoPeek()` does not modify the FIFO, so it is not counted, even when it
+ * finds the FIFO empty; a failed `RTFifoReserve()` counts as a failed push.
+ */
+typedef struct {
+    uint32_t pushes;        /**< Number of items pushed */
+    uint32_t pops;          /**< Number of items popped */
+    uint32_t pushFailures;  /**< Number of pushes that failed (FIFO full) */
+    uint32_t popFailures;   /**< Number of pops that failed (FIFO empty) */
+    uint16_t highWatermark; /**< Highest number of items held at once */
+    uint32_t histogram[RTFIFO_STATS_BINS]; /**< Occupancy after each push */
+} RTFifoStats;
+
+
+
+#endif /* RTFIFOSTATS_h_ */
+/* @} */
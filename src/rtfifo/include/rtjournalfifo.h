@@ -0,0 +1,197 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Crash-durable journal FIFOs
+ *
+ * @defgroup rtjournalfifo Journal FIFOs
+ * @addtogroup rtjournalfifo
+ * @{
+ *
+ * A journal FIFO keeps its items, and the positions of its head and tail, in a
+ * memory-mapped file. Pushes and pops work on memory, like those of a regular
+ * FIFO. They only become durable when `RTJournalFifoCommit()` is called: the
+ * items pushed since the previous commit are written to the storage device,
+ * and then the head and tail are. The cost of durability is thus paid once per
+ * batch of items, not once per item.
+ *
+ * When a journal FIFO is re-opened, for example after a crash, it resumes from
+ * the head and tail of the last commit: items pushed after that commit are
+ * lost, and items popped after that commit are popped again. A consumer should
+ * thus commit once it has processed a batch of items.
+ *
+ * Because popped items may have to be popped again, their slots are only
+ * reused for new items once their pops have been committed.
+ *
+ * Like regular FIFOs, journal FIFOs are not thread-safe.
+ */
+
+#ifndef RTJOURNALFIFO_h_
+#define RTJOURNALFIFO_h_
+
+#include "rtplf.h"
+#include "rtjournalfifo_priv.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** "Opaque" type that represents a journal FIFO
+ *
+ * Items must be of the same size, which can be up to 65,535 bytes.
+ *
+ * *Important note*: Never access the structure directly! Always use the FIFO
+ * functions.
+ */
+typedef struct RTJournalFifo RTJournalFifo;
+
+
+
+/*------------------------------+
+ | Public function declarations |
+ +------------------------------*/
+
+
+/** Open a journal FIFO, creating it if necessary
+ *
+ * If the file at `path` does not exist or is empty, an empty journal FIFO is
+ * created in it. Otherwise, the journal FIFO it holds is opened as of its last
+ * commit; its capacity and item size must be those given here. A file that
+ * does not hold such a journal FIFO is left untouched.
+ *
+ * If the system crashes while a journal FIFO is being created, its file is
+ * left without a valid journal, and it must be deleted before trying again.
+ *
+ * @param fifo       [out] Journal FIFO to initialise; must not be NULL.
+ * @param path       [in]  Path to the journal file; must not be NULL.
+ * @param capacity   [in]  FIFO capacity, in number of items; must be > 0 and
+ *                         <= 2^30.
+ * @param itemSize_B [in]  Size of a single item in the FIFO, in bytes; must be
+ *                         > 0.
+ *
+ * @return `RTTrue` if success, `RTFalse` if the file can't be opened, or if it
+ *         holds something else than a journal FIFO with this capacity and item
+ *         size
+ */
+RTBool RTJournalFifoOpen(RTJournalFifo* fifo, const char* path,
+        uint32_t capacity, uint16_t itemSize_B);
+
+
+/** Close a journal FIFO
+ *
+ * This function does not commit: pushes and pops made since the last commit
+ * will be forgotten when the FIFO is re-opened.
+ *
+ * @param fifo [in,out] Journal FIFO to close; must not be NULL.
+ *
+ * @return Nothing
+ */
+void RTJournalFifoClose(RTJournalFifo* fifo);
+
+
+/** Get the number of items in a journal FIFO
+ *
+ * @param fifo [in] Journal FIFO to query; must not be NULL.
+ *
+ * @return The number of items that can be popped
+ */
+uint32_t RTJournalFifoSize(const RTJournalFifo* fifo);
+
+
+/** Get the capacity of a journal FIFO
+ *
+ * @param fifo [in] Journal FIFO to query; must not be NULL.
+ *
+ * @return The maximum number of items the FIFO can hold
+ */
+uint32_t RTJournalFifoCapacity(const RTJournalFifo* fifo);
+
+
+/** Test if a journal FIFO is empty
+ *
+ * @param fifo [in] Journal FIFO to query; must not be NULL.
+ *
+ * @return `RTTrue` if there is no item to pop, `RTFalse` if there is
+ */
+RTBool RTJournalFifoIsEmpty(const RTJournalFifo* fifo);
+
+
+/** Test if a journal FIFO is full
+ *
+ * The slots of popped items count as used until their pops are committed.
+ *
+ * @param fifo [in] Journal FIFO to query; must not be NULL.
+ *
+ * @return `RTTrue` if no item can be pushed, `RTFalse` otherwise
+ */
+RTBool RTJournalFifoIsFull(const RTJournalFifo* fifo);
+
+
+/** Push an item into a journal FIFO
+ *
+ * The item is written to the journal file, but it is only durable once
+ * `RTJournalFifoCommit()` has been called.
+ *
+ * @param fifo       [in,out] Journal FIFO where to push the item; must not be
+ *                            NULL.
+ * @param item       [in]     The item to push; must not be NULL. The item
+ *                            itself will be copied, so you retain the ownership
+ *                            of the `item`.
+ * @param itemSize_B [in]     The size of the `item`, in bytes. `itemSize_B`
+ *                            must be > 0 and <= the size of FIFO items.
+ *
+ * @return `RTTrue` if success, `RTFalse` if the FIFO is full
+ */
+RTBool RTJournalFifoPush(RTJournalFifo* fifo, const void* item,
+        uint16_t itemSize_B);
+
+
+/** Pop an item from a journal FIFO
+ *
+ * The pop is only durable once `RTJournalFifoCommit()` has been called.
+ *
+ * @param fifo       [in,out] Journal FIFO from where to pop the item; must not
+ *                            be NULL.
+ * @param item       [out]    Where to write the popped item; must not be NULL.
+ * @param itemSize_B [in]     Size of the `item` buffer, in bytes. `itemSize_B`
+ *                            must be >= the size of the FIFO items.
+ *
+ * @return `RTTrue` if success, `RTFalse` if FIFO is empty
+ */
+RTBool RTJournalFifoPop(RTJournalFifo* fifo, void* item, uint16_t itemSize_B);
+
+
+/** Make all the pushes and pops since the last commit durable
+ *
+ * The items pushed since the last commit are written to the storage device
+ * first, and then the head and tail; a crash at any point thus leaves the
+ * journal file as of either this commit or the previous one. This function
+ * blocks until the storage device has the data.
+ *
+ * @param fifo [in,out] Journal FIFO to commit; must not be NULL.
+ *
+ * @return `RTTrue` if success, `RTFalse` if the data could not be written, in
+ *         which case the journal file is still as of the previous commit and
+ *         the commit can be tried again
+ */
+RTBool RTJournalFifoCommit(RTJournalFifo* fifo);
+
+
+
+#endif /* RTJOURNALFIFO_h_ */
+/* @} */
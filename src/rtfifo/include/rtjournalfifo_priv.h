@@ -0,0 +1,87 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* You should not include this file directly; include "rtjournalfifo.h"
+ * instead. */
+
+#ifndef RTJOURNALFIFO_PRIV_h_
+#define RTJOURNALFIFO_PRIV_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Header at the beginning of a journal file
+ *
+ * The header fills the first page of the file, and the items start on the
+ * second page, so syncing the header never syncs items and vice-versa. The
+ * header is only written when creating the journal and when committing.
+ *
+ * Tickets work as in the MPSC FIFO (see rtmpscfifo_priv.h): ticket `t` uses
+ * slot `t % capacity`, and tickets wrap around after `laps` laps.
+ */
+struct RTJournalFifoHeader {
+    uint32_t magic;      /**< `RTPRIV_JOURNAL_FIFO_MAGIC` once set up */
+    uint32_t capacity;   /**< Capacity of the FIFO, in items */
+    uint32_t itemSize_B; /**< Size of one item, in bytes */
+    uint32_t head;       /**< Committed push ticket */
+    uint32_t tail;       /**< Committed pop ticket */
+};
+
+
+/** Journal FIFO structure
+ *
+ * This structure lives in the memory of the process; only the header and the
+ * items live in the journal file.
+ */
+struct RTJournalFifo {
+    RTMappedFile                file;          /**< The journal file */
+    struct RTJournalFifoHeader* header;        /**< Header of the file */
+    RTByte*                     buffer;        /**< Items in the file */
+    uint32_t                    capacity;      /**< Capacity, in items */
+    uint16_t                    itemSize_B;    /**< Size of one item */
+    uint32_t                    laps;          /**< Laps before tickets wrap */
+    uint32_t                    head;          /**< Next push ticket */
+    uint32_t                    tail;          /**< Next pop ticket */
+    uint32_t                    committedHead; /**< Head as of last commit */
+    uint32_t                    committedTail; /**< Tail as of last commit */
+};
+
+
+/** Value of the `magic` field of a journal file which is set up */
+#define RTPRIV_JOURNAL_FIFO_MAGIC 0x4E524A52u
+
+
+/** Maximum capacity of a journal FIFO, so tickets go round at least 2 laps */
+#define RTPRIV_JOURNAL_FIFO_MAX_CAPACITY 0x40000000u
+
+
+/** Number of laps before tickets wrap for a given capacity */
+#define RTPRIV_JOURNAL_FIFO_LAPS(_capacity) \
+    (0x80000000u / (uint32_t)(_capacity))
+
+
+/** Offset of the items in a journal file, in bytes */
+#define RTPRIV_JOURNAL_FIFO_BUFFER_OFFSET 4096u
+
+
+
+#endif /* RTJOURNALFIFO_PRIV_h_ */
@@ -0,0 +1,161 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Large FIFOs
+ *
+ * @defgroup rtlargefifo Large FIFOs
+ * @addtogroup rtlargefifo
+ * @{
+ *
+ * A large FIFO behaves exactly like a regular FIFO (`RTFifo`), but its
+ * capacity and item size are `size_t`, so it is only limited by the amount of
+ * memory available.
+ *
+ * Like regular FIFOs, large FIFOs are not thread-safe.
+ */
+
+#ifndef RTLARGEFIFO_h_
+#define RTLARGEFIFO_h_
+
+#include "rtplf.h"
+#include "rtlargefifo_priv.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** "Opaque" type that represents a large FIFO
+ *
+ * `capacity * itemSize_B` must be representable as a `size_t`.
+ *
+ * *Important note*: Never access the structure directly! Always use the FIFO
+ * functions.
+ */
+typedef struct RTLargeFifo RTLargeFifo;
+
+
+/** Macro initialiser for a statically-allocated large FIFO
+ *
+ * This macro can be used to initialise a large FIFO when the underlying buffer
+ * has been previously *statically* declared as an array.
+ *
+ * The FIFO will then take ownership of the `_buffer`, which should then not be
+ * accessed by anything else.
+ *
+ * For example:
+ *   typedef struct { ... } MyStruct;
+ *   static MyStruct gMyBuffer[1000000];
+ *   static RTLargeFifo gMyFifo = RT_LARGE_FIFO_INIT(gMyBuffer);
+ */
+#define RT_LARGE_FIFO_INIT(_buffer) RTPRIV_LARGE_FIFO_INIT(_buffer)
+
+
+
+/*------------------------------+
+ | Public function declarations |
+ +------------------------------*/
+
+
+/** Dynamically initialise a large FIFO
+ *
+ * **DO NOT** call this function on a FIFO that has been already initialised
+ * with `RT_LARGE_FIFO_INIT()`.
+ *
+ * @param fifo       [in,out] FIFO structure to initialise; must not be NULL.
+ * @param capacity   [in]     FIFO capacity, in number of items; must be > 0.
+ * @param itemSize_B [in]     Size of a single item in the FIFO, in bytes; must
+ *                            be > 0.
+ * @param buffer     [in]     Where the FIFO items should be stored. `buffer`
+ *                            must not be NULL and must point to a memory area
+ *                            at least `capacity` * `itemSize_B` in size (in
+ *                            bytes).
+ *
+ * @return Nothing
+ */
+void RTLargeFifoInit(RTLargeFifo* fifo, size_t capacity, size_t itemSize_B,
+        RTByte* buffer);
+
+
+/** Get the size of a large FIFO
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The number of items currently stored in the FIFO
+ */
+size_t RTLargeFifoSize(const RTLargeFifo* fifo);
+
+
+/** Get the capacity of a large FIFO
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The maximum number of items the FIFO can hold
+ */
+size_t RTLargeFifoCapacity(const RTLargeFifo* fifo);
+
+
+/** Test if a large FIFO is empty
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return `RTTrue` if the FIFO is empty, `RTFalse` if not
+ */
+RTBool RTLargeFifoIsEmpty(const RTLargeFifo* fifo);
+
+
+/** Test if a large FIFO is full
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return `RTTrue` if the FIFO is full, `RTFalse` if not
+ */
+RTBool RTLargeFifoIsFull(const RTLargeFifo* fifo);
+
+
+/** Push an item into a large FIFO
+ *
+ * @param fifo       [in,out] FIFO where to push the item; must not be NULL.
+ * @param item       [in]     The item to push; must not be NULL. The item
+ *                            itself will be copied, so you retain the ownership
+ *                            of the `item`.
+ * @param itemSize_B [in]     The size of the `item`, in bytes. `itemSize_B`
+ *                            must be > 0 and <= the size of FIFO items (as set
+ *                            when the FIFO is initialised).
+ *
+ * @return `RTTrue` if success, `RTFalse` if the FIFO is full
+ */
+RTBool RTLargeFifoPush(RTLargeFifo* fifo, const void* item, size_t itemSize_B);
+
+
+/** Pop an item from a large FIFO
+ *
+ * @param fifo       [in,out] FIFO from where to pop the item; must not be NULL.
+ * @param item       [out]    Where to write the popped item; must not be NULL.
+ * @param itemSize_B [in]     Size of the `item` buffer, in bytes. `itemSize_B`
+ *                            must be >= the size of the FIFO items (as set
+ *                            when the FIFO is initialised).
+ *
+ * @return `RTTrue` if success, `RTFalse` if FIFO is empty
+ */
+RTBool RTLargeFifoPop(RTLargeFifo* fifo, void* item, size_t itemSize_B);
+
+
+
+#endif /* RTLARGEFIFO_h_ */
+/* @} */
@@ -0,0 +1,55 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* You should not include this file directly; include "rtlargefifo.h" instead. */
+
+#ifndef RTLARGEFIFO_PRIV_h_
+#define RTLARGEFIFO_PRIV_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Large FIFO structure */
+struct RTLargeFifo {
+    size_t  head;       /**< Head of the FIFO */
+    size_t  tail;       /**< Tail of the FIFO */
+    size_t  size;       /**< Size of the FIFO, in items */
+    size_t  capacity;   /**< Capacity of the FIFO, in items */
+    size_t  itemSize_B; /**< Size of one item, in bytes */
+    RTByte* buffer;     /**< Where to store the items */
+};
+
+
+/** Macro initialiser for a statically-allocated large FIFO */
+#define RTPRIV_LARGE_FIFO_INIT(_buffer) \
+    {                                   \
+        0,                              \
+        0,                              \
+        0,                              \
+        RTARRAYSIZE(_buffer),           \
+        sizeof((_buffer)[0]),           \
+        (RTByte*)(_buffer)              \
+    }
+
+
+
+#endif /* RTLARGEFIFO_PRIV_h_ */
@@ -0,0 +1,176 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Byte FIFOs on mirrored memory
+ *
+ * @defgroup rtmirrorfifo Mirrored byte FIFOs
+ * @addtogroup rtmirrorfifo
+ * @{
+ *
+ * A mirrored byte FIFO is a FIFO of bytes (eg: a stream received from or sent
+ * to a socket) whose buffer is a mirrored memory area (see `RTMirror`). The
+ * data in the FIFO, as well as the free space, is therefore always one
+ * contiguous span, even when it wraps around the end of the buffer. This
+ * allows to parse data in place, or write it out in one go, without having to
+ * deal with the wrap-around.
+ *
+ * Mirrored byte FIFOs are not thread-safe.
+ */
+
+#ifndef RTMIRRORFIFO_h_
+#define RTMIRRORFIFO_h_
+
+#include "rtplf.h"
+#include "rtmirrorfifo_priv.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** "Opaque" type that represents a mirrored byte FIFO
+ *
+ * *Important note*: Never access the structure directly! Always use the FIFO
+ * functions.
+ */
+typedef struct RTMirrorFifo RTMirrorFifo;
+
+
+
+/*------------------------------+
+ | Public function declarations |
+ +------------------------------*/
+
+
+/** Create a mirrored byte FIFO
+ *
+ * The capacity is rounded up to a multiple of the page size.
+ *
+ * @param fifo          [out] FIFO to initialise; must not be NULL.
+ * @param minCapacity_B [in]  Minimum capacity of the FIFO, in bytes; must be
+ *                            > 0.
+ *
+ * @return `RTTrue` if success, `RTFalse` if the system ran out of resources
+ */
+RTBool RTMirrorFifoCreate(RTMirrorFifo* fifo, size_t minCapacity_B);
+
+
+/** Release the memory of a mirrored byte FIFO
+ *
+ * @param fifo [in,out] FIFO to destroy; must not be NULL.
+ *
+ * @return Nothing
+ */
+void RTMirrorFifoDestroy(RTMirrorFifo* fifo);
+
+
+/** Get the number of bytes in a mirrored byte FIFO
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The number of bytes currently stored in the FIFO
+ */
+size_t RTMirrorFifoSize(const RTMirrorFifo* fifo);
+
+
+/** Get the capacity of a mirrored byte FIFO
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The maximum number of bytes the FIFO can hold
+ */
+size_t RTMirrorFifoCapacity(const RTMirrorFifo* fifo);
+
+
+/** Write bytes into a mirrored byte FIFO
+ *
+ * @param fifo   [in,out] FIFO where to write; must not be NULL.
+ * @param data   [in]     Bytes to write; must not be NULL unless `size_B` is 0
+ * @param size_B [in]     Number of bytes to write
+ *
+ * @return The number of bytes actually written, which is less than `size_B`
+ *         if the FIFO becomes full
+ */
+size_t RTMirrorFifoWrite(RTMirrorFifo* fifo, const void* data, size_t size_B);
+
+
+/** Read bytes from a mirrored byte FIFO
+ *
+ * @param fifo   [in,out] FIFO from where to read; must not be NULL.
+ * @param data   [out]    Where to write the bytes read; must not be NULL unless
+ *                        `size_B` is 0
+ * @param size_B [in]     Maximum number of bytes to read
+ *
+ * @return The number of bytes actually read, which is less than `size_B` if
+ *         the FIFO becomes empty
+ */
+size_t RTMirrorFifoRead(RTMirrorFifo* fifo, void* data, size_t size_B);
+
+
+/** Get the free space of a mirrored byte FIFO, as one contiguous span
+ *
+ * Write data directly into the returned span, then call
+ * `RTMirrorFifoCommit()` to add it to the FIFO. The FIFO is not modified by
+ * this function.
+ *
+ * @param fifo   [in]  FIFO to query; must not be NULL.
+ * @param span_B [out] Size of the free space, in bytes; must not be NULL.
+ *
+ * @return A pointer to the free space
+ */
+RTByte* RTMirrorFifoReserve(RTMirrorFifo* fifo, size_t* span_B);
+
+
+/** Add bytes written into the span returned by `RTMirrorFifoReserve()`
+ *
+ * @param fifo   [in,out] FIFO to update; must not be NULL.
+ * @param size_B [in]     Number of bytes written; must be <= the size of the
+ *                        span returned by `RTMirrorFifoReserve()`.
+ *
+ * @return Nothing
+ */
+void RTMirrorFifoCommit(RTMirrorFifo* fifo, size_t size_B);
+
+
+/** Get the data in a mirrored byte FIFO, as one contiguous span
+ *
+ * Process the data in place, then call `RTMirrorFifoRelease()` to remove it
+ * from the FIFO. The FIFO is not modified by this function.
+ *
+ * @param fifo   [in]  FIFO to query; must not be NULL.
+ * @param span_B [out] Number of bytes in the FIFO; must not be NULL.
+ *
+ * @return A pointer to the oldest byte in the FIFO
+ */
+const RTByte* RTMirrorFifoPeek(const RTMirrorFifo* fifo, size_t* span_B);
+
+
+/** Remove bytes from the span returned by `RTMirrorFifoPeek()`
+ *
+ * @param fifo   [in,out] FIFO to update; must not be NULL.
+ * @param size_B [in]     Number of bytes to remove; must be <= the number of
+ *                        bytes in the FIFO.
+ *
+ * @return Nothing
+ */
+void RTMirrorFifoRelease(RTMirrorFifo* fifo, size_t size_B);
+
+
+
+#endif /* RTMIRRORFIFO_h_ */
+/* @} */
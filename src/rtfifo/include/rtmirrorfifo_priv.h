@@ -0,0 +1,45 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* You should not include this file directly; include "rtmirrorfifo.h" instead. */
+
+#ifndef RTMIRRORFIFO_PRIV_h_
+#define RTMIRRORFIFO_PRIV_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Mirrored byte FIFO structure
+ *
+ * `head` and `tail` are free-running byte counters; the data is at offset
+ * `tail % capacity` and is `head - tail` bytes long. Thanks to the mirror,
+ * it never needs to be split.
+ */
+struct RTMirrorFifo {
+    RTMirror mirror; /**< Where the data is stored */
+    size_t   head;   /**< Number of bytes written so far */
+    size_t   tail;   /**< Number of bytes read so far */
+};
+
+
+
+#endif /* RTMIRRORFIFO_PRIV_h_ */
@@ -0,0 +1,229 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Lock-free multi-producer/multi-consumer FIFOs
+ *
+ * @defgroup rtmpmcfifo MPMC FIFOs
+ * @addtogroup rtmpmcfifo
+ * @{
+ *
+ * An MPMC FIFO can be pushed to and popped from by any number of threads
+ * concurrently, without any lock. It works like the MPSC FIFO (see
+ * rtmpscfifo.h), except that consumers also claim their slot by a
+ * compare-and-swap on the tail ticket.
+ *
+ * Producers and consumers only contend on their own ticket, and the copy of an
+ * item in or out of the buffer is done outside of any critical section, so
+ * the FIFO scales with the number of cores much better than a FIFO protected
+ * by a lock.
+ *
+ * Please note that if a thread is pre-empted between claiming its slot and
+ * filling it in (or emptying it), the slot will look busy to other threads
+ * until that thread resumes.
+ *
+ * Threads can block until an item can be pushed or popped, with
+ * `RTMpmcFifoPushWait()` and `RTMpmcFifoPopWait()`. `RTMpmcFifoPush()` and
+ * `RTMpmcFifoPop()` wake up blocked threads if there are any; when there are
+ * none, they don't make any system call.
+ */
+
+#ifndef RTMPMCFIFO_h_
+#define RTMPMCFIFO_h_
+
+#include "rtplf.h"
+#include "rtmpmcfifo_priv.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** "Opaque" type that represents an MPMC FIFO
+ *
+ * This FIFO can take up to 65,535 items. Items must be of the same size, which
+ * can be up to 65,535 bytes.
+ *
+ * *Important note*: Never access the structure directly! Always use the FIFO
+ * functions.
+ */
+typedef struct RTMpmcFifo RTMpmcFifo;
+
+
+/** Macro initialiser for a statically-allocated MPMC FIFO
+ *
+ * This macro can be used to initialise an MPMC FIFO when the underlying buffer
+ * and the array of sequence numbers have been previously *statically* declared
+ * as arrays. `_seqs` must be an array of `uint32_t` with as many elements as
+ * `_buffer` and must be zero-initialised.
+ *
+ * The FIFO will then take ownership of the `_buffer` and `_seqs` arrays, which
+ * should then not be accessed by anything else.
+ *
+ * For example:
+ *   typedef struct { ... } MyStruct;
+ *   static MyStruct gMyBuffer[32];
+ *   static uint32_t gMySeqs[32];
+ *   static RTMpmcFifo gMyFifo = RT_MPMC_FIFO_INIT(gMyBuffer, gMySeqs);
+ */
+#define RT_MPMC_FIFO_INIT(_buffer, _seqs) RTPRIV_MPMC_FIFO_INIT(_buffer, _seqs)
+
+
+
+/*------------------------------+
+ | Public function declarations |
+ +------------------------------*/
+
+
+/** Dynamically initialise an MPMC FIFO
+ *
+ * **DO NOT** call this function on a FIFO that has been already initialised
+ * with `RT_MPMC_FIFO_INIT()`, nor while the FIFO is in use.
+ *
+ * @param fifo       [in,out] FIFO structure to initialise; must not be NULL.
+ * @param capacity   [in]     FIFO capacity, in number of items; must be > 0.
+ * @param itemSize_B [in]     Size of a single item in the FIFO, in bytes; must
+ *                            be > 0.
+ * @param buffer     [in]     Where the FIFO items should be stored. `buffer`
+ *                            must not be NULL and must point to a memory area
+ *                            at least `capacity` * `itemSize_B` in size (in
+ *                            bytes).
+ * @param seqs       [out]    Array of `capacity` sequence numbers; must not be
+ *                            NULL. This function initialises it.
+ *
+ * @return Nothing
+ */
+void RTMpmcFifoInit(RTMpmcFifo* fifo, uint16_t capacity,
+        uint16_t itemSize_B, RTByte* buffer, uint32_t* seqs);
+
+
+/** Get the size of an MPMC FIFO
+ *
+ * Items that are being pushed are included in the count. If other threads are
+ * using the FIFO concurrently, the returned value may already be out of date.
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The number of items currently stored in the FIFO
+ */
+uint16_t RTMpmcFifoSize(const RTMpmcFifo* fifo);
+
+
+/** Get the capacity of an MPMC FIFO
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The maximum number of items the FIFO can hold
+ */
+uint16_t RTMpmcFifoCapacity(const RTMpmcFifo* fifo);
+
+
+/** Test if an MPMC FIFO is empty
+ *
+ * Same remark as for `RTMpmcFifoSize()`.
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return `RTTrue` if the FIFO is empty, `RTFalse` if not
+ */
+RTBool RTMpmcFifoIsEmpty(const RTMpmcFifo* fifo);
+
+
+/** Test if an MPMC FIFO is full
+ *
+ * Same remark as for `RTMpmcFifoSize()`.
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return `RTTrue` if the FIFO is full, `RTFalse` if not
+ */
+RTBool RTMpmcFifoIsFull(const RTMpmcFifo* fifo);
+
+
+/** Push an item into an MPMC FIFO
+ *
+ * This function can be called by several producers concurrently.
+ *
+ * @param fifo       [in,out] FIFO where to push the item; must not be NULL.
+ * @param item       [in]     The item to push; must not be NULL. The item
+ *                            itself will be copied, so you retain the ownership
+ *                            of the `item`.
+ * @param itemSize_B [in]     The size of the `item`, in bytes. `itemSize_B`
+ *                            must be > 0 and <= the size of FIFO items (as set
+ *                            when the FIFO is initialised).
+ *
+ * @return `RTTrue` if success, `RTFalse` if the FIFO is full
+ */
+RTBool RTMpmcFifoPush(RTMpmcFifo* fifo, const void* item, uint16_t itemSize_B);
+
+
+/** Pop an item from an MPMC FIFO
+ *
+ * This function can be called by several consumers concurrently.
+ *
+ * @param fifo       [in,out] FIFO from where to pop the item; must not be NULL.
+ * @param item       [out]    Where to write the popped item; must not be NULL.
+ * @param itemSize_B [in]     Size of the `item` buffer, in bytes. `itemSize_B`
+ *                            must be >= the size of the FIFO items (as set
+ *                            when the FIFO is initialised).
+ *
+ * @return `RTTrue` if success, `RTFalse` if FIFO is empty
+ */
+RTBool RTMpmcFifoPop(RTMpmcFifo* fifo, void* item, uint16_t itemSize_B);
+
+
+/** Push an item into an MPMC FIFO, waiting for room if the FIFO is full
+ *
+ * Same as `RTMpmcFifoPush()`, except that if the FIFO is full, the calling
+ * thread is blocked until an item is popped or the timeout expires.
+ *
+ * @param fifo       [in,out] FIFO where to push the item; must not be NULL.
+ * @param item       [in]     The item to push; must not be NULL.
+ * @param itemSize_B [in]     The size of the `item`, in bytes; same as for
+ *                            `RTMpmcFifoPush()`.
+ * @param timeout_ms [in]     Maximum time to wait, in ms; 0 means don't wait
+ *                            and `RTWAIT_FOREVER` means no timeout. Other
+ *                            values must be less than one hour.
+ *
+ * @return `RTTrue` if success, `RTFalse` if the timeout expired
+ */
+RTBool RTMpmcFifoPushWait(RTMpmcFifo* fifo, const void* item,
+        uint16_t itemSize_B, uint32_t timeout_ms);
+
+
+/** Pop an item from an MPMC FIFO, waiting for one if the FIFO is empty
+ *
+ * Same as `RTMpmcFifoPop()`, except that if the FIFO is empty, the calling
+ * thread is blocked until an item is pushed or the timeout expires.
+ *
+ * @param fifo       [in,out] FIFO from where to pop the item; must not be NULL.
+ * @param item       [out]    Where to write the popped item; must not be NULL.
+ * @param itemSize_B [in]     Size of the `item` buffer, in bytes; same as for
+ *                            `RTMpmcFifoPop()`.
+ * @param timeout_ms [in]     Maximum time to wait, in ms; 0 means don't wait
+ *                            and `RTWAIT_FOREVER` means no timeout. Other
+ *                            values must be less than one hour.
+ *
+ * @return `RTTrue` if success, `RTFalse` if the timeout expired
+ */
+RTBool RTMpmcFifoPopWait(RTMpmcFifo* fifo, void* item, uint16_t itemSize_B,
+        uint32_t timeout_ms);
+
+
+
+#endif /* RTMPMCFIFO_h_ */
+/* @} */
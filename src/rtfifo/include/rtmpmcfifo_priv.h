@@ -0,0 +1,87 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* You should not include this file directly; include "rtmpmcfifo.h" instead. */
+
+#ifndef RTMPMCFIFO_PRIV_h_
+#define RTMPMCFIFO_PRIV_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Multi-producer/multi-consumer FIFO structure
+ *
+ * Each push and each pop is given a ticket, and each slot has a sequence
+ * number that tells whether it is free or holds an item; see rtticket_priv.h
+ * for the details. All sequence numbers start at 0, so a zero-initialised
+ * array is valid.
+ *
+ * A thread blocked in `RTMpmcFifoPopWait()` increments `popWaiters` and waits
+ * for `popEpoch` to change; producers bump `popEpoch` and wake up the waiters
+ * only if `popWaiters` is not 0. Same thing for `RTMpmcFifoPushWait()`.
+ */
+struct RTMpmcFifo {
+    uint16_t  capacity;            /**< Capacity of the FIFO, in items */
+    uint16_t  itemSize_B;          /**< Size of one item, in bytes */
+    uint32_t  laps;                /**< Number of laps before tickets wrap */
+    RTByte*   buffer;              /**< Where to store the items */
+    uint32_t* seqs;                /**< Sequence number of each slot */
+    RTByte    pad0[RTCACHELINE_B]; /**< Padding */
+    uint32_t  head;                /**< Next push ticket; CAS by producers */
+    RTByte    pad1[RTCACHELINE_B]; /**< Padding */
+    uint32_t  tail;                /**< Next pop ticket; CAS by consumers */
+    RTByte    pad2[RTCACHELINE_B]; /**< Padding */
+    uint32_t  popEpoch;            /**< Bumped to wake up blocked consumers */
+    uint32_t  popWaiters;          /**< Number of blocked consumers */
+    uint32_t  pushEpoch;           /**< Bumped to wake up blocked producers */
+    uint32_t  pushWaiters;         /**< Number of blocked producers */
+    RTByte    pad3[RTCACHELINE_B]; /**< Padding */
+};
+
+
+/** Number of laps before tickets wrap for a given capacity */
+#define RTPRIV_MPMC_FIFO_LAPS(_capacity) (0x80000000u / (uint32_t)(_capacity))
+
+
+/** Macro initialiser for a statically-allocated MPMC FIFO */
+#define RTPRIV_MPMC_FIFO_INIT(_buffer, _seqs)             \
+    {                                                     \
+        RTARRAYSIZE(_buffer),                             \
+        sizeof((_buffer)[0]),                             \
+        RTPRIV_MPMC_FIFO_LAPS(RTARRAYSIZE(_buffer)),      \
+        (RTByte*)(_buffer),                               \
+        (_seqs),                                          \
+        { 0 },                                            \
+        0,                                                \
+        { 0 },                                            \
+        0,                                                \
+        { 0 },                                            \
+        0,                                                \
+        0,                                                \
+        0,                                                \
+        0,                                                \
+        { 0 }                                             \
+    }
+
+
+
+#endif /* RTMPMCFIFO_PRIV_h_ */
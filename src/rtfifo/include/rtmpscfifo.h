@@ -0,0 +1,185 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Lock-free multi-producer/single-consumer FIFOs
+ *
+ * @defgroup rtmpscfifo MPSC FIFOs
+ * @addtogroup rtmpscfifo
+ * @{
+ *
+ * An MPSC FIFO can be pushed to by any number of producers concurrently, and
+ * popped from by exactly one consumer, without any lock.
+ *
+ * Each slot of the FIFO has a sequence number that tells whether it is free or
+ * holds an item. Producers claim a slot by a compare-and-swap on the head
+ * ticket, so a producer never waits for another one to finish copying its
+ * item. The consumer never retries: a pop is a single check of the sequence
+ * number of the slot at the tail.
+ *
+ * Please note that if a producer is pre-empted between claiming its slot and
+ * filling it in, the consumer will see the FIFO as empty until that producer
+ * resumes, even if items pushed after it are already available.
+ */
+
+#ifndef RTMPSCFIFO_h_
+#define RTMPSCFIFO_h_
+
+#include "rtplf.h"
+#include "rtmpscfifo_priv.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** "Opaque" type that represents an MPSC FIFO
+ *
+ * This FIFO can take up to 65,535 items. Items must be of the same size, which
+ * can be up to 65,535 bytes.
+ *
+ * *Important note*: Never access the structure directly! Always use the FIFO
+ * functions.
+ */
+typedef struct RTMpscFifo RTMpscFifo;
+
+
+/** Macro initialiser for a statically-allocated MPSC FIFO
+ *
+ * This macro can be used to initialise an MPSC FIFO when the underlying buffer
+ * and the array of sequence numbers have been previously *statically* declared
+ * as arrays. `_seqs` must be an array of `uint32_t` with as many elements as
+ * `_buffer` and must be zero-initialised.
+ *
+ * The FIFO will then take ownership of the `_buffer` and `_seqs` arrays, which
+ * should then not be accessed by anything else.
+ *
+ * For example:
+ *   typedef struct { ... } MyStruct;
+ *   static MyStruct gMyBuffer[32];
+ *   static uint32_t gMySeqs[32];
+ *   static RTMpscFifo gMyFifo = RT_MPSC_FIFO_INIT(gMyBuffer, gMySeqs);
+ */
+#define RT_MPSC_FIFO_INIT(_buffer, _seqs) RTPRIV_MPSC_FIFO_INIT(_buffer, _seqs)
+
+
+
+/*------------------------------+
+ | Public function declarations |
+ +------------------------------*/
+
+
+/** Dynamically initialise an MPSC FIFO
+ *
+ * **DO NOT** call this function on a FIFO that has been already initialised
+ * with `RT_MPSC_FIFO_INIT()`, nor while the FIFO is in use.
+ *
+ * @param fifo       [in,out] FIFO structure to initialise; must not be NULL.
+ * @param capacity   [in]     FIFO capacity, in number of items; must be > 0.
+ * @param itemSize_B [in]     Size of a single item in the FIFO, in bytes; must
+ *                            be > 0.
+ * @param buffer     [in]     Where the FIFO items should be stored. `buffer`
+ *                            must not be NULL and must point to a memory area
+ *                            at least `capacity` * `itemSize_B` in size (in
+ *                            bytes).
+ * @param seqs       [out]    Array of `capacity` sequence numbers; must not be
+ *                            NULL. This function initialises it.
+ *
+ * @return Nothing
+ */
+void RTMpscFifoInit(RTMpscFifo* fifo, uint16_t capacity,
+        uint16_t itemSize_B, RTByte* buffer, uint32_t* seqs);
+
+
+/** Get the size of an MPSC FIFO
+ *
+ * Items that are being pushed are included in the count. If other threads are
+ * using the FIFO concurrently, the returned value may already be out of date.
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The number of items currently stored in the FIFO
+ */
+uint16_t RTMpscFifoSize(const RTMpscFifo* fifo);
+
+
+/** Get the capacity of an MPSC FIFO
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The maximum number of items the FIFO can hold
+ */
+uint16_t RTMpscFifoCapacity(const RTMpscFifo* fifo);
+
+
+/** Test if an MPSC FIFO is empty
+ *
+ * Same remark as for `RTMpscFifoSize()`.
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return `RTTrue` if the FIFO is empty, `RTFalse` if not
+ */
+RTBool RTMpscFifoIsEmpty(const RTMpscFifo* fifo);
+
+
+/** Test if an MPSC FIFO is full
+ *
+ * Same remark as for `RTMpscFifoSize()`.
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return `RTTrue` if the FIFO is full, `RTFalse` if not
+ */
+RTBool RTMpscFifoIsFull(const RTMpscFifo* fifo);
+
+
+/** Push an item into an MPSC FIFO
+ *
+ * This function can be called by several producers concurrently.
+ *
+ * @param fifo       [in,out] FIFO where to push the item; must not be NULL.
+ * @param item       [in]     The item to push; must not be NULL. The item
+ *                            itself will be copied, so you retain the ownership
+ *                            of the `item`.
+ * @param itemSize_B [in]     The size of the `item`, in bytes. `itemSize_B`
+ *                            must be > 0 and <= the size of FIFO items (as set
+ *                            when the FIFO is initialised).
+ *
+ * @return `RTTrue` if success, `RTFalse` if the FIFO is full
+ */
+RTBool RTMpscFifoPush(RTMpscFifo* fifo, const void* item, uint16_t itemSize_B);
+
+
+/** Pop an item from an MPSC FIFO
+ *
+ * Must only be called by the consumer. This function is wait-free.
+ *
+ * @param fifo       [in,out] FIFO from where to pop the item; must not be NULL.
+ * @param item       [out]    Where to write the popped item; must not be NULL.
+ * @param itemSize_B [in]     Size of the `item` buffer, in bytes. `itemSize_B`
+ *                            must be >= the size of the FIFO items (as set
+ *                            when the FIFO is initialised).
+ *
+ * @return `RTTrue` if success, `RTFalse` if FIFO is empty
+ */
+RTBool RTMpscFifoPop(RTMpscFifo* fifo, void* item, uint16_t itemSize_B);
+
+
+
+#endif /* RTMPSCFIFO_h_ */
+/* @} */
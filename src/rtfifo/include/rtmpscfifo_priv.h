@@ -0,0 +1,73 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* You should not include this file directly; include "rtmpscfifo.h" instead. */
+
+#ifndef RTMPSCFIFO_PRIV_h_
+#define RTMPSCFIFO_PRIV_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Multi-producer/single-consumer FIFO structure
+ *
+ * Each push and each pop is given a ticket, and each slot has a sequence
+ * number that tells whether it is free or holds an item; see rtticket_priv.h
+ * for the details. All sequence numbers start at 0, so a zero-initialised
+ * array is valid.
+ */
+struct RTMpscFifo {
+    uint16_t  capacity;            /**< Capacity of the FIFO, in items */
+    uint16_t  itemSize_B;          /**< Size of one item, in bytes */
+    uint32_t  laps;                /**< Number of laps before tickets wrap */
+    RTByte*   buffer;              /**< Where to store the items */
+    uint32_t* seqs;                /**< Sequence number of each slot */
+    RTByte    pad0[RTCACHELINE_B]; /**< Padding */
+    uint32_t  head;                /**< Next push ticket; CAS by producers */
+    RTByte    pad1[RTCACHELINE_B]; /**< Padding */
+    uint32_t  tail;                /**< Next pop ticket; consumer only */
+    RTByte    pad2[RTCACHELINE_B]; /**< Padding */
+};
+
+
+/** Number of laps before tickets wrap for a given capacity */
+#define RTPRIV_MPSC_FIFO_LAPS(_capacity) (0x80000000u / (uint32_t)(_capacity))
+
+
+/** Macro initialiser for a statically-allocated MPSC FIFO */
+#define RTPRIV_MPSC_FIFO_INIT(_buffer, _seqs)             \
+    {                                                     \
+        RTARRAYSIZE(_buffer),                             \
+        sizeof((_buffer)[0]),                             \
+        RTPRIV_MPSC_FIFO_LAPS(RTARRAYSIZE(_buffer)),      \
+        (RTByte*)(_buffer),                               \
+        (_seqs),                                          \
+        { 0 },                                            \
+        0,                                                \
+        { 0 },                                            \
+        0,                                                \
+        { 0 }                                             \
+    }
+
+
+
+#endif /* RTMPSCFIFO_PRIV_h_ */
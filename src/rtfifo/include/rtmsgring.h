@@ -0,0 +1,207 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Variable-length message rings
+ *
+ * @defgroup rtmsgring Message rings
+ * @addtogroup rtmsgring
+ * @{
+ *
+ * A message ring is a FIFO of messages of different sizes. Unlike FIFOs, which
+ * reserve room for the largest item in every slot, a message ring only uses
+ * as much memory as each message needs (plus a 4-byte header and up to 3
+ * bytes of padding).
+ *
+ * Messages are stored contiguously, so they can be accessed in place with
+ * `RTMsgRingPeek()` or `RTMsgRingDrain()`. Messages are 4-byte aligned.
+ *
+ * Message rings are not thread-safe.
+ */
+
+#ifndef RTMSGRING_h_
+#define RTMSGRING_h_
+
+#include "rtplf.h"
+#include "rtmsgring_priv.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** "Opaque" type that represents a message ring
+ *
+ * Messages can be up to 65,535 bytes in size.
+ *
+ * *Important note*: Never access the structure directly! Always use the
+ * message ring functions.
+ */
+typedef struct RTMsgRing RTMsgRing;
+
+
+/** Macro initialiser for a statically-allocated message ring
+ *
+ * This macro can be used to initialise a message ring when the underlying
+ * buffer has been previously *statically* declared as an array of `uint32_t`
+ * (so that it is suitably aligned).
+ *
+ * The message ring will then take ownership of the `_buffer`, which should
+ * then not be accessed by anything else.
+ *
+ * For example:
+ *   static uint32_t gMyBuffer[256];
+ *   static RTMsgRing gMyRing = RT_MSG_RING_INIT(gMyBuffer);
+ */
+#define RT_MSG_RING_INIT(_buffer) RTPRIV_MSG_RING_INIT(_buffer)
+
+
+/** Function called by `RTMsgRingDrain()` for each message
+ *
+ * @param ctx    [in] Context, as passed to `RTMsgRingDrain()`
+ * @param msg    [in] The message; it is only valid until this function returns
+ * @param size_B [in] Size of the message, in bytes
+ */
+typedef void (*RTMsgRingHandler)(void* ctx, const void* msg, uint16_t size_B);
+
+
+
+/*------------------------------+
+ | Public function declarations |
+ +------------------------------*/
+
+
+/** Dynamically initialise a message ring
+ *
+ * **DO NOT** call this function on a message ring that has been already
+ * initialised with `RT_MSG_RING_INIT()`.
+ *
+ * @param ring       [in,out] Message ring to initialise; must not be NULL.
+ * @param buffer     [in]     Where the messages should be stored; must not be
+ *                            NULL and must be 4-byte aligned.
+ * @param capacity_B [in]     Size of `buffer`, in bytes; must be a non-zero
+ *                            multiple of 4.
+ *
+ * @return Nothing
+ */
+void RTMsgRingInit(RTMsgRing* ring, RTByte* buffer, uint32_t capacity_B);
+
+
+/** Get the number of messages in a message ring
+ *
+ * @param ring [in] Message ring to query; must not be NULL.
+ *
+ * @return The number of messages currently stored in the ring
+ */
+uint32_t RTMsgRingCount(const RTMsgRing* ring);
+
+
+/** Test if a message ring is empty
+ *
+ * @param ring [in] Message ring to query; must not be NULL.
+ *
+ * @return `RTTrue` if the message ring is empty, `RTFalse` if not
+ */
+RTBool RTMsgRingIsEmpty(const RTMsgRing* ring);
+
+
+/** Push a message into a message ring
+ *
+ * @param ring   [in,out] Message ring where to push the message; must not be
+ *                        NULL.
+ * @param msg    [in]     The message to push; must not be NULL. The message
+ *                        will be copied, so you retain the ownership of `msg`.
+ * @param size_B [in]     Size of the message, in bytes; must be > 0.
+ *
+ * @return `RTTrue` if success, `RTFalse` if there is not enough room in the
+ *         message ring
+ */
+RTBool RTMsgRingPush(RTMsgRing* ring, const void* msg, uint16_t size_B);
+
+
+/** Get the size of the oldest message in a message ring
+ *
+ * @param ring [in] Message ring to query; must not be NULL.
+ *
+ * @return The size of the oldest message, in bytes, or 0 if the message ring
+ *         is empty
+ */
+uint16_t RTMsgRingNextSize(const RTMsgRing* ring);
+
+
+/** Pop a message from a message ring
+ *
+ * @param ring      [in,out] Message ring from where to pop the message; must
+ *                           not be NULL.
+ * @param msg       [out]    Where to write the popped message; must not be
+ *                           NULL.
+ * @param msgSize_B [in]     Size of the `msg` buffer, in bytes; must be >= the
+ *                           size of the oldest message (use
+ *                           `RTMsgRingNextSize()` if you don't know it).
+ *
+ * @return The size of the popped message, in bytes, or 0 if the message ring
+ *         is empty
+ */
+uint16_t RTMsgRingPop(RTMsgRing* ring, void* msg, uint16_t msgSize_B);
+
+
+/** Get a pointer to the oldest message in a message ring
+ *
+ * The message ring is not modified by this function. Call `RTMsgRingRelease()`
+ * when you are done with the message.
+ *
+ * @param ring   [in]  Message ring to query; must not be NULL.
+ * @param size_B [out] Where to write the size of the message, in bytes; may be
+ *                     NULL.
+ *
+ * @return A pointer to the oldest message, or NULL if the message ring is
+ *         empty. The pointer remains valid until `RTMsgRingRelease()` is called.
+ */
+const void* RTMsgRingPeek(const RTMsgRing* ring, uint16_t* size_B);
+
+
+/** Pop the message previously returned by `RTMsgRingPeek()`
+ *
+ * The message ring must not be empty.
+ *
+ * @param ring [in,out] Message ring from where to pop the message; must not be
+ *                      NULL.
+ *
+ * @return Nothing
+ */
+void RTMsgRingRelease(RTMsgRing* ring);
+
+
+/** Pass messages to a handler and pop them
+ *
+ * Messages are passed in place, without copy, oldest first.
+ *
+ * @param ring    [in,out] Message ring to drain; must not be NULL.
+ * @param handler [in]     Function to call for each message; must not be NULL.
+ *                         It must not access the message ring.
+ * @param ctx     [in]     Passed as is to `handler`
+ * @param maxMsgs [in]     Maximum number of messages to drain
+ *
+ * @return The number of messages drained
+ */
+uint32_t RTMsgRingDrain(RTMsgRing* ring, RTMsgRingHandler handler, void* ctx,
+        uint32_t maxMsgs);
+
+
+
+#endif /* RTMSGRING_h_ */
+/* @} */
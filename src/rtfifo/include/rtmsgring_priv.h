@@ -0,0 +1,74 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* You should not include this file directly; include "rtmsgring.h" instead. */
+
+#ifndef RTMSGRING_PRIV_h_
+#define RTMSGRING_PRIV_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Message ring structure
+ *
+ * Each message is stored as a record made of a 32-bit header, which holds the
+ * size of the message in bytes, followed by the message itself padded to a
+ * multiple of 4 bytes. Records never wrap around the end of the buffer; when a
+ * record does not fit before the end, a wrap marker is written instead of a
+ * header and the record is written at the beginning of the buffer.
+ *
+ * `used_B` counts all the bytes between `tail` and `head`, including padding
+ * and the bytes skipped by a wrap marker; the ring is full when `head == tail`
+ * and `used_B` is not 0.
+ */
+struct RTMsgRing {
+    uint32_t capacity_B; /**< Size of `buffer`, in bytes */
+    uint32_t head;       /**< Offset where to write the next record */
+    uint32_t tail;       /**< Offset of the oldest record */
+    uint32_t used_B;     /**< Number of bytes used */
+    uint32_t count;      /**< Number of messages in the ring */
+    RTByte*  buffer;     /**< Where to store the records */
+};
+
+
+/** Size of a record header, in bytes */
+#define RTPRIV_MSG_RING_HEADER_B 4u
+
+
+/** Header value that marks the end of the records before the buffer wraps */
+#define RTPRIV_MSG_RING_WRAP 0xFFFFFFFFu
+
+
+/** Macro initialiser for a statically-allocated message ring */
+#define RTPRIV_MSG_RING_INIT(_buffer) \
+    {                                 \
+        sizeof(_buffer),              \
+        0,                            \
+        0,                            \
+        0,                            \
+        0,                            \
+        (RTByte*)(_buffer)            \
+    }
+
+
+
+#endif /* RTMSGRING_PRIV_h_ */
@@ -0,0 +1,169 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** FIFOs with power-of-two geometry
+ *
+ * @defgroup rtpow2fifo Power-of-two FIFOs
+ * @addtogroup rtpow2fifo
+ * @{
+ *
+ * A power-of-two FIFO behaves exactly like a regular FIFO (`RTFifo`), but its
+ * capacity and item size must both be powers of two. Wrapping an index around
+ * is then a mask and computing the address of a slot is a shift, instead of a
+ * comparison and a multiplication. The head and tail run freely and the size
+ * of the FIFO is derived from them, so there is one less field to update on
+ * every push and pop.
+ *
+ * Like regular FIFOs, power-of-two FIFOs are not thread-safe.
+ */
+
+#ifndef RTPOW2FIFO_h_
+#define RTPOW2FIFO_h_
+
+#include "rtplf.h"
+#include "rtpow2fifo_priv.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** "Opaque" type that represents a power-of-two FIFO
+ *
+ * This FIFO can take up to 32,768 items. Items must be of the same size, which
+ * can be up to 32,768 bytes. Both the capacity and the item size must be
+ * powers of two.
+ *
+ * *Important note*: Never access the structure directly! Always use the FIFO
+ * functions.
+ */
+typedef struct RTPow2Fifo RTPow2Fifo;
+
+
+/** Macro initialiser for a statically-allocated power-of-two FIFO
+ *
+ * This macro can be used to initialise a power-of-two FIFO when the underlying
+ * buffer has been previously *statically* declared as an array. Compilation
+ * will fail if the number of elements of the array or the size of an element
+ * is not a power of two.
+ *
+ * The FIFO will then take ownership of the `_buffer`, which should then not be
+ * accessed by anything else.
+ *
+ * For example:
+ *   typedef struct { uint32_t a; uint32_t b; } MyStruct;
+ *   static MyStruct gMyBuffer[32];
+ *   static RTPow2Fifo gMyFifo = RT_POW2_FIFO_INIT(gMyBuffer);
+ */
+#define RT_POW2_FIFO_INIT(_buffer) RTPRIV_POW2_FIFO_INIT(_buffer)
+
+
+
+/*------------------------------+
+ | Public function declarations |
+ +------------------------------*/
+
+
+/** Dynamically initialise a power-of-two FIFO
+ *
+ * **DO NOT** call this function on a FIFO that has been already initialised
+ * with `RT_POW2_FIFO_INIT()`.
+ *
+ * @param fifo       [in,out] FIFO structure to initialise; must not be NULL.
+ * @param capacity   [in]     FIFO capacity, in number of items; must be a
+ *                            power of two <= 32,768.
+ * @param itemSize_B [in]     Size of a single item in the FIFO, in bytes; must
+ *                            be a power of two <= 32,768.
+ * @param buffer     [in]     Where the FIFO items should be stored. `buffer`
+ *                            must not be NULL and must point to a memory area
+ *                            at least `capacity` * `itemSize_B` in size (in
+ *                            bytes).
+ *
+ * @return Nothing
+ */
+void RTPow2FifoInit(RTPow2Fifo* fifo, uint16_t capacity,
+        uint16_t itemSize_B, RTByte* buffer);
+
+
+/** Get the size of a power-of-two FIFO
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The number of items currently stored in the FIFO
+ */
+uint16_t RTPow2FifoSize(const RTPow2Fifo* fifo);
+
+
+/** Get the capacity of a power-of-two FIFO
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The maximum number of items the FIFO can hold
+ */
+uint16_t RTPow2FifoCapacity(const RTPow2Fifo* fifo);
+
+
+/** Test if a power-of-two FIFO is empty
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return `RTTrue` if the FIFO is empty, `RTFalse` if not
+ */
+RTBool RTPow2FifoIsEmpty(const RTPow2Fifo* fifo);
+
+
+/** Test if a power-of-two FIFO is full
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return `RTTrue` if the FIFO is full, `RTFalse` if not
+ */
+RTBool RTPow2FifoIsFull(const RTPow2Fifo* fifo);
+
+
+/** Push an item into a power-of-two FIFO
+ *
+ * @param fifo       [in,out] FIFO where to push the item; must not be NULL.
+ * @param item       [in]     The item to push; must not be NULL. The item
+ *                            itself will be copied, so you retain the ownership
+ *                            of the `item`.
+ * @param itemSize_B [in]     The size of the `item`, in bytes. `itemSize_B`
+ *                            must be > 0 and <= the size of FIFO items (as set
+ *                            when the FIFO is initialised).
+ *
+ * @return `RTTrue` if success, `RTFalse` if the FIFO is full
+ */
+RTBool RTPow2FifoPush(RTPow2Fifo* fifo, const void* item, uint16_t itemSize_B);
+
+
+/** Pop an item from a power-of-two FIFO
+ *
+ * @param fifo       [in,out] FIFO from where to pop the item; must not be NULL.
+ * @param item       [out]    Where to write the popped item; must not be NULL.
+ * @param itemSize_B [in]     Size of the `item` buffer, in bytes. `itemSize_B`
+ *                            must be >= the size of the FIFO items (as set
+ *                            when the FIFO is initialised).
+ *
+ * @return `RTTrue` if success, `RTFalse` if FIFO is empty
+ */
+RTBool RTPow2FifoPop(RTPow2Fifo* fifo, void* item, uint16_t itemSize_B);
+
+
+
+#endif /* RTPOW2FIFO_h_ */
+/* @} */
@@ -0,0 +1,72 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* You should not include this file directly; include "rtpow2fifo.h" instead. */
+
+#ifndef RTPOW2FIFO_PRIV_h_
+#define RTPOW2FIFO_PRIV_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Power-of-two FIFO structure
+ *
+ * `head` and `tail` are free-running counters: they are never reset, and the
+ * number of items in the FIFO is `head - tail` (modulo 2^16). This works
+ * because the capacity is at most 2^15.
+ */
+struct RTPow2Fifo {
+    uint16_t head;      /**< Number of items pushed so far, modulo 2^16 */
+    uint16_t tail;      /**< Number of items popped so far, modulo 2^16 */
+    uint16_t mask;      /**< Capacity of the FIFO minus one */
+    uint16_t itemShift; /**< Size of one item, as a power of 2 */
+    RTByte*  buffer;    /**< Where to store the items */
+};
+
+
+/** Base-2 logarithm of a constant power of two <= 2^15 */
+#define RTPRIV_POW2_FIFO_LOG2(_x)                             \
+    (((_x) >= 0x8000u) ? 15 : ((_x) >= 0x4000u) ? 14 :        \
+     ((_x) >= 0x2000u) ? 13 : ((_x) >= 0x1000u) ? 12 :        \
+     ((_x) >= 0x0800u) ? 11 : ((_x) >= 0x0400u) ? 10 :        \
+     ((_x) >= 0x0200u) ?  9 : ((_x) >= 0x0100u) ?  8 :        \
+     ((_x) >= 0x0080u) ?  7 : ((_x) >= 0x0040u) ?  6 :        \
+     ((_x) >= 0x0020u) ?  5 : ((_x) >= 0x0010u) ?  4 :        \
+     ((_x) >= 0x0008u) ?  3 : ((_x) >= 0x0004u) ?  2 :        \
+     ((_x) >= 0x0002u) ?  1 : 0)
+
+
+/** Macro initialiser for a statically-allocated power-of-two FIFO */
+#define RTPRIV_POW2_FIFO_INIT(_buffer)                                       \
+    {                                                                        \
+        0,                                                                   \
+        0,                                                                   \
+        RTARRAYSIZE(_buffer) - 1                                             \
+            + RTSTATIC_CHECK(RTIS_POW2_15(RTARRAYSIZE(_buffer))),            \
+        RTPRIV_POW2_FIFO_LOG2(sizeof((_buffer)[0]))                          \
+            + RTSTATIC_CHECK(RTIS_POW2_15(sizeof((_buffer)[0]))),            \
+        (RTByte*)(_buffer)                                                   \
+    }
+
+
+
+#endif /* RTPOW2FIFO_PRIV_h_ */
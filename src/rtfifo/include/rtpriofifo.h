@@ -0,0 +1,170 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/** Priority FIFOs
+ *
+ * @defgroup rtpriofifo Priority FIFOs
+ * @addtogroup rtpriofifo
+ * @{
+ *
+ * A priority FIFO groups up to 32 regular FIFOs (`RTFifo`), called lanes. Lane
+ * 0 has the highest priority. Items are pushed into a given lane, and a pop
+ * always returns the oldest item of the highest-priority non-empty lane. Items
+ * within the same lane are thus popped in FIFO order.
+ *
+ * The priority FIFO keeps a bitmap of its non-empty lanes, so a pop finds the
+ * lane to pop from with a single count-trailing-zeros instruction, whatever the
+ * number of lanes and the number of items queued in lower-priority lanes.
+ *
+ * Like regular FIFOs, priority FIFOs are not thread-safe.
+ */
+
+#ifndef RTPRIOFIFO_h_
+#define RTPRIOFIFO_h_
+
+#include "rtplf.h"
+#include "rtfifo.h"
+#include "rtpriofifo_priv.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** "Opaque" type that represents a priority FIFO
+ *
+ * *Important note*: Never access the structure directly! Always use the
+ * priority FIFO functions. In particular, never push into or pop from a lane
+ * directly, as the priority FIFO would not know about it.
+ */
+typedef struct RTPrioFifo RTPrioFifo;
+
+
+/** Macro initialiser for a statically-allocated priority FIFO
+ *
+ * This macro can be used to initialise a priority FIFO when its lanes have
+ * been previously *statically* declared as an array of empty FIFOs.
+ * Compilation will fail if the array has more than 32 elements. Lanes may have
+ * different capacities, but they must all have the same item size.
+ *
+ * The priority FIFO will then take ownership of the `_lanes`, which should then
+ * not be accessed by anything else.
+ *
+ * For example:
+ *   typedef struct { ... } MyStruct;
+ *   static MyStruct gMyUrgentBuffer[8];
+ *   static MyStruct gMyBulkBuffer[256];
+ *   static RTFifo gMyLanes[2] = {
+ *       RT_FIFO_INIT(gMyUrgentBuffer),
+ *       RT_FIFO_INIT(gMyBulkBuffer)
+ *   };
+ *   static RTPrioFifo gMyFifo = RT_PRIO_FIFO_INIT(gMyLanes);
+ */
+#define RT_PRIO_FIFO_INIT(_lanes) RTPRIV_PRIO_FIFO_INIT(_lanes)
+
+
+
+/*------------------------------+
+ | Public function declarations |
+ +------------------------------*/
+
+
+/** Dynamically initialise a priority FIFO
+ *
+ * **DO NOT** call this function on a priority FIFO that has been already
+ * initialised with `RT_PRIO_FIFO_INIT()`.
+ *
+ * @param fifo      [in,out] Priority FIFO to initialise; must not be NULL.
+ * @param lanes     [in]     Array of `laneCount` initialised FIFOs, highest
+ *                           priority first; must not be NULL. The lanes may
+ *                           already hold items. They must all have the same
+ *                           item size.
+ * @param laneCount [in]     Number of lanes; must be > 0 and <= 32.
+ *
+ * @return Nothing
+ */
+void RTPrioFifoInit(RTPrioFifo* fifo, RTFifo* lanes, uint8_t laneCount);
+
+
+/** Get the number of lanes of a priority FIFO
+ *
+ * @param fifo [in] Priority FIFO to query; must not be NULL.
+ *
+ * @return The number of lanes
+ */
+uint8_t RTPrioFifoLaneCount(const RTPrioFifo* fifo);
+
+
+/** Get the number of items in a priority FIFO
+ *
+ * This function has to add up the sizes of all the non-empty lanes.
+ *
+ * @param fifo [in] Priority FIFO to query; must not be NULL.
+ *
+ * @return The number of items currently stored in all the lanes
+ */
+uint32_t RTPrioFifoSize(const RTPrioFifo* fifo);
+
+
+/** Test if a priority FIFO is empty
+ *
+ * @param fifo [in] Priority FIFO to query; must not be NULL.
+ *
+ * @return `RTTrue` if all the lanes are empty, `RTFalse` if not
+ */
+RTBool RTPrioFifoIsEmpty(const RTPrioFifo* fifo);
+
+
+/** Push an item into a lane of a priority FIFO
+ *
+ * @param fifo       [in,out] Priority FIFO where to push the item; must not be
+ *                            NULL.
+ * @param lane       [in]     Lane where to push the item; must be < the number
+ *                            of lanes. 0 is the highest priority.
+ * @param item       [in]     The item to push; must not be NULL. The item
+ *                            itself will be copied, so you retain the ownership
+ *                            of the `item`.
+ * @param itemSize_B [in]     The size of the `item`, in bytes. `itemSize_B`
+ *                            must be > 0 and <= the size of FIFO items.
+ *
+ * @return `RTTrue` if success, `RTFalse` if the lane is full
+ */
+RTBool RTPrioFifoPush(RTPrioFifo* fifo, uint8_t lane, const void* item,
+        uint16_t itemSize_B);
+
+
+/** Pop the oldest item of the highest-priority non-empty lane
+ *
+ * @param fifo       [in,out] Priority FIFO from where to pop the item; must not
+ *                            be NULL.
+ * @param item       [out]    Where to write the popped item; must not be NULL.
+ * @param itemSize_B [in]     Size of the `item` buffer, in bytes. `itemSize_B`
+ *                            must be >= the size of the FIFO items.
+ * @param lane       [out]    Where to write the lane the item has been popped
+ *                            from; may be NULL if you are not interested.
+ *
+ * @return `RTTrue` if success, `RTFalse` if all the lanes are empty
+ */
+RTBool RTPrioFifoPop(RTPrioFifo* fifo, void* item, uint16_t itemSize_B,
+        uint8_t* lane);
+
+
+
+#endif /* RTPRIOFIFO_h_ */
+/* @} */
@@ -0,0 +1,60 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/* You should not include this file directly; include "rtpriofifo.h" instead. */
+
+#ifndef RTPRIOFIFO_PRIV_h_
+#define RTPRIOFIFO_PRIV_h_
+
+#include "rtplf.h"
+#include "rtfifo.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Priority FIFO structure
+ *
+ * Bit `i` of `nonEmpty` is set if and only if lane `i` holds at least one item.
+ */
+struct RTPrioFifo {
+    uint32_t nonEmpty;  /**< Bitmap of non-empty lanes */
+    uint8_t  laneCount; /**< Number of lanes */
+    RTFifo*  lanes;     /**< The lanes, highest priority first */
+};
+
+
+/** Maximum number of lanes, i.e. number of bits in `nonEmpty` */
+#define RTPRIV_PRIO_FIFO_MAX_LANES 32u
+
+
+/** Macro initialiser for a statically-allocated priority FIFO */
+#define RTPRIV_PRIO_FIFO_INIT(_lanes)                                        \
+    {                                                                        \
+        0,                                                                   \
+        RTARRAYSIZE(_lanes)                                                  \
+            + RTSTATIC_CHECK(                                                \
+                    RTARRAYSIZE(_lanes) <= RTPRIV_PRIO_FIFO_MAX_LANES),      \
+        (_lanes)                                                             \
+    }
+
+
+
+#endif /* RTPRIOFIFO_PRIV_h_ */
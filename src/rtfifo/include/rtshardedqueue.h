@@ -0,0 +1,243 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Sharded queues
+ *
+ * @defgroup rtshardedqueue Sharded queues
+ * @addtogroup rtshardedqueue
+ * @{
+ *
+ * A sharded queue spreads its items over several MPSC FIFOs (`RTMpscFifo`),
+ * called shards, typically one per CPU. A producer binds itself once to the
+ * shard of the CPU it is running on by calling `RTShardedQueueBind()`, and
+ * then pushes into that shard with `RTShardedQueuePushTo()`, so producers on
+ * different CPUs don't write to the same cache lines. A single consumer drains
+ * the shards round-robin, taking up to a given number of items from a shard
+ * before moving on to the next one.
+ *
+ * There is thus no global FIFO order: two items pushed into different shards
+ * may be popped in any order. Items pushed into the same shard are popped in
+ * FIFO order, so the items of a producer are popped in the order they have
+ * been pushed as long as that producer always pushes into the same shard. A
+ * producer that pushes into the shard it has bound to keeps its order even if
+ * it later migrates to another CPU. `RTShardedQueuePush()` looks up the
+ * current CPU on every call instead, so it keeps the order only if the
+ * producer is pinned to a single CPU.
+ *
+ * Any number of producers may push concurrently, but there must be only one
+ * consumer.
+ */
+
+#ifndef RTSHARDEDQUEUE_h_
+#define RTSHARDEDQUEUE_h_
+
+#include "rtplf.h"
+#include "rtmpscfifo.h"
+#include "rtshardedqueue_priv.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** "Opaque" type that represents a sharded queue
+ *
+ * *Important note*: Never access the structure directly! Always use the
+ * sharded queue functions. In particular, never pop from a shard directly.
+ */
+typedef struct RTShardedQueue RTShardedQueue;
+
+
+/** Macro initialiser for a statically-allocated sharded queue
+ *
+ * This macro can be used to initialise a sharded queue when its shards have
+ * been previously *statically* declared as an array of empty MPSC FIFOs.
+ * Shards may have different capacities, but they must all have the same item
+ * size.
+ *
+ * The sharded queue will then take ownership of the `_shards`, which should
+ * then not be accessed by anything else.
+ *
+ * For example:
+ *   typedef struct { ... } MyStruct;
+ *   static MyStruct gMyBuffer0[64];
+ *   static MyStruct gMyBuffer1[64];
+ *   static uint32_t gMySeqs0[64];
+ *   static uint32_t gMySeqs1[64];
+ *   static RTMpscFifo gMyShards[2] = {
+ *       RT_MPSC_FIFO_INIT(gMyBuffer0, gMySeqs0),
+ *       RT_MPSC_FIFO_INIT(gMyBuffer1, gMySeqs1)
+ *   };
+ *   static RTShardedQueue gMyQueue = RT_SHARDED_QUEUE_INIT(gMyShards);
+ */
+#define RT_SHARDED_QUEUE_INIT(_shards) RTPRIV_SHARDED_QUEUE_INIT(_shards)
+
+
+
+/*------------------------------+
+ | Public function declarations |
+ +------------------------------*/
+
+
+/** Dynamically initialise a sharded queue
+ *
+ * **DO NOT** call this function on a sharded queue that has been already
+ * initialised with `RT_SHARDED_QUEUE_INIT()`, nor while it is in use.
+ *
+ * @param queue      [in,out] Sharded queue to initialise; must not be NULL.
+ * @param shards     [in]     Array of `shardCount` initialised MPSC FIFOs; must
+ *                            not be NULL. The shards may already hold items.
+ *                            They must all have the same item size.
+ * @param shardCount [in]     Number of shards; must be > 0.
+ *
+ * @return Nothing
+ */
+void RTShardedQueueInit(RTShardedQueue* queue, RTMpscFifo* shards,
+        uint16_t shardCount);
+
+
+/** Get the number of shards of a sharded queue
+ *
+ * @param queue [in] Sharded queue to query; must not be NULL.
+ *
+ * @return The number of shards
+ */
+uint16_t RTShardedQueueShardCount(const RTShardedQueue* queue);
+
+
+/** Get the number of items in a sharded queue
+ *
+ * This function has to add up the sizes of all the shards. If other threads
+ * are using the queue concurrently, the returned value may already be out of
+ * date.
+ *
+ * @param queue [in] Sharded queue to query; must not be NULL.
+ *
+ * @return The number of items currently stored in all the shards
+ */
+uint32_t RTShardedQueueSize(const RTShardedQueue* queue);
+
+
+/** Get the shard a producer should push into
+ *
+ * The shard is the index of the current CPU (as given by `RTCurrentCpu()`)
+ * modulo the number of shards. A producer should call this function once and
+ * then push into the returned shard with `RTShardedQueuePushTo()`; this keeps
+ * its items in order if it migrates to another CPU, and it saves looking up
+ * the current CPU on every push.
+ *
+ * @param queue [in] Sharded queue to query; must not be NULL.
+ *
+ * @return The shard of the current CPU
+ */
+uint16_t RTShardedQueueBind(const RTShardedQueue* queue);
+
+
+/** Push an item into the shard of the current CPU
+ *
+ * Same as `RTShardedQueuePushTo()` with the shard returned by
+ * `RTShardedQueueBind()`, except that the current CPU is looked up on every
+ * call. If the producer migrates to another CPU between two pushes, its items
+ * may thus go to different shards and be popped out of order; prefer binding
+ * the producer once unless it is pinned to a single CPU.
+ *
+ * This function can be called by several producers concurrently.
+ *
+ * @param queue      [in,out] Sharded queue where to push the item; must not be
+ *                            NULL.
+ * @param item       [in]     The item to push; must not be NULL. The item
+ *                            itself will be copied, so you retain the ownership
+ *                            of the `item`.
+ * @param itemSize_B [in]     The size of the `item`, in bytes. `itemSize_B`
+ *                            must be > 0 and <= the size of the shard items.
+ *
+ * @return `RTTrue` if success, `RTFalse` if the shard is full
+ */
+RTBool RTShardedQueuePush(RTShardedQueue* queue, const void* item,
+        uint16_t itemSize_B);
+
+
+/** Push an item into a given shard
+ *
+ * This function can be called by several producers concurrently.
+ *
+ * @param queue      [in,out] Sharded queue where to push the item; must not be
+ *                            NULL.
+ * @param shard      [in]     Shard where to push the item; must be < the number
+ *                            of shards.
+ * @param item       [in]     The item to push; must not be NULL. The item
+ *                            itself will be copied, so you retain the ownership
+ *                            of the `item`.
+ * @param itemSize_B [in]     The size of the `item`, in bytes. `itemSize_B`
+ *                            must be > 0 and <= the size of the shard items.
+ *
+ * @return `RTTrue` if success, `RTFalse` if the shard is full
+ */
+RTBool RTShardedQueuePushTo(RTShardedQueue* queue, uint16_t shard,
+        const void* item, uint16_t itemSize_B);
+
+
+/** Pop a batch of items from a sharded queue
+ *
+ * The shards are visited round-robin, starting where the previous call left
+ * off. Up to `batch` items are popped from a shard before moving on to the
+ * next one. This function returns when `count` items have been popped, or
+ * when all the shards have been found empty in a row.
+ *
+ * Must only be called by the consumer.
+ *
+ * @param queue      [in,out] Sharded queue from where to pop the items; must
+ *                            not be NULL.
+ * @param items      [out]    Where to write the popped items; must not be NULL
+ *                            and must point to an array of `count` elements of
+ *                            `itemSize_B` bytes each.
+ * @param itemSize_B [in]     Size of one element of `items`, in bytes.
+ *                            `itemSize_B` must be >= the size of the shard
+ *                            items.
+ * @param count      [in]     Maximum number of items to pop
+ * @param batch      [in]     Maximum number of items to pop from a shard in a
+ *                            row; must be > 0.
+ *
+ * @return The number of items popped, which may be 0
+ */
+uint32_t RTShardedQueuePopN(RTShardedQueue* queue, void* items,
+        uint16_t itemSize_B, uint32_t count, uint16_t batch);
+
+
+/** Pop one item from a sharded queue
+ *
+ * Same as `RTShardedQueuePopN()` with a `count` and a `batch` of 1, so
+ * successive calls take one item from each non-empty shard in turn.
+ *
+ * Must only be called by the consumer.
+ *
+ * @param queue      [in,out] Sharded queue from where to pop the item; must
+ *                            not be NULL.
+ * @param item       [out]    Where to write the popped item; must not be NULL.
+ * @param itemSize_B [in]     Size of the `item` buffer, in bytes. `itemSize_B`
+ *                            must be >= the size of the shard items.
+ *
+ * @return `RTTrue` if success, `RTFalse` if all the shards are empty
+ */
+RTBool RTShardedQueuePop(RTShardedQueue* queue, void* item,
+        uint16_t itemSize_B);
+
+
+
+#endif /* RTSHARDEDQUEUE_h_ */
+/* @} */
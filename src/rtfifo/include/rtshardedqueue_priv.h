@@ -0,0 +1,61 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* You should not include this file directly; include "rtshardedqueue.h"
+ * instead. */
+
+#ifndef RTSHARDEDQUEUE_PRIV_h_
+#define RTSHARDEDQUEUE_PRIV_h_
+
+#include "rtplf.h"
+#include "rtmpscfifo.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Sharded queue structure
+ *
+ * `shardCount` and `shards` are read by every push, while `next` is written
+ * by the consumer on every pop, so `next` lives on its own cache line. `next`
+ * is only used by the consumer, so it does not need to be atomic. Each shard
+ * already keeps its head and tail on separate cache lines.
+ */
+struct RTShardedQueue {
+    uint16_t    shardCount;          /**< Number of shards */
+    RTMpscFifo* shards;              /**< The shards */
+    RTByte      pad0[RTCACHELINE_B]; /**< Padding */
+    uint16_t    next;                /**< Next shard the consumer pops from */
+    RTByte      pad1[RTCACHELINE_B]; /**< Padding */
+};
+
+
+/** Macro initialiser for a statically-allocated sharded queue */
+#define RTPRIV_SHARDED_QUEUE_INIT(_shards) \
+    {                                      \
+        RTARRAYSIZE(_shards),              \
+        (_shards),                         \
+        { 0 },                             \
+        0,                                 \
+        { 0 }                              \
+    }
+
+
+
+#endif /* RTSHARDEDQUEUE_PRIV_h_ */
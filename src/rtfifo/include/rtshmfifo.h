@@ -0,0 +1,188 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Lock-free FIFOs in shared memory
+ *
+ * @defgroup rtshmfifo Shared-memory FIFOs
+ * @addtogroup rtshmfifo
+ * @{
+ *
+ * A shared-memory FIFO lives entirely inside a memory area provided by the
+ * caller, typically a `RTSharedMem` mapped by several processes. It contains
+ * no pointer, so each process can map the memory area at a different address.
+ *
+ * Like an MPSC FIFO (see rtmpscfifo.h), it can be pushed to by any number of
+ * producers concurrently, and popped from by exactly one consumer, without
+ * any lock; producers and consumer can be in different processes. A single
+ * producer is just a special case.
+ *
+ * One process creates the FIFO with `RTShmFifoCreate()`, then the other
+ * processes get access to it with `RTShmFifoAttach()`. Each process works
+ * through its own `RTShmFifo` handle.
+ */
+
+#ifndef RTSHMFIFO_h_
+#define RTSHMFIFO_h_
+
+#include "rtplf.h"
+#include "rtshmfifo_priv.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** "Opaque" type that represents a process-local handle to a shared-memory FIFO
+ *
+ * This FIFO can take up to 65,535 items. Items must be of the same size, which
+ * can be up to 65,535 bytes.
+ *
+ * *Important note*: Never access the structure directly! Always use the FIFO
+ * functions.
+ */
+typedef struct RTShmFifo RTShmFifo;
+
+
+
+/*------------------------------+
+ | Public function declarations |
+ +------------------------------*/
+
+
+/** Compute the size of the memory area needed by a shared-memory FIFO
+ *
+ * @param capacity   [in] FIFO capacity, in number of items; must be > 0.
+ * @param itemSize_B [in] Size of a single item in the FIFO, in bytes; must be
+ *                        > 0.
+ *
+ * @return The size of the memory area, in bytes
+ */
+size_t RTShmFifoFootprint_B(uint16_t capacity, uint16_t itemSize_B);
+
+
+/** Create a shared-memory FIFO
+ *
+ * **DO NOT** call this function while other processes are using the FIFO.
+ *
+ * @param fifo       [out] Handle to initialise; must not be NULL.
+ * @param mem        [out] Memory area where to create the FIFO; must not be
+ *                         NULL and must be 8-byte aligned.
+ * @param mem_B      [in]  Size of `mem`, in bytes; must be at least
+ *                         `RTShmFifoFootprint_B(capacity, itemSize_B)`.
+ * @param capacity   [in]  FIFO capacity, in number of items; must be > 0.
+ * @param itemSize_B [in]  Size of a single item in the FIFO, in bytes; must be
+ *                         > 0.
+ */
+void RTShmFifoCreate(RTShmFifo* fifo, void* mem, size_t mem_B,
+        uint16_t capacity, uint16_t itemSize_B);
+
+
+/** Get access to a shared-memory FIFO created by another process
+ *
+ * The capacity and item size found in `mem` are checked against `mem_B`, and
+ * copied into `fifo`; they are not read from `mem` afterwards.
+ *
+ * @param fifo  [out] Handle to initialise; must not be NULL.
+ * @param mem   [in]  Memory area where the FIFO has been created; must not be
+ *                    NULL and must be 8-byte aligned.
+ * @param mem_B [in]  Size of `mem`, in bytes
+ *
+ * @return `RTTrue` if success, `RTFalse` if `mem` does not hold a valid FIFO
+ */
+RTBool RTShmFifoAttach(RTShmFifo* fifo, void* mem, size_t mem_B);
+
+
+/** Get the size of a shared-memory FIFO
+ *
+ * Items that are being pushed are included in the count. If other threads or
+ * processes are using the FIFO concurrently, the returned value may already be
+ * out of date.
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The number of items currently stored in the FIFO
+ */
+uint16_t RTShmFifoSize(const RTShmFifo* fifo);
+
+
+/** Get the capacity of a shared-memory FIFO
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The maximum number of items the FIFO can hold
+ */
+uint16_t RTShmFifoCapacity(const RTShmFifo* fifo);
+
+
+/** Test if a shared-memory FIFO is empty
+ *
+ * Same remark as for `RTShmFifoSize()`.
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return `RTTrue` if the FIFO is empty, `RTFalse` if not
+ */
+RTBool RTShmFifoIsEmpty(const RTShmFifo* fifo);
+
+
+/** Test if a shared-memory FIFO is full
+ *
+ * Same remark as for `RTShmFifoSize()`.
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return `RTTrue` if the FIFO is full, `RTFalse` if not
+ */
+RTBool RTShmFifoIsFull(const RTShmFifo* fifo);
+
+
+/** Push an item into a shared-memory FIFO
+ *
+ * This function can be called by several producers concurrently.
+ *
+ * @param fifo       [in,out] FIFO where to push the item; must not be NULL.
+ * @param item       [in]     The item to push; must not be NULL. The item
+ *                            itself will be copied, so you retain the ownership
+ *                            of the `item`.
+ * @param itemSize_B [in]     The size of the `item`, in bytes. `itemSize_B`
+ *                            must be > 0 and <= the size of FIFO items (as set
+ *                            when the FIFO is created).
+ *
+ * @return `RTTrue` if success, `RTFalse` if the FIFO is full
+ */
+RTBool RTShmFifoPush(RTShmFifo* fifo, const void* item, uint16_t itemSize_B);
+
+
+/** Pop an item from a shared-memory FIFO
+ *
+ * Must only be called by the consumer. This function is wait-free.
+ *
+ * @param fifo       [in,out] FIFO from where to pop the item; must not be NULL.
+ * @param item       [out]    Where to write the popped item; must not be NULL.
+ * @param itemSize_B [in]     Size of the `item` buffer, in bytes. `itemSize_B`
+ *                            must be >= the size of the FIFO items (as set
+ *                            when the FIFO is created).
+ *
+ * @return `RTTrue` if success, `RTFalse` if FIFO is empty
+ */
+RTBool RTShmFifoPop(RTShmFifo* fifo, void* item, uint16_t itemSize_B);
+
+
+
+#endif /* RTSHMFIFO_h_ */
+/* @} */
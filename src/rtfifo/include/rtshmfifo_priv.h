@@ -0,0 +1,81 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* You should not include this file directly; include "rtshmfifo.h" instead. */
+
+#ifndef RTSHMFIFO_PRIV_h_
+#define RTSHMFIFO_PRIV_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Header of a shared-memory FIFO
+ *
+ * This structure is the first thing in the memory area of the FIFO. It is
+ * followed by the array of sequence numbers and then by the item buffer, both
+ * starting on a multiple of `RTPRIV_SHM_FIFO_ALIGN_B` bytes. The items are
+ * packed in the buffer, `itemSize_B` bytes apart, so they are not aligned
+ * unless `itemSize_B` is a multiple of the alignment; they are only ever
+ * accessed with `RTMemcpy()`.
+ *
+ * The protocol is the same as for the MPSC FIFO (see rtticket_priv.h).
+ */
+typedef struct {
+    uint32_t magic;               /**< `RTPRIV_SHM_FIFO_MAGIC` once set up */
+    uint16_t capacity;            /**< Capacity of the FIFO, in items */
+    uint16_t itemSize_B;          /**< Size of one item, in bytes */
+    RTByte   pad0[RTCACHELINE_B]; /**< Padding */
+    uint32_t head;                /**< Next push ticket; CAS by producers */
+    RTByte   pad1[RTCACHELINE_B]; /**< Padding */
+    uint32_t tail;                /**< Next pop ticket; consumer only */
+    RTByte   pad2[RTCACHELINE_B]; /**< Padding */
+} RTPrivShmFifoHeader;
+
+
+/** Process-local handle to a shared-memory FIFO
+ *
+ * The geometry is read from the header only once, when the FIFO is attached,
+ * and checked against the size of the memory area. It is never read again
+ * from the shared memory, so another process can't make this one access
+ * memory outside of the area by changing the header.
+ */
+struct RTShmFifo {
+    RTPrivShmFifoHeader* header;     /**< Header, in the shared memory */
+    uint32_t*            seqs;       /**< Sequence number of each slot */
+    RTByte*              buffer;     /**< Where the items are stored */
+    uint16_t             capacity;   /**< Capacity of the FIFO, in items */
+    uint16_t             itemSize_B; /**< Size of one item, in bytes */
+    uint32_t             laps;       /**< Number of laps before tickets wrap */
+};
+
+
+/** Value of the `magic` field of a shared-memory FIFO which is set up */
+#define RTPRIV_SHM_FIFO_MAGIC 0x46534852u
+
+
+/** Alignment of the memory area, of the sequence numbers and of the item
+ * buffer of a shared-memory FIFO, in bytes */
+#define RTPRIV_SHM_FIFO_ALIGN_B 8u
+
+
+
+#endif /* RTSHMFIFO_PRIV_h_ */
@@ -0,0 +1,178 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Lock-free single-producer/single-consumer FIFOs
+ *
+ * @defgroup rtspscfifo SPSC FIFOs
+ * @addtogroup rtspscfifo
+ * @{
+ *
+ * An SPSC FIFO can be shared by exactly one producer and exactly one consumer
+ * running concurrently (eg: two threads, or an ISR and the main loop) without
+ * any lock. The producer only ever writes the head of the FIFO and the consumer
+ * only ever writes its tail; the item copied into the buffer is published with
+ * a release store and observed with an acquire load.
+ *
+ * If you have more than one producer or more than one consumer, you must
+ * serialise them yourself.
+ */
+
+#ifndef RTSPSCFIFO_h_
+#define RTSPSCFIFO_h_
+
+#include "rtplf.h"
+#include "rtspscfifo_priv.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** "Opaque" type that represents an SPSC FIFO
+ *
+ * This FIFO can take up to 65,535 items. Items must be of the same size, which
+ * can be up to 65,535 bytes.
+ *
+ * *Important note*: Never access the structure directly! Always use the FIFO
+ * functions.
+ */
+typedef struct RTSpscFifo RTSpscFifo;
+
+
+/** Macro initialiser for a statically-allocated SPSC FIFO
+ *
+ * This macro can be used to initialise an SPSC FIFO when the underlying buffer
+ * has been previously *statically* declared as an array.
+ *
+ * The FIFO will then take ownership of the `_buffer`, which should then not be
+ * accessed by anything else.
+ *
+ * For example:
+ *   typedef struct { ... } MyStruct;
+ *   static MyStruct gMyBuffer[32];
+ *   static RTSpscFifo gMyFifo = RT_SPSC_FIFO_INIT(gMyBuffer);
+ */
+#define RT_SPSC_FIFO_INIT(_buffer) RTPRIV_SPSC_FIFO_INIT(_buffer)
+
+
+
+/*------------------------------+
+ | Public function declarations |
+ +------------------------------*/
+
+
+/** Dynamically initialise an SPSC FIFO
+ *
+ * **DO NOT** call this function on a FIFO that has been already initialised
+ * with `RT_SPSC_FIFO_INIT()`, nor while the FIFO is in use.
+ *
+ * @param fifo       [in,out] FIFO structure to initialise; must not be NULL.
+ * @param capacity   [in]     FIFO capacity, in number of items; must be > 0.
+ * @param itemSize_B [in]     Size of a single item in the FIFO, in bytes; must
+ *                            be > 0.
+ * @param buffer     [in]     Where the FIFO items should be stored. `buffer`
+ *                            must not be NULL and must point to a memory area
+ *                            at least `capacity` * `itemSize_B` in size (in
+ *                            bytes).
+ *
+ * @return Nothing
+ */
+void RTSpscFifoInit(RTSpscFifo* fifo, uint16_t capacity,
+        uint16_t itemSize_B, RTByte* buffer);
+
+
+/** Get the size of an SPSC FIFO
+ *
+ * This can be called from either side. If the other side is running
+ * concurrently, the returned value may already be out of date. If
+ * called from a third thread, the result is only an estimate, but it
+ * never exceeds the capacity of the FIFO.
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The number of items currently stored in the FIFO
+ */
+uint16_t RTSpscFifoSize(const RTSpscFifo* fifo);
+
+
+/** Get the capacity of an SPSC FIFO
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return The maximum number of items the FIFO can hold
+ */
+uint16_t RTSpscFifoCapacity(const RTSpscFifo* fifo);
+
+
+/** Test if an SPSC FIFO is empty
+ *
+ * Same remark as for `RTSpscFifoSize()`.
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return `RTTrue` if the FIFO is empty, `RTFalse` if not
+ */
+RTBool RTSpscFifoIsEmpty(const RTSpscFifo* fifo);
+
+
+/** Test if an SPSC FIFO is full
+ *
+ * Same remark as for `RTSpscFifoSize()`.
+ *
+ * @param fifo [in] FIFO to query; must not be NULL.
+ *
+ * @return `RTTrue` if the FIFO is full, `RTFalse` if not
+ */
+RTBool RTSpscFifoIsFull(const RTSpscFifo* fifo);
+
+
+/** Push an item into an SPSC FIFO
+ *
+ * Must only be called by the producer.
+ *
+ * @param fifo       [in,out] FIFO where to push the item; must not be NULL.
+ * @param item       [in]     The item to push; must not be NULL. The item
+ *                            itself will be copied, so you retain the ownership
+ *                            of the `item`.
+ * @param itemSize_B [in]     The size of the `item`, in bytes. `itemSize_B`
+ *                            must be > 0 and <= the size of FIFO items (as set
+ *                            when the FIFO is initialised).
+ *
+ * @return `RTTrue` if success, `RTFalse` if the FIFO is full
+ */
+RTBool RTSpscFifoPush(RTSpscFifo* fifo, const void* item, uint16_t itemSize_B);
+
+
+/** Pop an item from an SPSC FIFO
+ *
+ * Must only be called by the consumer.
+ *
+ * @param fifo       [in,out] FIFO from where to pop the item; must not be NULL.
+ * @param item       [out]    Where to write the popped item; must not be NULL.
+ * @param itemSize_B [in]     Size of the `item` buffer, in bytes. `itemSize_B`
+ *                            must be >= the size of the FIFO items (as set
+ *                            when the FIFO is initialised).
+ *
+ * @return `RTTrue` if success, `RTFalse` if FIFO is empty
+ */
+RTBool RTSpscFifoPop(RTSpscFifo* fifo, void* item, uint16_t itemSize_B);
+
+
+
+#endif /* RTSPSCFIFO_h_ */
+/* @} */
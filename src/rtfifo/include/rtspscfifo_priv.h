@@ -0,0 +1,70 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* You should not include this file directly; include "rtspscfifo.h" instead. */
+
+#ifndef RTSPSCFIFO_PRIV_h_
+#define RTSPSCFIFO_PRIV_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Single-producer/single-consumer FIFO structure
+ *
+ * `head` and `tail` run from 0 to (2 * `capacity`) - 1, so that a full FIFO
+ * can be told apart from an empty one without wasting a slot.
+ *
+ * The fields written by the producer and the ones written by the consumer are
+ * kept on separate cache lines.
+ */
+struct RTSpscFifo {
+    uint16_t capacity;            /**< Capacity of the FIFO, in items */
+    uint16_t itemSize_B;          /**< Size of one item, in bytes */
+    RTByte*  buffer;              /**< Where to store the items */
+    RTByte   pad0[RTCACHELINE_B]; /**< Padding */
+    uint32_t head;                /**< Head of the FIFO; producer only */
+    uint32_t tailCache;           /**< Last `tail` seen by the producer */
+    RTByte   pad1[RTCACHELINE_B]; /**< Padding */
+    uint32_t tail;                /**< Tail of the FIFO; consumer only */
+    uint32_t headCache;           /**< Last `head` seen by the consumer */
+    RTByte   pad2[RTCACHELINE_B]; /**< Padding */
+};
+
+
+/** Macro initialiser for a statically-allocated SPSC FIFO */
+#define RTPRIV_SPSC_FIFO_INIT(_buffer) \
+    {                                  \
+        RTARRAYSIZE(_buffer),          \
+        sizeof((_buffer)[0]),          \
+        (RTByte*)(_buffer),            \
+        { 0 },                         \
+        0,                             \
+        0,                             \
+        { 0 },                         \
+        0,                             \
+        0,                             \
+        { 0 }                          \
+    }
+
+
+
+#endif /* RTSPSCFIFO_PRIV_h_ */
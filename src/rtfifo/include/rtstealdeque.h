@@ -0,0 +1,196 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/** Lock-free work-stealing deques
+ *
+ * @defgroup rtstealdeque Work-stealing deques
+ * @addtogroup rtstealdeque
+ * @{
+ *
+ * A work-stealing deque (Chase & Lev) belongs to one thread, its owner, which
+ * pushes and pops items at the bottom end, like a stack. Any number of other
+ * threads, called thieves, can concurrently steal the oldest items from the
+ * top end. This is the building block of work-stealing schedulers: each worker
+ * thread owns a deque of tasks, and a worker which runs out of tasks steals
+ * some from the others.
+ *
+ * The owner only contends with thieves when the deque holds a single item;
+ * thieves contend with each other by a compare-and-swap on the top index.
+ *
+ * Unlike the original algorithm, the deque does not grow: a push fails when
+ * the deque is full. Its capacity must be a power of two.
+ */
+
+#ifndef RTSTEALDEQUE_h_
+#define RTSTEALDEQUE_h_
+
+#include "rtplf.h"
+#include "rtstealdeque_priv.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** "Opaque" type that represents a work-stealing deque
+ *
+ * This deque can take up to 32,768 items, and the capacity must be a power of
+ * two. Items must be of the same size, which can be up to 65,535 bytes.
+ *
+ * *Important note*: Never access the structure directly! Always use the deque
+ * functions.
+ */
+typedef struct RTStealDeque RTStealDeque;
+
+
+/** Macro initialiser for a statically-allocated work-stealing deque
+ *
+ * This macro can be used to initialise a deque when the underlying buffer has
+ * been previously *statically* declared as an array. Compilation will fail if
+ * the number of elements of the array is not a power of two.
+ *
+ * The deque will then take ownership of the `_buffer`, which should then not be
+ * accessed by anything else.
+ *
+ * For example:
+ *   typedef struct { ... } MyTask;
+ *   static MyTask gMyBuffer[256];
+ *   static RTStealDeque gMyDeque = RT_STEAL_DEQUE_INIT(gMyBuffer);
+ */
+#define RT_STEAL_DEQUE_INIT(_buffer) RTPRIV_STEAL_DEQUE_INIT(_buffer)
+
+
+
+/*------------------------------+
+ | Public function declarations |
+ +------------------------------*/
+
+
+/** Dynamically initialise a work-stealing deque
+ *
+ * **DO NOT** call this function on a deque that has been already initialised
+ * with `RT_STEAL_DEQUE_INIT()`, nor while the deque is in use.
+ *
+ * @param deque      [in,out] Deque structure to initialise; must not be NULL.
+ * @param capacity   [in]     Deque capacity, in number of items; must be a
+ *                            power of two <= 32,768.
+ * @param itemSize_B [in]     Size of a single item in the deque, in bytes;
+ *                            must be > 0.
+ * @param buffer     [in]     Where the deque items should be stored. `buffer`
+ *                            must not be NULL and must point to a memory area
+ *                            at least `capacity` * `itemSize_B` in size (in
+ *                            bytes).
+ *
+ * @return Nothing
+ */
+void RTStealDequeInit(RTStealDeque* deque, uint16_t capacity,
+        uint16_t itemSize_B, RTByte* buffer);
+
+
+/** Get the size of a work-stealing deque
+ *
+ * If other threads are using the deque concurrently, the returned value may
+ * already be out of date.
+ *
+ * @param deque [in] Deque to query; must not be NULL.
+ *
+ * @return The number of items currently stored in the deque
+ */
+uint16_t RTStealDequeSize(const RTStealDeque* deque);
+
+
+/** Get the capacity of a work-stealing deque
+ *
+ * @param deque [in] Deque to query; must not be NULL.
+ *
+ * @return The maximum number of items the deque can hold
+ */
+uint16_t RTStealDequeCapacity(const RTStealDeque* deque);
+
+
+/** Test if a work-stealing deque is empty
+ *
+ * Same remark as for `RTStealDequeSize()`.
+ *
+ * @param deque [in] Deque to query; must not be NULL.
+ *
+ * @return `RTTrue` if the deque is empty, `RTFalse` if not
+ */
+RTBool RTStealDequeIsEmpty(const RTStealDeque* deque);
+
+
+/** Push an item at the bottom of a work-stealing deque
+ *
+ * Must only be called by the owner of the deque. This function is wait-free.
+ *
+ * @param deque      [in,out] Deque where to push the item; must not be NULL.
+ * @param item       [in]     The item to push; must not be NULL. The item
+ *                            itself will be copied, so you retain the ownership
+ *                            of the `item`.
+ * @param itemSize_B [in]     The size of the `item`, in bytes. `itemSize_B`
+ *                            must be > 0 and <= the size of deque items (as set
+ *                            when the deque is initialised).
+ *
+ * @return `RTTrue` if success, `RTFalse` if the deque is full
+ */
+RTBool RTStealDequePush(RTStealDeque* deque, const void* item,
+        uint16_t itemSize_B);
+
+
+/** Pop the newest item from the bottom of a work-stealing deque
+ *
+ * Must only be called by the owner of the deque. This function is wait-free.
+ *
+ * @param deque      [in,out] Deque from where to pop the item; must not be
+ *                            NULL.
+ * @param item       [out]    Where to write the popped item; must not be NULL.
+ * @param itemSize_B [in]     Size of the `item` buffer, in bytes. `itemSize_B`
+ *                            must be >= the size of the deque items (as set
+ *                            when the deque is initialised).
+ *
+ * @return `RTTrue` if success, `RTFalse` if the deque is empty (or if a thief
+ *         has just stolen the last item)
+ */
+RTBool RTStealDequePop(RTStealDeque* deque, void* item, uint16_t itemSize_B);
+
+
+/** Steal the oldest item from the top of a work-stealing deque
+ *
+ * This function can be called by any number of threads other than the owner,
+ * concurrently. If another thread takes the item this thief was about to
+ * steal, the thief tries again with the next item, so this function only fails
+ * if the deque is empty.
+ *
+ * The content of `item` is undefined if this function fails.
+ *
+ * @param deque      [in,out] Deque from where to steal the item; must not be
+ *                            NULL.
+ * @param item       [out]    Where to write the stolen item; must not be NULL.
+ * @param itemSize_B [in]     Size of the `item` buffer, in bytes. `itemSize_B`
+ *                            must be >= the size of the deque items (as set
+ *                            when the deque is initialised).
+ *
+ * @return `RTTrue` if success, `RTFalse` if the deque is empty
+ */
+RTBool RTStealDequeSteal(RTStealDeque* deque, void* item, uint16_t itemSize_B);
+
+
+
+#endif /* RTSTEALDEQUE_h_ */
+/* @} */
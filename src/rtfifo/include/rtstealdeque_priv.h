@@ -0,0 +1,72 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/* You should not include this file directly; include "rtstealdeque.h"
+ * instead. */
+
+#ifndef RTSTEALDEQUE_PRIV_h_
+#define RTSTEALDEQUE_PRIV_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Work-stealing deque structure
+ *
+ * `top` and `bottom` are free-running: the deque holds the items from `top`
+ * (included) to `bottom` (excluded), item `i` being stored in slot
+ * `i & (capacity - 1)`. Distances are computed modulo 2^32, which works because
+ * the capacity is a power of two <= 2^15.
+ *
+ * `top` and `bottom` are kept on separate cache lines, as `bottom` is written
+ * by the owner only, whereas `top` is moved by thieves (and by the owner when
+ * it takes the last item).
+ */
+struct RTStealDeque {
+    uint16_t capacity;            /**< Capacity of the deque, in items */
+    uint16_t itemSize_B;          /**< Size of one item, in bytes */
+    RTByte*  buffer;              /**< Where to store the items */
+    RTByte   pad0[RTCACHELINE_B]; /**< Padding */
+    uint32_t top;                 /**< Oldest item; CAS by thieves and owner */
+    RTByte   pad1[RTCACHELINE_B]; /**< Padding */
+    uint32_t bottom;              /**< Next free slot; owner only */
+    RTByte   pad2[RTCACHELINE_B]; /**< Padding */
+};
+
+
+/** Macro initialiser for a statically-allocated work-stealing deque */
+#define RTPRIV_STEAL_DEQUE_INIT(_buffer)                                     \
+    {                                                                        \
+        RTARRAYSIZE(_buffer)                                                 \
+            + RTSTATIC_CHECK(RTIS_POW2_15(RTARRAYSIZE(_buffer))),            \
+        sizeof((_buffer)[0]),                                                \
+        (RTByte*)(_buffer),                                                  \
+        { 0 },                                                               \
+        0,                                                                   \
+        { 0 },                                                               \
+        0,                                                                   \
+        { 0 }                                                                \
+    }
+
+
+
+#endif /* RTSTEALDEQUE_PRIV_h_ */
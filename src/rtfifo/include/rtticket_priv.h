@@ -0,0 +1,264 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* You should not include this file directly; it is private to the ticket-based
+ * FIFOs of the rtfifo module (rtmpscfifo.c, rtmpmcfifo.c and rtshmfifo.c).
+ *
+ * This file implements the ticket protocol shared by these FIFOs. Each push
+ * and each pop is given a ticket; ticket `t` uses slot `t % capacity` during
+ * lap `t / capacity`. Tickets wrap around after `laps` laps.
+ *
+ * The sequence number of a slot is `2 * lap` when the slot is free for that
+ * lap, and `2 * lap + 1` when it holds the item pushed during that lap. All
+ * sequence numbers start at 0, so a zero-initialised array is valid.
+ *
+ * Pushing an item is done in 2 steps: `rtticketClaimPush()` gets a ticket,
+ * then the caller writes the item into the slot and calls `rtticketPublish()`.
+ * Popping an item is similar: `rtticketClaimPop()`, copy the item out of the
+ * slot, then `rtticketRelease()`.
+ */
+
+#ifndef RTTICKET_PRIV_h_
+#define RTTICKET_PRIV_h_
+
+#include "rtplf.h"
+
+
+
+/*-------------------------------+
+ | Private function declarations |
+ +-------------------------------*/
+
+
+/** Increment a ticket, wrapping around after `laps` laps
+ *
+ * @param capacity [in] Capacity of the FIFO, in items
+ * @param laps     [in] Number of laps before tickets wrap
+ * @param ticket   [in] The ticket to increment
+ *
+ * @return The incremented ticket
+ */
+RTINLINE uint32_t rtticketNext(uint32_t capacity, uint32_t laps,
+        uint32_t ticket);
+
+
+/** Get the number of items in a FIFO
+ *
+ * @param head     [in] Next push ticket
+ * @param tail     [in] Next pop ticket
+ * @param capacity [in] Capacity of the FIFO, in items
+ * @param laps     [in] Number of laps before tickets wrap
+ *
+ * @return The number of items, including the ones being pushed; never more
+ *         than `capacity`
+ */
+RTINLINE uint32_t rtticketSize(const uint32_t* head, const uint32_t* tail,
+        uint32_t capacity, uint32_t laps);
+
+
+/** Claim a push ticket
+ *
+ * This function can be called by several producers concurrently.
+ *
+ * @param head     [in,out] Next push ticket
+ * @param seqs     [in]     Sequence number of each slot
+ * @param capacity [in]     Capacity of the FIFO, in items
+ * @param laps     [in]     Number of laps before tickets wrap
+ * @param ticket   [out]    The claimed ticket
+ *
+ * @return `RTTrue` if a ticket has been claimed, `RTFalse` if the FIFO is full
+ */
+RTINLINE RTBool rtticketClaimPush(uint32_t* head, const uint32_t* seqs,
+        uint32_t capacity, uint32_t laps, uint32_t* ticket);
+
+
+/** Tell the consumers that the item of a push ticket has been written
+ *
+ * @param seqs     [in,out] Sequence number of each slot
+ * @param capacity [in]     Capacity of the FIFO, in items
+ * @param ticket   [in]     Ticket returned by `rtticketClaimPush()`
+ */
+RTINLINE void rtticketPublish(uint32_t* seqs, uint32_t capacity,
+        uint32_t ticket);
+
+
+/** Claim a pop ticket
+ *
+ * @param tail      [in,out] Next pop ticket
+ * @param seqs      [in]     Sequence number of each slot
+ * @param capacity  [in]     Capacity of the FIFO, in items
+ * @param laps      [in]     Number of laps before tickets wrap
+ * @param consumers [in]     `RTTrue` if there can be several consumers,
+ *                           `RTFalse` if there is only one
+ * @param ticket    [out]    The claimed ticket
+ *
+ * @return `RTTrue` if a ticket has been claimed, `RTFalse` if the FIFO is empty
+ */
+RTINLINE RTBool rtticketClaimPop(uint32_t* tail, const uint32_t* seqs,
+        uint32_t capacity, uint32_t laps, RTBool consumers, uint32_t* ticket);
+
+
+/** Tell the producers that the slot of a pop ticket is free again
+ *
+ * @param seqs     [in,out] Sequence number of each slot
+ * @param capacity [in]     Capacity of the FIFO, in items
+ * @param laps     [in]     Number of laps before tickets wrap
+ * @param ticket   [in]     Ticket returned by `rtticketClaimPop()`
+ */
+RTINLINE void rtticketRelease(uint32_t* seqs, uint32_t capacity, uint32_t laps,
+        uint32_t ticket);
+
+
+
+/*----------------------------------+
+ | Private function implementations |
+ +----------------------------------*/
+
+
+RTINLINE uint32_t rtticketNext(uint32_t capacity, uint32_t laps,
+        uint32_t ticket)
+{
+    ticket++;
+    if (ticket >= (laps * capacity)) {
+        ticket = 0;
+    }
+    return ticket;
+}
+
+
+RTINLINE uint32_t rtticketSize(const uint32_t* head, const uint32_t* tail,
+        uint32_t capacity, uint32_t laps)
+{
+    uint32_t t;
+    uint32_t h;
+    uint32_t size;
+
+    t = RTATOMIC_LOAD_ACQUIRE(tail);
+    h = RTATOMIC_LOAD_ACQUIRE(head);
+    if (h >= t) {
+        size = h - t;
+    } else {
+        size = h + (laps * capacity) - t;
+    }
+    if (size > capacity) {
+        size = capacity;
+    }
+    return size;
+}
+
+
+RTINLINE RTBool rtticketClaimPush(uint32_t* head, const uint32_t* seqs,
+        uint32_t capacity, uint32_t laps, uint32_t* ticket)
+{
+    RTBool claimed = RTFalse;
+    RTBool done = RTFalse;
+    uint32_t h;
+
+    h = RTATOMIC_LOAD_RELAXED(head);
+    while (!done) {
+        uint32_t lap = h / capacity;
+        uint32_t seq = RTATOMIC_LOAD_ACQUIRE(&seqs[h % capacity]);
+
+        if (seq == (2u * lap)) {
+            /* Slot is free for this lap => try to claim ticket `h` */
+            if (RTATOMIC_CAS(head, &h, rtticketNext(capacity, laps, h))) {
+                *ticket = h;
+                claimed = RTTrue;
+                done = RTTrue;
+            }
+            /* else: another producer took ticket `h`; `h` has been updated
+             * with the current head ticket, try again */
+
+        } else {
+            /* Either the slot still holds an item from the previous lap (FIFO
+             * is full), or another producer has already used this ticket */
+            uint32_t current = RTATOMIC_LOAD_RELAXED(head);
+            if (current == h) {
+                done = RTTrue;
+            }
+            h = current;
+        }
+    }
+    return claimed;
+}
+
+
+RTINLINE void rtticketPublish(uint32_t* seqs, uint32_t capacity,
+        uint32_t ticket)
+{
+    RTATOMIC_STORE_RELEASE(&seqs[ticket % capacity],
+            (2u * (ticket / capacity)) + 1u);
+}
+
+
+RTINLINE RTBool rtticketClaimPop(uint32_t* tail, const uint32_t* seqs,
+        uint32_t capacity, uint32_t laps, RTBool consumers, uint32_t* ticket)
+{
+    RTBool claimed = RTFalse;
+    RTBool done = RTFalse;
+    uint32_t t;
+
+    t = RTATOMIC_LOAD_RELAXED(tail);
+    while (!done) {
+        uint32_t lap = t / capacity;
+        uint32_t seq = RTATOMIC_LOAD_ACQUIRE(&seqs[t % capacity]);
+
+        if (seq != ((2u * lap) + 1u)) {
+            /* Either the slot has not been filled in yet (FIFO is empty), or
+             * another consumer has already used this ticket */
+            uint32_t current = t;
+            if (consumers) {
+                current = RTATOMIC_LOAD_RELAXED(tail);
+            }
+            if (current == t) {
+                done = RTTrue;
+            }
+            t = current;
+
+        } else if (!consumers) {
+            /* Single consumer => nobody else can take ticket `t` */
+            RTATOMIC_STORE_RELEASE(tail, rtticketNext(capacity, laps, t));
+            *ticket = t;
+            claimed = RTTrue;
+            done = RTTrue;
+
+        } else if (RTATOMIC_CAS(tail, &t, rtticketNext(capacity, laps, t))) {
+            *ticket = t;
+            claimed = RTTrue;
+            done = RTTrue;
+        }
+        /* else: another consumer took ticket `t`; `t` has been updated with
+         * the current tail ticket, try again */
+    }
+    return claimed;
+}
+
+
+RTINLINE void rtticketRelease(uint32_t* seqs, uint32_t capacity, uint32_t laps,
+        uint32_t ticket)
+{
+    uint32_t lap = ticket / capacity;
+    uint32_t seq = 0;
+
+    if ((lap + 1u) < laps) {
+        seq = 2u * (lap + 1u);
+    }
+    RTATOMIC_STORE_RELEASE(&seqs[ticket % capacity], seq);
+}
+
+
+
+#endif /* RTTICKET_PRIV_h_ */
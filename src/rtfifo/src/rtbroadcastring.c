@@ -0,0 +1,265 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "rtplf.h"
+#include "rtbroadcastring.h"
+
+
+
+/*-------------------------------+
+ | Private function declarations |
+ +-------------------------------*/
+
+
+/** Get the address of the slot designated by a sequence number
+ *
+ * @param ring [in] The ring the sequence number belongs to
+ * @param seq  [in] The sequence number
+ *
+ * @return A pointer to the slot inside `ring->buffer`
+ */
+static RTByte* rtbroadcastringSlot(const RTBroadcastRing* ring, uint32_t seq);
+
+
+/** Get the cursor of the slowest consumer
+ *
+ * @param ring      [in] The ring to query
+ * @param published [in] Current value of `ring->published`
+ *
+ * @return The cursor which is the farthest behind `published`
+ */
+static uint32_t rtbroadcastringSlowest(const RTBroadcastRing* ring,
+        uint32_t published);
+
+
+/** Get the number of items a consumer can read, refreshing its cache if needed
+ *
+ * @param ring   [in]     The ring to read from
+ * @param cursor [in,out] Cursor of the consumer
+ *
+ * @return The number of items published and not read yet by the consumer
+ */
+static uint32_t rtbroadcastringAvailable(const RTBroadcastRing* ring,
+        RTBroadcastCursor* cursor);
+
+
+
+/*---------------------------------+
+ | Public function implementations |
+ +---------------------------------*/
+
+
+void RTBroadcastRingInit(RTBroadcastRing* ring, uint16_t capacity,
+        uint16_t itemSize_B, RTByte* buffer, RTBroadcastCursor* cursors,
+        uint8_t consumerCount)
+{
+    uint8_t i;
+
+    RTASSERT(ring != NULL);
+    RTASSERT(RTIS_POW2_15(capacity));
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(buffer != NULL);
+    RTASSERT(cursors != NULL);
+    RTASSERT(consumerCount > 0);
+
+    ring->capacity = capacity;
+    ring->itemSize_B = itemSize_B;
+    ring->consumerCount = consumerCount;
+    ring->buffer = buffer;
+    ring->cursors = cursors;
+    ring->published = 0;
+    ring->gate = 0;
+    for (i = 0; i < consumerCount; i++) {
+        cursors[i].next = 0;
+        cursors[i].publishedCache = 0;
+    }
+}
+
+
+uint16_t RTBroadcastRingCapacity(const RTBroadcastRing* ring)
+{
+    RTASSERT(ring != NULL);
+    return ring->capacity;
+}
+
+
+uint8_t RTBroadcastRingConsumerCount(const RTBroadcastRing* ring)
+{
+    RTASSERT(ring != NULL);
+    return ring->consumerCount;
+}
+
+
+RTBool RTBroadcastRingPublish(RTBroadcastRing* ring, const void* item,
+        uint16_t itemSize_B)
+{
+    RTBool published = RTFalse;
+    void* slot;
+
+    RTASSERT(ring != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B <= ring->itemSize_B);
+
+    slot = RTBroadcastRingClaim(ring);
+    if (slot != NULL) {
+        RTMemcpy(slot, ring->itemSize_B, item, itemSize_B);
+        RTBroadcastRingCommit(ring);
+        published = RTTrue;
+    }
+    return published;
+}
+
+
+void* RTBroadcastRingClaim(RTBroadcastRing* ring)
+{
+    void* slot = NULL;
+    uint32_t published;
+
+    RTASSERT(ring != NULL);
+    RTASSERT(ring->buffer != NULL);
+
+    published = RTATOMIC_LOAD_RELAXED(&ring->published);
+
+    /* Only look at the consumers' cursors if the ring looks full */
+    if ((published - ring->gate) >= ring->capacity) {
+        ring->gate = rtbroadcastringSlowest(ring, published);
+    }
+
+    if ((published - ring->gate) < ring->capacity) {
+        slot = rtbroadcastringSlot(ring, published);
+    }
+    return slot;
+}
+
+
+void RTBroadcastRingCommit(RTBroadcastRing* ring)
+{
+    uint32_t published;
+
+    RTASSERT(ring != NULL);
+
+    published = RTATOMIC_LOAD_RELAXED(&ring->published);
+    RTASSERT((published - ring->gate) < ring->capacity);
+    RTATOMIC_STORE_RELEASE(&ring->published, published + 1u);
+}
+
+
+uint32_t RTBroadcastRingAvailable(const RTBroadcastRing* ring,
+        uint8_t consumer)
+{
+    const RTBroadcastCursor* cursor;
+
+    RTASSERT(ring != NULL);
+    RTASSERT(consumer < ring->consumerCount);
+
+    cursor = &(ring->cursors[consumer]);
+    return RTATOMIC_LOAD_ACQUIRE(&ring->published) - cursor->next;
+}
+
+
+RTBool RTBroadcastRingPop(RTBroadcastRing* ring, uint8_t consumer,
+        void* item, uint16_t itemSize_B)
+{
+    RTBool popped = RTFalse;
+    RTBroadcastCursor* cursor;
+
+    RTASSERT(ring != NULL);
+    RTASSERT(ring->buffer != NULL);
+    RTASSERT(consumer < ring->consumerCount);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B >= ring->itemSize_B);
+
+    cursor = &(ring->cursors[consumer]);
+    if (rtbroadcastringAvailable(ring, cursor) > 0) {
+        RTMemcpy(item, itemSize_B, rtbroadcastringSlot(ring, cursor->next),
+                ring->itemSize_B);
+        RTATOMIC_STORE_RELEASE(&cursor->next, cursor->next + 1u);
+        popped = RTTrue;
+    }
+    return popped;
+}
+
+
+uint32_t RTBroadcastRingRead(RTBroadcastRing* ring, uint8_t consumer,
+        RTBroadcastRingHandler handler, void* ctx, uint32_t maxItems)
+{
+    RTBroadcastCursor* cursor;
+    uint32_t n;
+    uint32_t i;
+
+    RTASSERT(ring != NULL);
+    RTASSERT(ring->buffer != NULL);
+    RTASSERT(consumer < ring->consumerCount);
+    RTASSERT(handler != NULL);
+
+    /* Always look at the producer's cache line, to read as much as possible */
+    cursor = &(ring->cursors[consumer]);
+    cursor->publishedCache = RTATOMIC_LOAD_ACQUIRE(&ring->published);
+    n = cursor->publishedCache - cursor->next;
+    if (maxItems < n) {
+        n = maxItems;
+    }
+    for (i = 0; i < n; i++) {
+        handler(ctx, rtbroadcastringSlot(ring, cursor->next + i));
+    }
+    if (n > 0) {
+        RTATOMIC_STORE_RELEASE(&cursor->next, cursor->next + n);
+    }
+    return n;
+}
+
+
+
+/*----------------------------------+
+ | Private function implementations |
+ +----------------------------------*/
+
+
+static RTByte* rtbroadcastringSlot(const RTBroadcastRing* ring, uint32_t seq)
+{
+    uint32_t index = seq & ((uint32_t)ring->capacity - 1u);
+    return &(ring->buffer[index * ring->itemSize_B]);
+}
+
+
+static uint32_t rtbroadcastringSlowest(const RTBroadcastRing* ring,
+        uint32_t published)
+{
+    uint32_t slowest = published;
+    uint8_t i;
+
+    for (i = 0; i < ring->consumerCount; i++) {
+        uint32_t next = RTATOMIC_LOAD_ACQUIRE(&(ring->cursors[i].next));
+        if ((published - next) > (published - slowest)) {
+            slowest = next;
+        }
+    }
+    return slowest;
+}
+
+
+static uint32_t rtbroadcastringAvailable(const RTBroadcastRing* ring,
+        RTBroadcastCursor* cursor)
+{
+    /* Only look at the producer's cache line if everything has been read */
+    if (cursor->publishedCache == cursor->next) {
+        cursor->publishedCache = RTATOMIC_LOAD_ACQUIRE(&ring->published);
+    }
+    return cursor->publishedCache - cursor->next;
+}
@@ -19,6 +19,58 @@
 
 
 
+/*-------------------------------+
+ | Private function declarations |
+ +-------------------------------*/
+
+
+/** Pass the oldest items of a FIFO to a handler, without popping them
+ *
+ * @param fifo    [in] FIFO to read from
+ * @param n       [in] Number of items to pass; must be <= the size of the FIFO
+ * @param handler [in] Function to call for each item
+ * @param ctx     [in] Passed as is to `handler`
+ */
+static void rtfifoVisit(const RTFifo* fifo, uint16_t n,
+        RTFifoHandler handler, void* ctx);
+
+
+#if RTFIFO_STATS
+/** Update the counters of a FIFO after a push operation
+ *
+ * @param stats     [in,out] Counters to update
+ * @param n         [in]     Number of items actually pushed
+ * @param requested [in]     Number of items the caller wanted to push
+ * @param size      [in]     Size of the FIFO after the push, in items
+ * @param capacity  [in]     Capacity of the FIFO, in items
+ */
+static void rtfifoStatsPush(RTFifoStats* stats, uint32_t n,
+        uint32_t requested, uint32_t size, uint32_t capacity);
+
+
+/** Update the counters of a FIFO after a pop operation
+ *
+ * @param stats     [in,out] Counters to update
+ * @param n         [in]     Number of items actually popped
+ * @param requested [in]     Number of items the caller wanted to pop
+ */
+static void rtfifoStatsPop(RTFifoStats* stats, uint32_t n,
+        uint32_t requested);
+
+
+/** Copy the counters of a FIFO, and optionally reset them
+ *
+ * @param stats [in,out] Counters of the FIFO
+ * @param copy  [out]    Where to copy the counters; may be NULL
+ * @param reset [in]     Whether to reset the counters
+ * @param size  [in]     Current size of the FIFO, in items
+ */
+static void rtfifoStatsRead(RTFifoStats* stats, RTFifoStats* copy,
+        RTBool reset, uint16_t size);
+#endif
+
+
+
 /*---------------------------------+
  | Public function implementations |
  +---------------------------------*/
@@ -37,7 +89,11 @@ void RTSmallFifoInit(RTSmallFifo* fifo, uint8_t capacity,
     fifo->size = 0;
     fifo->capacity = capacity;
     fifo->itemSize_B = itemSize_B;
+    fifo->drops = 0;
     fifo->buffer = buffer;
+#if RTFIFO_STATS
+    rtfifoStatsRead(&(fifo->stats), NULL, RTTrue, 0);
+#endif
 }
 
 
@@ -91,6 +147,10 @@ RTBool RTSmallFifoPush(RTSmallFifo* fifo, const void* item, uint8_t itemSize_B)
         fifo->size++;
         pushed = RTTrue;
     }
+#if RTFIFO_STATS
+    rtfifoStatsPush(&(fifo->stats), pushed ? 1 : 0, 1, fifo->size,
+            fifo->capacity);
+#endif
     return pushed;
 }
 
@@ -117,10 +177,146 @@ RTBool RTSmallFifoPop(RTSmallFifo* fifo, void* item, uint8_t itemSize_B)
         fifo->size--;
         popped = RTTrue;
     }
+#if RTFIFO_STATS
+    rtfifoStatsPop(&(fifo->stats), popped ? 1 : 0, 1);
+#endif
     return popped;
 }
 
 
+RTBool RTSmallFifoPushOverwrite(RTSmallFifo* fifo, const void* item,
+        uint8_t itemSize_B)
+{
+    RTBool dropped = RTFalse;
+    RTBool pushed;
+
+    /* Check the item first, so nothing is dropped if it is invalid */
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B <= fifo->itemSize_B);
+
+    if (fifo->size >= fifo->capacity) {
+        /* Drop the oldest item */
+        fifo->tail++;
+        if (fifo->tail >= fifo->capacity) {
+            fifo->tail = 0;
+        }
+        fifo->size--;
+        if (fifo->drops < 0xFFFFu) {
+            fifo->drops++;
+        }
+        dropped = RTTrue;
+    }
+    pushed = RTSmallFifoPush(fifo, item, itemSize_B);
+    RTASSERT(pushed);
+    return dropped;
+}
+
+
+uint16_t RTSmallFifoDropCount(const RTSmallFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->drops;
+}
+
+
+void RTSmallFifoResetDropCount(RTSmallFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    fifo->drops = 0;
+}
+
+
+#if RTFIFO_STATS
+void RTSmallFifoReadStats(RTSmallFifo* fifo, RTFifoStats* stats, RTBool reset)
+{
+    RTASSERT(fifo != NULL);
+    RTASSERT(stats != NULL);
+    rtfifoStatsRead(&(fifo->stats), stats, reset, fifo->size);
+}
+#endif
+
+
+uint8_t RTSmallFifoPushN(RTSmallFifo* fifo, const void* items, uint8_t count)
+{
+    const RTByte* src = items;
+    uint8_t n;
+    uint8_t first;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(items != NULL);
+
+    /* Number of items to push, and how many of those fit before the wrap */
+    n = fifo->capacity - fifo->size;
+    if (count < n) {
+        n = count;
+    }
+    first = fifo->capacity - fifo->head;
+    if (first > n) {
+        first = n;
+    }
+
+    RTMemcpy32(&(fifo->buffer[fifo->head * fifo->itemSize_B]), src,
+            (uint32_t)first * fifo->itemSize_B);
+    RTMemcpy32(fifo->buffer, &(src[first * fifo->itemSize_B]),
+            (uint32_t)(n - first) * fifo->itemSize_B);
+
+    /* Move head */
+    if (n >= (fifo->capacity - fifo->head)) {
+        fifo->head = n - (fifo->capacity - fifo->head);
+    } else {
+        fifo->head += n;
+    }
+    fifo->size += n;
+#if RTFIFO_STATS
+    rtfifoStatsPush(&(fifo->stats), n, count, fifo->size, fifo->capacity);
+#endif
+    return n;
+}
+
+
+uint8_t RTSmallFifoPopN(RTSmallFifo* fifo, void* items, uint8_t count)
+{
+    RTByte* dst = items;
+    uint8_t n;
+    uint8_t first;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(items != NULL);
+
+    /* Number of items to pop, and how many of those are before the wrap */
+    n = fifo->size;
+    if (count < n) {
+        n = count;
+    }
+    first = fifo->capacity - fifo->tail;
+    if (first > n) {
+        first = n;
+    }
+
+    RTMemcpy32(dst, &(fifo->buffer[fifo->tail * fifo->itemSize_B]),
+            (uint32_t)first * fifo->itemSize_B);
+    RTMemcpy32(&(dst[first * fifo->itemSize_B]), fifo->buffer,
+            (uint32_t)(n - first) * fifo->itemSize_B);
+
+    /* Move tail */
+    if (n >= (fifo->capacity - fifo->tail)) {
+        fifo->tail = n - (fifo->capacity - fifo->tail);
+    } else {
+        fifo->tail += n;
+    }
+    fifo->size -= n;
+#if RTFIFO_STATS
+    rtfifoStatsPop(&(fifo->stats), n, count);
+#endif
+    return n;
+}
+
+
 void RTFifoInit(RTFifo* fifo, uint16_t capacity,
         uint16_t itemSize_B, RTByte* buffer)
 {
@@ -134,7 +330,19 @@ void RTFifoInit(RTFifo* fifo, uint16_t capacity,
     fifo->size = 0;
     fifo->capacity = capacity;
     fifo->itemSize_B = itemSize_B;
+    fifo->drops = 0;
     fifo->buffer = buffer;
+    fifo->notifier = NULL;
+#if RTFIFO_STATS
+    rtfifoStatsRead(&(fifo->stats), NULL, RTTrue, 0);
+#endif
+}
+
+
+void RTFifoSetNotifier(RTFifo* fifo, RTNotifier* notifier)
+{
+    RTASSERT(fifo != NULL);
+    fifo->notifier = notifier;
 }
 
 
@@ -186,8 +394,15 @@ RTBool RTFifoPush(RTFifo* fifo, const void* item, uint16_t itemSize_B)
             fifo->head = 0;
         }
         fifo->size++;
+        if ((fifo->size == 1) && (fifo->notifier != NULL)) {
+            RTNotifierSignal(fifo->notifier);
+        }
         pushed = RTTrue;
     }
+#if RTFIFO_STATS
+    rtfifoStatsPush(&(fifo->stats), pushed ? 1 : 0, 1, fifo->size,
+            fifo->capacity);
+#endif
     return pushed;
 }
 
@@ -214,5 +429,330 @@ RTBool RTFifoPop(RTFifo* fifo, void* item, uint16_t itemSize_B)
         fifo->size--;
         popped = RTTrue;
     }
+#if RTFIFO_STATS
+    rtfifoStatsPop(&(fifo->stats), popped ? 1 : 0, 1);
+#endif
     return popped;
 }
+
+
+RTBool RTFifoPushOverwrite(RTFifo* fifo, const void* item, uint16_t itemSize_B)
+{
+    RTBool dropped = RTFalse;
+    RTBool pushed;
+
+    /* Check the item first, so nothing is dropped if it is invalid */
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B <= fifo->itemSize_B);
+
+    if (fifo->size >= fifo->capacity) {
+        /* Drop the oldest item */
+        fifo->tail++;
+        if (fifo->tail >= fifo->capacity) {
+            fifo->tail = 0;
+        }
+        fifo->size--;
+        if (fifo->drops < 0xFFFFFFFFu) {
+            fifo->drops++;
+        }
+        dropped = RTTrue;
+    }
+    pushed = RTFifoPush(fifo, item, itemSize_B);
+    RTASSERT(pushed);
+    return dropped;
+}
+
+
+uint32_t RTFifoDropCount(const RTFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->drops;
+}
+
+
+void RTFifoResetDropCount(RTFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    fifo->drops = 0;
+}
+
+
+#if RTFIFO_STATS
+void RTFifoReadStats(RTFifo* fifo, RTFifoStats* stats, RTBool reset)
+{
+    RTASSERT(fifo != NULL);
+    RTASSERT(stats != NULL);
+    rtfifoStatsRead(&(fifo->stats), stats, reset, fifo->size);
+}
+#endif
+
+
+uint16_t RTFifoPushN(RTFifo* fifo, const void* items, uint16_t count)
+{
+    const RTByte* src = items;
+    uint16_t n;
+    uint16_t first;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(items != NULL);
+
+    /* Number of items to push, and how many of those fit before the wrap */
+    n = fifo->capacity - fifo->size;
+    if (count < n) {
+        n = count;
+    }
+    first = fifo->capacity - fifo->head;
+    if (first > n) {
+        first = n;
+    }
+
+    RTMemcpy32(&(fifo->buffer[(uint32_t)fifo->head * fifo->itemSize_B]), src,
+            (uint32_t)first * fifo->itemSize_B);
+    RTMemcpy32(fifo->buffer, &(src[(uint32_t)first * fifo->itemSize_B]),
+            (uint32_t)(n - first) * fifo->itemSize_B);
+
+    /* Move head */
+    if (n >= (fifo->capacity - fifo->head)) {
+        fifo->head = n - (fifo->capacity - fifo->head);
+    } else {
+        fifo->head += n;
+    }
+    fifo->size += n;
+    if ((n > 0) && (fifo->size == n) && (fifo->notifier != NULL)) {
+        RTNotifierSignal(fifo->notifier);
+    }
+#if RTFIFO_STATS
+    rtfifoStatsPush(&(fifo->stats), n, count, fifo->size, fifo->capacity);
+#endif
+    return n;
+}
+
+
+uint16_t RTFifoPopN(RTFifo* fifo, void* items, uint16_t count)
+{
+    RTByte* dst = items;
+    uint16_t n;
+    uint16_t first;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(items != NULL);
+
+    /* Number of items to pop, and how many of those are before the wrap */
+    n = fifo->size;
+    if (count < n) {
+        n = count;
+    }
+    first = fifo->capacity - fifo->tail;
+    if (first > n) {
+        first = n;
+    }
+
+    RTMemcpy32(dst, &(fifo->buffer[(uint32_t)fifo->tail * fifo->itemSize_B]),
+            (uint32_t)first * fifo->itemSize_B);
+    RTMemcpy32(&(dst[(uint32_t)first * fifo->itemSize_B]), fifo->buffer,
+            (uint32_t)(n - first) * fifo->itemSize_B);
+
+    /* Move tail */
+    if (n >= (fifo->capacity - fifo->tail)) {
+        fifo->tail = n - (fifo->capacity - fifo->tail);
+    } else {
+        fifo->tail += n;
+    }
+    fifo->size -= n;
+#if RTFIFO_STATS
+    rtfifoStatsPop(&(fifo->stats), n, count);
+#endif
+    return n;
+}
+
+
+void* RTFifoReserve(RTFifo* fifo)
+{
+    void* slot = NULL;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+
+    if (fifo->size < fifo->capacity) {
+        slot = &(fifo->buffer[(uint32_t)fifo->head * fifo->itemSize_B]);
+    }
+#if RTFIFO_STATS
+    if (slot == NULL) {
+        rtfifoStatsPush(&(fifo->stats), 0, 1, fifo->size, fifo->capacity);
+    }
+#endif
+    return slot;
+}
+
+
+void RTFifoCommit(RTFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->size < fifo->capacity);
+
+    /* Increment head */
+    fifo->head++;
+    if (fifo->head >= fifo->capacity) {
+        fifo->head = 0;
+    }
+    fifo->size++;
+    if ((fifo->size == 1) && (fifo->notifier != NULL)) {
+        RTNotifierSignal(fifo->notifier);
+    }
+#if RTFIFO_STATS
+    rtfifoStatsPush(&(fifo->stats), 1, 1, fifo->size, fifo->capacity);
+#endif
+}
+
+
+const void* RTFifoPeek(const RTFifo* fifo)
+{
+    const void* item = NULL;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+
+    if (fifo->size > 0) {
+        item = &(fifo->buffer[(uint32_t)fifo->tail * fifo->itemSize_B]);
+    }
+    return item;
+}
+
+
+void RTFifoRelease(RTFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->size > 0);
+
+    /* Increment tail */
+    fifo->tail++;
+    if (fifo->tail >= fifo->capacity) {
+        fifo->tail = 0;
+    }
+    fifo->size--;
+#if RTFIFO_STATS
+    rtfifoStatsPop(&(fifo->stats), 1, 1);
+#endif
+}
+
+
+uint16_t RTFifoDrain(RTFifo* fifo, RTFifoHandler handler, void* ctx,
+        uint16_t maxItems)
+{
+    uint16_t n;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(handler != NULL);
+
+    n = fifo->size;
+    if (maxItems < n) {
+        n = maxItems;
+    }
+    rtfifoVisit(fifo, n, handler, ctx);
+
+    /* Move tail */
+    if (n >= (fifo->capacity - fifo->tail)) {
+        fifo->tail = n - (fifo->capacity - fifo->tail);
+    } else {
+        fifo->tail += n;
+    }
+    fifo->size -= n;
+#if RTFIFO_STATS
+    /* Only draining an empty FIFO counts as a failed pop */
+    rtfifoStatsPop(&(fifo->stats), n, (maxItems > 0) ? 1 : 0);
+#endif
+    return n;
+}
+
+
+uint16_t RTFifoForEach(const RTFifo* fifo, RTFifoHandler handler, void* ctx)
+{
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(handler != NULL);
+
+    rtfifoVisit(fifo, fifo->size, handler, ctx);
+    return fifo->size;
+}
+
+
+
+/*----------------------------------+
+ | Private function implementations |
+ +----------------------------------*/
+
+
+static void rtfifoVisit(const RTFifo* fifo, uint16_t n,
+        RTFifoHandler handler, void* ctx)
+{
+    const RTByte* item;
+    const RTByte* end;
+    uint16_t i;
+
+    item = &(fifo->buffer[(uint32_t)fifo->tail * fifo->itemSize_B]);
+    end = &(fifo->buffer[(uint32_t)fifo->capacity * fifo->itemSize_B]);
+
+    /* Walk the buffer with a pointer, wrapping it once at most */
+    for (i = 0; i < n; i++) {
+        handler(ctx, item);
+        item += fifo->itemSize_B;
+        if (item >= end) {
+            item = fifo->buffer;
+        }
+    }
+}
+
+
+#if RTFIFO_STATS
+static void rtfifoStatsPush(RTFifoStats* stats, uint32_t n,
+        uint32_t requested, uint32_t size, uint32_t capacity)
+{
+    stats->pushes += n;
+    if (n < requested) {
+        stats->pushFailures++;
+    }
+    if (n > 0) {
+        if (size > stats->highWatermark) {
+            stats->highWatermark = (uint16_t)size;
+        }
+        stats->histogram[((size * RTFIFO_STATS_BINS) - 1) / capacity]++;
+    }
+}
+
+
+static void rtfifoStatsPop(RTFifoStats* stats, uint32_t n,
+        uint32_t requested)
+{
+    stats->pops += n;
+    if (n < requested) {
+        stats->popFailures++;
+    }
+}
+
+
+static void rtfifoStatsRead(RTFifoStats* stats, RTFifoStats* copy,
+        RTBool reset, uint16_t size)
+{
+    int i;
+
+    if (copy != NULL) {
+        *copy = *stats;
+    }
+    if (reset) {
+        stats->pushes = 0;
+        stats->pops = 0;
+        stats->pushFailures = 0;
+        stats->popFailures = 0;
+        stats->highWatermark = size;
+        for (i = 0; i < RTFIFO_STATS_BINS; i++) {
+            stats->histogram[i] = 0;
+        }
+    }
+}
+#endif
@@ -0,0 +1,289 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtplf.h"
+#include "rtjournalfifo.h"
+
+
+
+/*-------------------------------+
+ | Private function declarations |
+ +-------------------------------*/
+
+
+/** Increment a ticket, wrapping around after `fifo->laps` laps
+ *
+ * @param fifo   [in] The FIFO the ticket belongs to
+ * @param ticket [in] The ticket to increment
+ *
+ * @return The incremented ticket
+ */
+static uint32_t rtjournalfifoNext(const RTJournalFifo* fifo, uint32_t ticket);
+
+
+/** Count the tickets from `from` (included) to `to` (excluded)
+ *
+ * @param fifo [in] The FIFO the tickets belong to
+ * @param from [in] First ticket
+ * @param to   [in] Last ticket
+ *
+ * @return The number of tickets between `from` and `to`
+ */
+static uint32_t rtjournalfifoDistance(const RTJournalFifo* fifo,
+        uint32_t from, uint32_t to);
+
+
+/** Sync the items pushed since the last commit
+ *
+ * @param fifo [in] The FIFO to sync
+ *
+ * @return `RTTrue` if success, `RTFalse` if the items could not be written
+ */
+static RTBool rtjournalfifoSyncItems(const RTJournalFifo* fifo);
+
+
+
+/*---------------------------------+
+ | Public function implementations |
+ +---------------------------------*/
+
+
+RTBool RTJournalFifoOpen(RTJournalFifo* fifo, const char* path,
+        uint32_t capacity, uint16_t itemSize_B)
+{
+    RTBool ok = RTFalse;
+    struct RTJournalFifoHeader* header;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(path != NULL);
+    RTASSERT(capacity > 0);
+    RTASSERT(capacity <= RTPRIV_JOURNAL_FIFO_MAX_CAPACITY);
+    RTASSERT(itemSize_B > 0);
+
+    fifo->capacity = capacity;
+    fifo->itemSize_B = itemSize_B;
+    fifo->laps = RTPRIV_JOURNAL_FIFO_LAPS(capacity);
+    if (RTMappedFileOpen(&fifo->file, path, RTPRIV_JOURNAL_FIFO_BUFFER_OFFSET
+                + ((size_t)capacity * itemSize_B))) {
+        header = (struct RTJournalFifoHeader*)fifo->file.addr;
+        if (fifo->file.created) {
+            /* New journal file: the magic number is written last, so a crash
+             * while creating the journal never leaves a journal which looks
+             * valid; such a file must be deleted before trying again */
+            header->capacity = capacity;
+            header->itemSize_B = itemSize_B;
+            header->head = 0;
+            header->tail = 0;
+            if (RTMappedFileSync(&fifo->file, 0, sizeof(*header))) {
+                header->magic = RTPRIV_JOURNAL_FIFO_MAGIC;
+                ok = RTMappedFileSync(&fifo->file, 0, sizeof(*header));
+            }
+
+        } else if ((fifo->file.size_B >= (RTPRIV_JOURNAL_FIFO_BUFFER_OFFSET
+                        + ((size_t)capacity * itemSize_B)))
+                && (header->magic == RTPRIV_JOURNAL_FIFO_MAGIC)
+                && (header->capacity == capacity)
+                && (header->itemSize_B == itemSize_B)
+                && (header->head < (fifo->laps * capacity))
+                && (header->tail < (fifo->laps * capacity))
+                && (rtjournalfifoDistance(fifo, header->tail, header->head)
+                    <= capacity)) {
+            ok = RTTrue;
+        }
+
+        if (ok) {
+            fifo->header = header;
+            fifo->buffer = fifo->file.addr + RTPRIV_JOURNAL_FIFO_BUFFER_OFFSET;
+            fifo->head = header->head;
+            fifo->tail = header->tail;
+            fifo->committedHead = header->head;
+            fifo->committedTail = header->tail;
+        } else {
+            RTMappedFileClose(&fifo->file);
+        }
+    }
+    return ok;
+}
+
+
+void RTJournalFifoClose(RTJournalFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+
+    RTMappedFileClose(&fifo->file);
+    fifo->header = NULL;
+    fifo->buffer = NULL;
+}
+
+
+uint32_t RTJournalFifoSize(const RTJournalFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return rtjournalfifoDistance(fifo, fifo->tail, fifo->head);
+}
+
+
+uint32_t RTJournalFifoCapacity(const RTJournalFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->capacity;
+}
+
+
+RTBool RTJournalFifoIsEmpty(const RTJournalFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->head == fifo->tail;
+}
+
+
+RTBool RTJournalFifoIsFull(const RTJournalFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return rtjournalfifoDistance(fifo, fifo->committedTail, fifo->head)
+        >= fifo->capacity;
+}
+
+
+RTBool RTJournalFifoPush(RTJournalFifo* fifo, const void* item,
+        uint16_t itemSize_B)
+{
+    RTBool pushed = RTFalse;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B <= fifo->itemSize_B);
+
+    if (!RTJournalFifoIsFull(fifo)) {
+        uint32_t index = fifo->head % fifo->capacity;
+        RTMemcpy(&(fifo->buffer[(size_t)index * fifo->itemSize_B]),
+                fifo->itemSize_B, item, itemSize_B);
+        fifo->head = rtjournalfifoNext(fifo, fifo->head);
+        pushed = RTTrue;
+    }
+    return pushed;
+}
+
+
+RTBool RTJournalFifoPop(RTJournalFifo* fifo, void* item, uint16_t itemSize_B)
+{
+    RTBool popped = RTFalse;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B >= fifo->itemSize_B);
+
+    if (!RTJournalFifoIsEmpty(fifo)) {
+        uint32_t index = fifo->tail % fifo->capacity;
+        RTMemcpy(item, itemSize_B,
+                &(fifo->buffer[(size_t)index * fifo->itemSize_B]),
+                fifo->itemSize_B);
+        fifo->tail = rtjournalfifoNext(fifo, fifo->tail);
+        popped = RTTrue;
+    }
+    return popped;
+}
+
+
+RTBool RTJournalFifoCommit(RTJournalFifo* fifo)
+{
+    RTBool ok = RTTrue;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->header != NULL);
+
+    if ((fifo->head != fifo->committedHead)
+            || (fifo->tail != fifo->committedTail)) {
+        /* The items must be durable before the head that points past them */
+        ok = rtjournalfifoSyncItems(fifo);
+        if (ok) {
+            fifo->header->head = fifo->head;
+            fifo->header->tail = fifo->tail;
+            ok = RTMappedFileSync(&fifo->file, 0, sizeof(*(fifo->header)));
+        }
+        if (ok) {
+            fifo->committedHead = fifo->head;
+            fifo->committedTail = fifo->tail;
+        } else {
+            /* Keep the header as of the previous commit, so the slots of
+             * uncommitted pops are not reused */
+            fifo->header->head = fifo->committedHead;
+            fifo->header->tail = fifo->committedTail;
+        }
+    }
+    return ok;
+}
+
+
+
+/*----------------------------------+
+ | Private function implementations |
+ +----------------------------------*/
+
+
+static uint32_t rtjournalfifoNext(const RTJournalFifo* fifo, uint32_t ticket)
+{
+    ticket++;
+    if (ticket >= (fifo->laps * fifo->capacity)) {
+        ticket = 0;
+    }
+    return ticket;
+}
+
+
+static uint32_t rtjournalfifoDistance(const RTJournalFifo* fifo,
+        uint32_t from, uint32_t to)
+{
+    uint32_t distance;
+    if (to >= from) {
+        distance = to - from;
+    } else {
+        distance = to + (fifo->laps * fifo->capacity) - from;
+    }
+    return distance;
+}
+
+
+static RTBool rtjournalfifoSyncItems(const RTJournalFifo* fifo)
+{
+    RTBool ok = RTTrue;
+    uint32_t count;
+    uint32_t first;
+
+    count = rtjournalfifoDistance(fifo, fifo->committedHead, fifo->head);
+    if (count > 0) {
+        first = fifo->committedHead % fifo->capacity;
+        if ((first + count) > fifo->capacity) {
+            /* The new items wrap around the end of the buffer */
+            ok = RTMappedFileSync(&fifo->file,
+                    RTPRIV_JOURNAL_FIFO_BUFFER_OFFSET,
+                    (size_t)(first + count - fifo->capacity)
+                        * fifo->itemSize_B);
+            count = fifo->capacity - first;
+        }
+        if (ok) {
+            ok = RTMappedFileSync(&fifo->file,
+                    RTPRIV_JOURNAL_FIFO_BUFFER_OFFSET
+                        + ((size_t)first * fifo->itemSize_B),
+                    (size_t)count * fifo->itemSize_B);
+        }
+    }
+    return ok;
+}
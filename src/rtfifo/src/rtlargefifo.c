@@ -0,0 +1,121 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtplf.h"
+#include "rtlargefifo.h"
+
+
+
+/*---------------------------------+
+ | Public function implementations |
+ +---------------------------------*/
+
+
+void RTLargeFifoInit(RTLargeFifo* fifo, size_t capacity, size_t itemSize_B,
+        RTByte* buffer)
+{
+    RTASSERT(fifo != NULL);
+    RTASSERT(capacity > 0);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(capacity <= (((size_t)-1) / itemSize_B));
+    RTASSERT(buffer != NULL);
+
+    fifo->head = 0;
+    fifo->tail = 0;
+    fifo->size = 0;
+    fifo->capacity = capacity;
+    fifo->itemSize_B = itemSize_B;
+    fifo->buffer = buffer;
+}
+
+
+size_t RTLargeFifoSize(const RTLargeFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->size;
+}
+
+
+size_t RTLargeFifoCapacity(const RTLargeFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->capacity;
+}
+
+
+RTBool RTLargeFifoIsEmpty(const RTLargeFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->size == 0;
+}
+
+
+RTBool RTLargeFifoIsFull(const RTLargeFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->size >= fifo->capacity;
+}
+
+
+RTBool RTLargeFifoPush(RTLargeFifo* fifo, const void* item, size_t itemSize_B)
+{
+    RTBool pushed = RTFalse;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B <= fifo->itemSize_B);
+
+    if (fifo->size < fifo->capacity) {
+        RTByte* dst = &(fifo->buffer[fifo->head * fifo->itemSize_B]);
+        RTMemcpyLarge(dst, item, itemSize_B);
+
+        /* Increment head */
+        fifo->head++;
+        if (fifo->head >= fifo->capacity) {
+            fifo->head = 0;
+        }
+        fifo->size++;
+        pushed = RTTrue;
+    }
+    return pushed;
+}
+
+
+RTBool RTLargeFifoPop(RTLargeFifo* fifo, void* item, size_t itemSize_B)
+{
+    RTBool popped = RTFalse;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B >= fifo->itemSize_B);
+
+    if (fifo->size > 0) {
+        const RTByte* src = &(fifo->buffer[fifo->tail * fifo->itemSize_B]);
+        RTMemcpyLarge(item, src, fifo->itemSize_B);
+
+        /* Increment tail */
+        fifo->tail++;
+        if (fifo->tail >= fifo->capacity) {
+            fifo->tail = 0;
+        }
+        fifo->size--;
+        popped = RTTrue;
+    }
+    return popped;
+}
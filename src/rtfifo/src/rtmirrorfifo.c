@@ -0,0 +1,122 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtplf.h"
+#include "rtmirrorfifo.h"
+
+
+
+/*---------------------------------+
+ | Public function implementations |
+ +---------------------------------*/
+
+
+RTBool RTMirrorFifoCreate(RTMirrorFifo* fifo, size_t minCapacity_B)
+{
+    RTASSERT(fifo != NULL);
+    RTASSERT(minCapacity_B > 0);
+
+    fifo->head = 0;
+    fifo->tail = 0;
+    return RTMirrorCreate(&fifo->mirror, minCapacity_B);
+}
+
+
+void RTMirrorFifoDestroy(RTMirrorFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    RTMirrorDestroy(&fifo->mirror);
+}
+
+
+size_t RTMirrorFifoSize(const RTMirrorFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->head - fifo->tail;
+}
+
+
+size_t RTMirrorFifoCapacity(const RTMirrorFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->mirror.size_B;
+}
+
+
+size_t RTMirrorFifoWrite(RTMirrorFifo* fifo, const void* data, size_t size_B)
+{
+    size_t span_B;
+    RTByte* dst = RTMirrorFifoReserve(fifo, &span_B);
+
+    if (size_B < span_B) {
+        span_B = size_B;
+    }
+    RTMemcpyLarge(dst, data, span_B);
+    RTMirrorFifoCommit(fifo, span_B);
+    return span_B;
+}
+
+
+size_t RTMirrorFifoRead(RTMirrorFifo* fifo, void* data, size_t size_B)
+{
+    size_t span_B;
+    const RTByte* src = RTMirrorFifoPeek(fifo, &span_B);
+
+    if (size_B < span_B) {
+        span_B = size_B;
+    }
+    RTMemcpyLarge(data, src, span_B);
+    RTMirrorFifoRelease(fifo, span_B);
+    return span_B;
+}
+
+
+RTByte* RTMirrorFifoReserve(RTMirrorFifo* fifo, size_t* span_B)
+{
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->mirror.addr != NULL);
+    RTASSERT(span_B != NULL);
+
+    *span_B = fifo->mirror.size_B - (fifo->head - fifo->tail);
+    return &(fifo->mirror.addr[fifo->head % fifo->mirror.size_B]);
+}
+
+
+void RTMirrorFifoCommit(RTMirrorFifo* fifo, size_t size_B)
+{
+    RTASSERT(fifo != NULL);
+    RTASSERT(size_B <= (fifo->mirror.size_B - (fifo->head - fifo->tail)));
+    fifo->head += size_B;
+}
+
+
+const RTByte* RTMirrorFifoPeek(const RTMirrorFifo* fifo, size_t* span_B)
+{
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->mirror.addr != NULL);
+    RTASSERT(span_B != NULL);
+
+    *span_B = fifo->head - fifo->tail;
+    return &(fifo->mirror.addr[fifo->tail % fifo->mirror.size_B]);
+}
+
+
+void RTMirrorFifoRelease(RTMirrorFifo* fifo, size_t size_B)
+{
+    RTASSERT(fifo != NULL);
+    RTASSERT(size_B <= (fifo->head - fifo->tail));
+    fifo->tail += size_B;
+}
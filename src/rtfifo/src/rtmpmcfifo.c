@@ -0,0 +1,245 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtplf.h"
+#include "rtmpmcfifo.h"
+#include "rtticket_priv.h"
+
+
+
+/*-------------------------------+
+ | Private function declarations |
+ +-------------------------------*/
+
+
+/** Wake up the threads blocked on `epoch`, if there are any
+ *
+ * This costs a fence and a relaxed load, but no system call, when no thread
+ * is blocked.
+ *
+ * @param epoch   [in,out] Word the threads are waiting on
+ * @param waiters [in]     Number of threads waiting on `epoch`
+ */
+static void rtmpmcfifoWake(uint32_t* epoch, const uint32_t* waiters);
+
+
+/** Block until `*epoch` changes or the timeout expires
+ *
+ * @param epoch      [in] Word to wait on
+ * @param value      [in] Value of `*epoch` before checking the FIFO
+ * @param start_us   [in] When the caller started waiting, from `RTNow_us()`
+ * @param timeout_ms [in] Timeout, from `start_us`; may be `RTWAIT_FOREVER`
+ *
+ * @return `RTFalse` if the timeout has expired, `RTTrue` otherwise
+ */
+static RTBool rtmpmcfifoPark(const uint32_t* epoch, uint32_t value,
+        uint32_t start_us, uint32_t timeout_ms);
+
+
+
+/*---------------------------------+
+ | Public function implementations |
+ +---------------------------------*/
+
+
+void RTMpmcFifoInit(RTMpmcFifo* fifo, uint16_t capacity,
+        uint16_t itemSize_B, RTByte* buffer, uint32_t* seqs)
+{
+    uint16_t i;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(capacity > 0);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(buffer != NULL);
+    RTASSERT(seqs != NULL);
+
+    fifo->capacity = capacity;
+    fifo->itemSize_B = itemSize_B;
+    fifo->laps = RTPRIV_MPMC_FIFO_LAPS(capacity);
+    fifo->buffer = buffer;
+    fifo->seqs = seqs;
+    fifo->head = 0;
+    fifo->tail = 0;
+    fifo->popEpoch = 0;
+    fifo->popWaiters = 0;
+    fifo->pushEpoch = 0;
+    fifo->pushWaiters = 0;
+    for (i = 0; i < capacity; i++) {
+        seqs[i] = 0;
+    }
+}
+
+
+uint16_t RTMpmcFifoSize(const RTMpmcFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return (uint16_t)rtticketSize(&fifo->head, &fifo->tail, fifo->capacity,
+            fifo->laps);
+}
+
+
+uint16_t RTMpmcFifoCapacity(const RTMpmcFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->capacity;
+}
+
+
+RTBool RTMpmcFifoIsEmpty(const RTMpmcFifo* fifo)
+{
+    return RTMpmcFifoSize(fifo) == 0;
+}
+
+
+RTBool RTMpmcFifoIsFull(const RTMpmcFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return RTMpmcFifoSize(fifo) >= fifo->capacity;
+}
+
+
+RTBool RTMpmcFifoPush(RTMpmcFifo* fifo, const void* item, uint16_t itemSize_B)
+{
+    RTBool pushed;
+    uint32_t ticket;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B <= fifo->itemSize_B);
+
+    pushed = rtticketClaimPush(&fifo->head, fifo->seqs, fifo->capacity,
+            fifo->laps, &ticket);
+    if (pushed) {
+        RTMemcpy(&(fifo->buffer[(ticket % fifo->capacity) * fifo->itemSize_B]),
+                fifo->itemSize_B, item, itemSize_B);
+        rtticketPublish(fifo->seqs, fifo->capacity, ticket);
+        rtmpmcfifoWake(&fifo->popEpoch, &fifo->popWaiters);
+    }
+    return pushed;
+}
+
+
+RTBool RTMpmcFifoPop(RTMpmcFifo* fifo, void* item, uint16_t itemSize_B)
+{
+    RTBool popped;
+    uint32_t ticket;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B >= fifo->itemSize_B);
+
+    popped = rtticketClaimPop(&fifo->tail, fifo->seqs, fifo->capacity,
+            fifo->laps, RTTrue, &ticket);
+    if (popped) {
+        RTMemcpy(item, itemSize_B,
+                &(fifo->buffer[(ticket % fifo->capacity) * fifo->itemSize_B]),
+                fifo->itemSize_B);
+        rtticketRelease(fifo->seqs, fifo->capacity, fifo->laps, ticket);
+        rtmpmcfifoWake(&fifo->pushEpoch, &fifo->pushWaiters);
+    }
+    return popped;
+}
+
+
+RTBool RTMpmcFifoPushWait(RTMpmcFifo* fifo, const void* item,
+        uint16_t itemSize_B, uint32_t timeout_ms)
+{
+    RTBool pushed = RTMpmcFifoPush(fifo, item, itemSize_B);
+
+    if (!pushed && (timeout_ms > 0)) {
+        uint32_t start_us = RTNow_us();
+        RTBool expired = RTFalse;
+        while (!pushed && !expired) {
+            uint32_t epoch = RTATOMIC_LOAD_ACQUIRE(&fifo->pushEpoch);
+            (void)RTATOMIC_FETCH_ADD(&fifo->pushWaiters, 1u);
+            /* Re-check after registering as a waiter, so a pop that happens
+             * from now on will wake us up */
+            pushed = RTMpmcFifoPush(fifo, item, itemSize_B);
+            if (!pushed) {
+                expired = !rtmpmcfifoPark(&fifo->pushEpoch, epoch, start_us,
+                        timeout_ms);
+            }
+            (void)RTATOMIC_FETCH_SUB(&fifo->pushWaiters, 1u);
+        }
+    }
+    return pushed;
+}
+
+
+RTBool RTMpmcFifoPopWait(RTMpmcFifo* fifo, void* item, uint16_t itemSize_B,
+        uint32_t timeout_ms)
+{
+    RTBool popped = RTMpmcFifoPop(fifo, item, itemSize_B);
+
+    if (!popped && (timeout_ms > 0)) {
+        uint32_t start_us = RTNow_us();
+        RTBool expired = RTFalse;
+        while (!popped && !expired) {
+            uint32_t epoch = RTATOMIC_LOAD_ACQUIRE(&fifo->popEpoch);
+            (void)RTATOMIC_FETCH_ADD(&fifo->popWaiters, 1u);
+            /* Re-check after registering as a waiter, so a push that happens
+             * from now on will wake us up */
+            popped = RTMpmcFifoPop(fifo, item, itemSize_B);
+            if (!popped) {
+                expired = !rtmpmcfifoPark(&fifo->popEpoch, epoch, start_us,
+                        timeout_ms);
+            }
+            (void)RTATOMIC_FETCH_SUB(&fifo->popWaiters, 1u);
+        }
+    }
+    return popped;
+}
+
+
+
+/*----------------------------------+
+ | Private function implementations |
+ +----------------------------------*/
+
+
+static void rtmpmcfifoWake(uint32_t* epoch, const uint32_t* waiters)
+{
+    /* Order the publication of the slot before the read of `waiters`; this
+     * pairs with the increment of `waiters` by a thread about to block */
+    RTATOMIC_FENCE();
+    if (RTATOMIC_LOAD_RELAXED(waiters) > 0) {
+        (void)RTATOMIC_FETCH_ADD(epoch, 1u);
+        RTWake(epoch);
+    }
+}
+
+
+static RTBool rtmpmcfifoPark(const uint32_t* epoch, uint32_t value,
+        uint32_t start_us, uint32_t timeout_ms)
+{
+    RTBool inTime = RTTrue;
+
+    if (timeout_ms == RTWAIT_FOREVER) {
+        (void)RTWait(epoch, value, RTWAIT_FOREVER);
+    } else {
+        uint32_t elapsed_ms = (RTNow_us() - start_us) / 1000u;
+        if (elapsed_ms >= timeout_ms) {
+            inTime = RTFalse;
+        } else {
+            (void)RTWait(epoch, value, timeout_ms - elapsed_ms);
+        }
+    }
+    return inTime;
+}
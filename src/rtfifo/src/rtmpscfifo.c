@@ -0,0 +1,124 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtplf.h"
+#include "rtmpscfifo.h"
+#include "rtticket_priv.h"
+
+
+
+/*---------------------------------+
+ | Public function implementations |
+ +---------------------------------*/
+
+
+void RTMpscFifoInit(RTMpscFifo* fifo, uint16_t capacity,
+        uint16_t itemSize_B, RTByte* buffer, uint32_t* seqs)
+{
+    uint16_t i;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(capacity > 0);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(buffer != NULL);
+    RTASSERT(seqs != NULL);
+
+    fifo->capacity = capacity;
+    fifo->itemSize_B = itemSize_B;
+    fifo->laps = RTPRIV_MPSC_FIFO_LAPS(capacity);
+    fifo->buffer = buffer;
+    fifo->seqs = seqs;
+    fifo->head = 0;
+    fifo->tail = 0;
+    for (i = 0; i < capacity; i++) {
+        seqs[i] = 0;
+    }
+}
+
+
+uint16_t RTMpscFifoSize(const RTMpscFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return (uint16_t)rtticketSize(&fifo->head, &fifo->tail, fifo->capacity,
+            fifo->laps);
+}
+
+
+uint16_t RTMpscFifoCapacity(const RTMpscFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->capacity;
+}
+
+
+RTBool RTMpscFifoIsEmpty(const RTMpscFifo* fifo)
+{
+    return RTMpscFifoSize(fifo) == 0;
+}
+
+
+RTBool RTMpscFifoIsFull(const RTMpscFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return RTMpscFifoSize(fifo) >= fifo->capacity;
+}
+
+
+RTBool RTMpscFifoPush(RTMpscFifo* fifo, const void* item, uint16_t itemSize_B)
+{
+    RTBool pushed;
+    uint32_t ticket;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B <= fifo->itemSize_B);
+
+    pushed = rtticketClaimPush(&fifo->head, fifo->seqs, fifo->capacity,
+            fifo->laps, &ticket);
+    if (pushed) {
+        RTMemcpy(&(fifo->buffer[(ticket % fifo->capacity) * fifo->itemSize_B]),
+                fifo->itemSize_B, item, itemSize_B);
+        rtticketPublish(fifo->seqs, fifo->capacity, ticket);
+    }
+    return pushed;
+}
+
+
+RTBool RTMpscFifoPop(RTMpscFifo* fifo, void* item, uint16_t itemSize_B)
+{
+    RTBool popped;
+    uint32_t ticket;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B >= fifo->itemSize_B);
+
+    popped = rtticketClaimPop(&fifo->tail, fifo->seqs, fifo->capacity,
+            fifo->laps, RTFalse, &ticket);
+    if (popped) {
+        RTMemcpy(item, itemSize_B,
+                &(fifo->buffer[(ticket % fifo->capacity) * fifo->itemSize_B]),
+                fifo->itemSize_B);
+        rtticketRelease(fifo->seqs, fifo->capacity, fifo->laps, ticket);
+    }
+    return popped;
+}
+
+
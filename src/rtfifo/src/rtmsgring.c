@@ -0,0 +1,274 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtplf.h"
+#include "rtmsgring.h"
+
+
+
+/*-------------------------------+
+ | Private function declarations |
+ +-------------------------------*/
+
+
+/** Compute the size of the record that holds a message
+ *
+ * @param size_B [in] Size of the message, in bytes
+ *
+ * @return The size of the record, in bytes, including header and padding
+ */
+static uint32_t rtmsgringRecordSize(uint16_t size_B);
+
+
+/** Access the header at the given offset
+ *
+ * @param ring   [in] The message ring
+ * @param offset [in] Offset of the header in the buffer; must be 4-byte aligned
+ *
+ * @return A pointer to the header
+ */
+static uint32_t* rtmsgringHeader(const RTMsgRing* ring, uint32_t offset);
+
+
+/** Get the offset of the oldest record, skipping any wrap marker
+ *
+ * @param ring [in] The message ring; must not be empty
+ *
+ * @return Offset of the header of the oldest message
+ */
+static uint32_t rtmsgringTail(const RTMsgRing* ring);
+
+
+
+/*---------------------------------+
+ | Public function implementations |
+ +---------------------------------*/
+
+
+void RTMsgRingInit(RTMsgRing* ring, RTByte* buffer, uint32_t capacity_B)
+{
+    RTASSERT(ring != NULL);
+    RTASSERT(buffer != NULL);
+    RTASSERT(((uintptr_t)buffer % RTPRIV_MSG_RING_HEADER_B) == 0);
+    RTASSERT(capacity_B > 0);
+    RTASSERT((capacity_B % RTPRIV_MSG_RING_HEADER_B) == 0);
+
+    ring->capacity_B = capacity_B;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->used_B = 0;
+    ring->count = 0;
+    ring->buffer = buffer;
+}
+
+
+uint32_t RTMsgRingCount(const RTMsgRing* ring)
+{
+    RTASSERT(ring != NULL);
+    return ring->count;
+}
+
+
+RTBool RTMsgRingIsEmpty(const RTMsgRing* ring)
+{
+    RTASSERT(ring != NULL);
+    return ring->count == 0;
+}
+
+
+RTBool RTMsgRingPush(RTMsgRing* ring, const void* msg, uint16_t size_B)
+{
+    RTBool pushed = RTFalse;
+    uint32_t record_B;
+    uint32_t skip_B = 0;
+    uint32_t offset = 0;
+
+    RTASSERT(ring != NULL);
+    RTASSERT(ring->buffer != NULL);
+    RTASSERT(msg != NULL);
+    RTASSERT(size_B > 0);
+
+    record_B = rtmsgringRecordSize(size_B);
+    if (ring->count == 0) {
+        /* Ring is empty => start again from the beginning of the buffer */
+        ring->head = 0;
+        ring->tail = 0;
+        ring->used_B = 0;
+    }
+
+    if (ring->used_B >= ring->capacity_B) {
+        /* Ring is full */
+    } else if (ring->head >= ring->tail) {
+        /* Free space is from head to the end of the buffer, then from the
+         * beginning of the buffer to tail */
+        uint32_t end_B = ring->capacity_B - ring->head;
+        if (record_B <= end_B) {
+            offset = ring->head;
+            pushed = RTTrue;
+        } else if (record_B <= ring->tail) {
+            skip_B = end_B;
+            offset = 0;
+            pushed = RTTrue;
+        }
+    } else if (record_B <= (ring->tail - ring->head)) {
+        offset = ring->head;
+        pushed = RTTrue;
+    }
+
+    if (pushed) {
+        if (skip_B > 0) {
+            *rtmsgringHeader(ring, ring->head) = RTPRIV_MSG_RING_WRAP;
+        }
+        *rtmsgringHeader(ring, offset) = size_B;
+        RTMemcpy(&(ring->buffer[offset + RTPRIV_MSG_RING_HEADER_B]), size_B,
+                msg, size_B);
+        ring->head = offset + record_B;
+        if (ring->head >= ring->capacity_B) {
+            ring->head = 0;
+        }
+        ring->used_B += skip_B + record_B;
+        ring->count++;
+    }
+    return pushed;
+}
+
+
+uint16_t RTMsgRingNextSize(const RTMsgRing* ring)
+{
+    uint16_t size_B = 0;
+
+    RTASSERT(ring != NULL);
+
+    if (ring->count > 0) {
+        size_B = (uint16_t)*rtmsgringHeader(ring, rtmsgringTail(ring));
+    }
+    return size_B;
+}
+
+
+uint16_t RTMsgRingPop(RTMsgRing* ring, void* msg, uint16_t msgSize_B)
+{
+    uint16_t size_B = 0;
+    const void* src;
+
+    RTASSERT(ring != NULL);
+    RTASSERT(msg != NULL);
+
+    src = RTMsgRingPeek(ring, &size_B);
+    if (src != NULL) {
+        RTASSERT(msgSize_B >= size_B);
+        RTMemcpy(msg, msgSize_B, src, size_B);
+        RTMsgRingRelease(ring);
+    }
+    return size_B;
+}
+
+
+const void* RTMsgRingPeek(const RTMsgRing* ring, uint16_t* size_B)
+{
+    const void* msg = NULL;
+    uint16_t msgSize_B = 0;
+
+    RTASSERT(ring != NULL);
+    RTASSERT(ring->buffer != NULL);
+
+    if (ring->count > 0) {
+        uint32_t tail = rtmsgringTail(ring);
+        msgSize_B = (uint16_t)*rtmsgringHeader(ring, tail);
+        msg = &(ring->buffer[tail + RTPRIV_MSG_RING_HEADER_B]);
+    }
+    if (size_B != NULL) {
+        *size_B = msgSize_B;
+    }
+    return msg;
+}
+
+
+void RTMsgRingRelease(RTMsgRing* ring)
+{
+    uint32_t tail;
+    uint32_t record_B;
+
+    RTASSERT(ring != NULL);
+    RTASSERT(ring->count > 0);
+
+    tail = rtmsgringTail(ring);
+    if (tail != ring->tail) {
+        /* Skip the wrap marker */
+        ring->used_B -= ring->capacity_B - ring->tail;
+    }
+    record_B = rtmsgringRecordSize((uint16_t)*rtmsgringHeader(ring, tail));
+    ring->tail = tail + record_B;
+    if (ring->tail >= ring->capacity_B) {
+        ring->tail = 0;
+    }
+    ring->used_B -= record_B;
+    ring->count--;
+}
+
+
+uint32_t RTMsgRingDrain(RTMsgRing* ring, RTMsgRingHandler handler, void* ctx,
+        uint32_t maxMsgs)
+{
+    uint32_t n = 0;
+    RTBool done = RTFalse;
+
+    RTASSERT(ring != NULL);
+    RTASSERT(handler != NULL);
+
+    while (!done && (n < maxMsgs)) {
+        uint16_t size_B;
+        const void* msg = RTMsgRingPeek(ring, &size_B);
+        if (msg != NULL) {
+            handler(ctx, msg, size_B);
+            RTMsgRingRelease(ring);
+            n++;
+        } else {
+            done = RTTrue;
+        }
+    }
+    return n;
+}
+
+
+
+/*----------------------------------+
+ | Private function implementations |
+ +----------------------------------*/
+
+
+static uint32_t rtmsgringRecordSize(uint16_t size_B)
+{
+    uint32_t padded_B = ((uint32_t)size_B + RTPRIV_MSG_RING_HEADER_B - 1u)
+            & ~(RTPRIV_MSG_RING_HEADER_B - 1u);
+    return RTPRIV_MSG_RING_HEADER_B + padded_B;
+}
+
+
+static uint32_t* rtmsgringHeader(const RTMsgRing* ring, uint32_t offset)
+{
+    return (uint32_t*)(void*)&(ring->buffer[offset]);
+}
+
+
+static uint32_t rtmsgringTail(const RTMsgRing* ring)
+{
+    uint32_t tail = ring->tail;
+    if (*rtmsgringHeader(ring, tail) == RTPRIV_MSG_RING_WRAP) {
+        tail = 0;
+    }
+    return tail;
+}
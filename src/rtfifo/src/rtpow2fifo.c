@@ -0,0 +1,140 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtplf.h"
+#include "rtpow2fifo.h"
+
+
+
+/*-------------------------------+
+ | Private function declarations |
+ +-------------------------------*/
+
+
+/** Get the address of the slot designated by a head or tail counter
+ *
+ * @param fifo    [in] The FIFO the counter belongs to
+ * @param counter [in] The head or tail counter
+ *
+ * @return A pointer to the slot inside `fifo->buffer`
+ */
+static RTByte* rtpow2fifoSlot(const RTPow2Fifo* fifo, uint16_t counter);
+
+
+
+/*---------------------------------+
+ | Public function implementations |
+ +---------------------------------*/
+
+
+void RTPow2FifoInit(RTPow2Fifo* fifo, uint16_t capacity,
+        uint16_t itemSize_B, RTByte* buffer)
+{
+    uint16_t shift = 0;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(RTIS_POW2_15(capacity));
+    RTASSERT(RTIS_POW2_15(itemSize_B));
+    RTASSERT(buffer != NULL);
+
+    while ((1u << shift) < itemSize_B) {
+        shift++;
+    }
+    fifo->head = 0;
+    fifo->tail = 0;
+    fifo->mask = capacity - 1;
+    fifo->itemShift = shift;
+    fifo->buffer = buffer;
+}
+
+
+uint16_t RTPow2FifoSize(const RTPow2Fifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return (uint16_t)(fifo->head - fifo->tail);
+}
+
+
+uint16_t RTPow2FifoCapacity(const RTPow2Fifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->mask + 1;
+}
+
+
+RTBool RTPow2FifoIsEmpty(const RTPow2Fifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->head == fifo->tail;
+}
+
+
+RTBool RTPow2FifoIsFull(const RTPow2Fifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return (uint16_t)(fifo->head - fifo->tail) > fifo->mask;
+}
+
+
+RTBool RTPow2FifoPush(RTPow2Fifo* fifo, const void* item, uint16_t itemSize_B)
+{
+    RTBool pushed = RTFalse;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B <= (1u << fifo->itemShift));
+
+    if ((uint16_t)(fifo->head - fifo->tail) <= fifo->mask) {
+        RTMemcpy(rtpow2fifoSlot(fifo, fifo->head), 1u << fifo->itemShift,
+                item, itemSize_B);
+        fifo->head++;
+        pushed = RTTrue;
+    }
+    return pushed;
+}
+
+
+RTBool RTPow2FifoPop(RTPow2Fifo* fifo, void* item, uint16_t itemSize_B)
+{
+    RTBool popped = RTFalse;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B >= (1u << fifo->itemShift));
+
+    if (fifo->head != fifo->tail) {
+        RTMemcpy(item, itemSize_B, rtpow2fifoSlot(fifo, fifo->tail),
+                1u << fifo->itemShift);
+        fifo->tail++;
+        popped = RTTrue;
+    }
+    return popped;
+}
+
+
+
+/*----------------------------------+
+ | Private function implementations |
+ +----------------------------------*/
+
+
+static RTByte* rtpow2fifoSlot(const RTPow2Fifo* fifo, uint16_t counter)
+{
+    return &(fifo->buffer[(uint32_t)(counter & fifo->mask) << fifo->itemShift]);
+}
@@ -0,0 +1,115 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "rtplf.h"
+#include "rtpriofifo.h"
+
+
+
+/*---------------------------------+
+ | Public function implementations |
+ +---------------------------------*/
+
+
+void RTPrioFifoInit(RTPrioFifo* fifo, RTFifo* lanes, uint8_t laneCount)
+{
+    uint8_t i;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(lanes != NULL);
+    RTASSERT(laneCount > 0);
+    RTASSERT(laneCount <= RTPRIV_PRIO_FIFO_MAX_LANES);
+
+    fifo->nonEmpty = 0;
+    fifo->laneCount = laneCount;
+    fifo->lanes = lanes;
+    for (i = 0; i < laneCount; i++) {
+        if (!RTFifoIsEmpty(&lanes[i])) {
+            fifo->nonEmpty |= (uint32_t)1 << i;
+        }
+    }
+}
+
+
+uint8_t RTPrioFifoLaneCount(const RTPrioFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->laneCount;
+}
+
+
+uint32_t RTPrioFifoSize(const RTPrioFifo* fifo)
+{
+    uint32_t size = 0;
+    uint32_t bitmap;
+
+    RTASSERT(fifo != NULL);
+
+    bitmap = fifo->nonEmpty;
+    while (bitmap != 0) {
+        size += RTFifoSize(&(fifo->lanes[RTCTZ32(bitmap)]));
+        bitmap &= bitmap - 1; /* Clear the lowest bit set */
+    }
+    return size;
+}
+
+
+RTBool RTPrioFifoIsEmpty(const RTPrioFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->nonEmpty == 0;
+}
+
+
+RTBool RTPrioFifoPush(RTPrioFifo* fifo, uint8_t lane, const void* item,
+        uint16_t itemSize_B)
+{
+    RTBool pushed;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(lane < fifo->laneCount);
+
+    pushed = RTFifoPush(&(fifo->lanes[lane]), item, itemSize_B);
+    if (pushed) {
+        fifo->nonEmpty |= (uint32_t)1 << lane;
+    }
+    return pushed;
+}
+
+
+RTBool RTPrioFifoPop(RTPrioFifo* fifo, void* item, uint16_t itemSize_B,
+        uint8_t* lane)
+{
+    RTBool popped = RTFalse;
+
+    RTASSERT(fifo != NULL);
+
+    if (fifo->nonEmpty != 0) {
+        uint8_t index = (uint8_t)RTCTZ32(fifo->nonEmpty);
+        RTFifo* src = &(fifo->lanes[index]);
+
+        popped = RTFifoPop(src, item, itemSize_B);
+        RTASSERT(popped);
+        if (RTFifoIsEmpty(src)) {
+            fifo->nonEmpty &= ~((uint32_t)1 << index);
+        }
+        if (lane != NULL) {
+            *lane = index;
+        }
+    }
+    return popped;
+}
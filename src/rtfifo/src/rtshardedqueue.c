@@ -0,0 +1,129 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtplf.h"
+#include "rtshardedqueue.h"
+
+
+
+/*---------------------------------+
+ | Public function implementations |
+ +---------------------------------*/
+
+
+void RTShardedQueueInit(RTShardedQueue* queue, RTMpscFifo* shards,
+        uint16_t shardCount)
+{
+    RTASSERT(queue != NULL);
+    RTASSERT(shards != NULL);
+    RTASSERT(shardCount > 0);
+
+    queue->shardCount = shardCount;
+    queue->next = 0;
+    queue->shards = shards;
+}
+
+
+uint16_t RTShardedQueueShardCount(const RTShardedQueue* queue)
+{
+    RTASSERT(queue != NULL);
+    return queue->shardCount;
+}
+
+
+uint32_t RTShardedQueueSize(const RTShardedQueue* queue)
+{
+    uint32_t size = 0;
+    uint16_t i;
+
+    RTASSERT(queue != NULL);
+
+    for (i = 0; i < queue->shardCount; i++) {
+        size += RTMpscFifoSize(&(queue->shards[i]));
+    }
+    return size;
+}
+
+
+uint16_t RTShardedQueueBind(const RTShardedQueue* queue)
+{
+    RTASSERT(queue != NULL);
+    return (uint16_t)(RTCurrentCpu() % queue->shardCount);
+}
+
+
+RTBool RTShardedQueuePush(RTShardedQueue* queue, const void* item,
+        uint16_t itemSize_B)
+{
+    return RTShardedQueuePushTo(queue, RTShardedQueueBind(queue), item,
+            itemSize_B);
+}
+
+
+RTBool RTShardedQueuePushTo(RTShardedQueue* queue, uint16_t shard,
+        const void* item, uint16_t itemSize_B)
+{
+    RTASSERT(queue != NULL);
+    RTASSERT(shard < queue->shardCount);
+
+    return RTMpscFifoPush(&(queue->shards[shard]), item, itemSize_B);
+}
+
+
+uint32_t RTShardedQueuePopN(RTShardedQueue* queue, void* items,
+        uint16_t itemSize_B, uint32_t count, uint16_t batch)
+{
+    uint32_t popped = 0;
+    uint16_t emptyShards = 0;
+    uint16_t next;
+    RTByte* dst = (RTByte*)items;
+
+    RTASSERT(queue != NULL);
+    RTASSERT(items != NULL);
+    RTASSERT(batch > 0);
+
+    /* Work on a local copy of `next`, as the compiler can't keep
+     * `queue->next` in a register across the calls to `RTMpscFifoPop()` */
+    next = queue->next;
+    while ((popped < count) && (emptyShards < queue->shardCount)) {
+        RTMpscFifo* shard = &(queue->shards[next]);
+        uint16_t n = 0;
+        while ((n < batch) && (popped < count)
+                && RTMpscFifoPop(shard, dst, itemSize_B)) {
+            dst += itemSize_B;
+            popped++;
+            n++;
+        }
+        if (n == 0) {
+            emptyShards++;
+        } else {
+            emptyShards = 0;
+        }
+        next++;
+        if (next >= queue->shardCount) {
+            next = 0;
+        }
+    }
+    queue->next = next;
+    return popped;
+}
+
+
+RTBool RTShardedQueuePop(RTShardedQueue* queue, void* item,
+        uint16_t itemSize_B)
+{
+    return RTShardedQueuePopN(queue, item, itemSize_B, 1, 1) == 1;
+}
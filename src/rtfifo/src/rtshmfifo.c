@@ -0,0 +1,217 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "rtplf.h"
+#include "rtshmfifo.h"
+#include "rtticket_priv.h"
+
+
+
+/*-------------------------------+
+ | Private function declarations |
+ +-------------------------------*/
+
+
+/** Round up a size to the alignment of the items
+ *
+ * @param size_B [in] Size to round up, in bytes
+ *
+ * @return The rounded up size, in bytes
+ */
+static size_t rtshmfifoAlign(size_t size_B);
+
+
+/** Set up a process-local handle to a shared-memory FIFO
+ *
+ * @param fifo       [out] Handle to set up
+ * @param mem        [in]  Memory area of the FIFO
+ * @param capacity   [in]  FIFO capacity, in number of items
+ * @param itemSize_B [in]  Size of a single item in the FIFO, in bytes
+ */
+static void rtshmfifoSetup(RTShmFifo* fifo, void* mem, uint16_t capacity,
+        uint16_t itemSize_B);
+
+
+
+/*---------------------------------+
+ | Public function implementations |
+ +---------------------------------*/
+
+
+size_t RTShmFifoFootprint_B(uint16_t capacity, uint16_t itemSize_B)
+{
+    size_t seqs_B;
+
+    RTASSERT(capacity > 0);
+    RTASSERT(itemSize_B > 0);
+
+    seqs_B = rtshmfifoAlign((size_t)capacity * sizeof(uint32_t));
+    return rtshmfifoAlign(sizeof(RTPrivShmFifoHeader)) + seqs_B
+        + ((size_t)capacity * itemSize_B);
+}
+
+
+void RTShmFifoCreate(RTShmFifo* fifo, void* mem, size_t mem_B,
+        uint16_t capacity, uint16_t itemSize_B)
+{
+    RTPrivShmFifoHeader* header = mem;
+    uint16_t i;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(mem != NULL);
+    RTASSERT(((uintptr_t)mem % RTPRIV_SHM_FIFO_ALIGN_B) == 0);
+    RTASSERT(mem_B >= RTShmFifoFootprint_B(capacity, itemSize_B));
+
+    header->magic = 0;
+    header->capacity = capacity;
+    header->itemSize_B = itemSize_B;
+    header->head = 0;
+    header->tail = 0;
+    rtshmfifoSetup(fifo, mem, capacity, itemSize_B);
+    for (i = 0; i < capacity; i++) {
+        fifo->seqs[i] = 0;
+    }
+
+    /* Publish the FIFO only once it is fully set up */
+    RTATOMIC_STORE_RELEASE(&header->magic, RTPRIV_SHM_FIFO_MAGIC);
+}
+
+
+RTBool RTShmFifoAttach(RTShmFifo* fifo, void* mem, size_t mem_B)
+{
+    RTBool attached = RTFalse;
+    RTPrivShmFifoHeader* header = mem;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(mem != NULL);
+    RTASSERT(((uintptr_t)mem % RTPRIV_SHM_FIFO_ALIGN_B) == 0);
+
+    if (    (mem_B >= sizeof(RTPrivShmFifoHeader))
+         && (RTATOMIC_LOAD_ACQUIRE(&header->magic) == RTPRIV_SHM_FIFO_MAGIC)) {
+        /* Read the geometry only once, in case another process changes it */
+        uint16_t capacity = RTATOMIC_LOAD_RELAXED(&header->capacity);
+        uint16_t itemSize_B = RTATOMIC_LOAD_RELAXED(&header->itemSize_B);
+
+        if (    (capacity > 0)
+             && (itemSize_B > 0)
+             && (mem_B >= RTShmFifoFootprint_B(capacity, itemSize_B))) {
+            rtshmfifoSetup(fifo, mem, capacity, itemSize_B);
+            attached = RTTrue;
+        }
+    }
+    return attached;
+}
+
+
+uint16_t RTShmFifoSize(const RTShmFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return (uint16_t)rtticketSize(&fifo->header->head, &fifo->header->tail,
+            fifo->capacity, fifo->laps);
+}
+
+
+uint16_t RTShmFifoCapacity(const RTShmFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->capacity;
+}
+
+
+RTBool RTShmFifoIsEmpty(const RTShmFifo* fifo)
+{
+    return RTShmFifoSize(fifo) == 0;
+}
+
+
+RTBool RTShmFifoIsFull(const RTShmFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return RTShmFifoSize(fifo) >= fifo->capacity;
+}
+
+
+RTBool RTShmFifoPush(RTShmFifo* fifo, const void* item, uint16_t itemSize_B)
+{
+    RTBool pushed;
+    uint32_t ticket;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B <= fifo->itemSize_B);
+
+    pushed = rtticketClaimPush(&fifo->header->head, fifo->seqs, fifo->capacity,
+            fifo->laps, &ticket);
+    if (pushed) {
+        RTMemcpy(&(fifo->buffer[(ticket % fifo->capacity) * fifo->itemSize_B]),
+                fifo->itemSize_B, item, itemSize_B);
+        rtticketPublish(fifo->seqs, fifo->capacity, ticket);
+    }
+    return pushed;
+}
+
+
+RTBool RTShmFifoPop(RTShmFifo* fifo, void* item, uint16_t itemSize_B)
+{
+    RTBool popped;
+    uint32_t ticket;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B >= fifo->itemSize_B);
+
+    popped = rtticketClaimPop(&fifo->header->tail, fifo->seqs, fifo->capacity,
+            fifo->laps, RTFalse, &ticket);
+    if (popped) {
+        RTMemcpy(item, itemSize_B,
+                &(fifo->buffer[(ticket % fifo->capacity) * fifo->itemSize_B]),
+                fifo->itemSize_B);
+        rtticketRelease(fifo->seqs, fifo->capacity, fifo->laps, ticket);
+    }
+    return popped;
+}
+
+
+
+/*----------------------------------+
+ | Private function implementations |
+ +----------------------------------*/
+
+
+static size_t rtshmfifoAlign(size_t size_B)
+{
+    return (size_B + RTPRIV_SHM_FIFO_ALIGN_B - 1u)
+        & ~((size_t)RTPRIV_SHM_FIFO_ALIGN_B - 1u);
+}
+
+
+static void rtshmfifoSetup(RTShmFifo* fifo, void* mem, uint16_t capacity,
+        uint16_t itemSize_B)
+{
+    size_t seqsOffset = rtshmfifoAlign(sizeof(RTPrivShmFifoHeader));
+    size_t bufferOffset = seqsOffset
+        + rtshmfifoAlign((size_t)capacity * sizeof(uint32_t));
+
+    fifo->header = mem;
+    fifo->seqs = (uint32_t*)(void*)((RTByte*)mem + seqsOffset);
+    fifo->buffer = (RTByte*)mem + bufferOffset;
+    fifo->capacity = capacity;
+    fifo->itemSize_B = itemSize_B;
+    fifo->laps = 0x80000000u / capacity;
+}
@@ -0,0 +1,215 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtplf.h"
+#include "rtspscfifo.h"
+
+
+
+/*-------------------------------+
+ | Private function declarations |
+ +-------------------------------*/
+
+
+/** Increment a head or tail index, wrapping around at 2 * capacity
+ *
+ * @param fifo  [in] The FIFO the index belongs to
+ * @param index [in] The index to increment
+ *
+ * @return The incremented index
+ */
+static uint32_t rtspscfifoNext(const RTSpscFifo* fifo, uint32_t index);
+
+
+/** Compute the number of items between a tail and a head index
+ *
+ * @param fifo [in] The FIFO the indices belong to
+ * @param head [in] Head index
+ * @param tail [in] Tail index
+ *
+ * @return The number of items between `tail` and `head`
+ */
+static uint32_t rtspscfifoDistance(const RTSpscFifo* fifo,
+        uint32_t head, uint32_t tail);
+
+
+/** Get the address of the slot designated by a head or tail index
+ *
+ * @param fifo  [in] The FIFO the index belongs to
+ * @param index [in] The index to convert
+ *
+ * @return A pointer to the slot inside `fifo->buffer`
+ */
+static RTByte* rtspscfifoSlot(const RTSpscFifo* fifo, uint32_t index);
+
+
+
+/*---------------------------------+
+ | Public function implementations |
+ +---------------------------------*/
+
+
+void RTSpscFifoInit(RTSpscFifo* fifo, uint16_t capacity,
+        uint16_t itemSize_B, RTByte* buffer)
+{
+    RTASSERT(fifo != NULL);
+    RTASSERT(capacity > 0);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(buffer != NULL);
+
+    fifo->capacity = capacity;
+    fifo->itemSize_B = itemSize_B;
+    fifo->buffer = buffer;
+    fifo->head = 0;
+    fifo->tailCache = 0;
+    fifo->tail = 0;
+    fifo->headCache = 0;
+}
+
+
+uint16_t RTSpscFifoSize(const RTSpscFifo* fifo)
+{
+    uint32_t tail;
+    uint32_t head;
+    uint32_t size;
+
+    RTASSERT(fifo != NULL);
+
+    /* NB: Load `tail` first, so the computed size can't be negative */
+    tail = RTATOMIC_LOAD_ACQUIRE(&fifo->tail);
+    head = RTATOMIC_LOAD_ACQUIRE(&fifo->head);
+    size = rtspscfifoDistance(fifo, head, tail);
+
+    /* A third thread may see `head` more than `capacity` ahead of `tail` */
+    if (size > fifo->capacity) {
+        size = fifo->capacity;
+    }
+    return (uint16_t)size;
+}
+
+
+uint16_t RTSpscFifoCapacity(const RTSpscFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return fifo->capacity;
+}
+
+
+RTBool RTSpscFifoIsEmpty(const RTSpscFifo* fifo)
+{
+    return RTSpscFifoSize(fifo) == 0;
+}
+
+
+RTBool RTSpscFifoIsFull(const RTSpscFifo* fifo)
+{
+    RTASSERT(fifo != NULL);
+    return RTSpscFifoSize(fifo) >= fifo->capacity;
+}
+
+
+RTBool RTSpscFifoPush(RTSpscFifo* fifo, const void* item, uint16_t itemSize_B)
+{
+    RTBool pushed = RTFalse;
+    uint32_t head;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B <= fifo->itemSize_B);
+
+    head = RTATOMIC_LOAD_RELAXED(&fifo->head);
+
+    /* Only look at the consumer's cache line if the FIFO looks full */
+    if (rtspscfifoDistance(fifo, head, fifo->tailCache) >= fifo->capacity) {
+        fifo->tailCache = RTATOMIC_LOAD_ACQUIRE(&fifo->tail);
+    }
+
+    if (rtspscfifoDistance(fifo, head, fifo->tailCache) < fifo->capacity) {
+        RTMemcpy(rtspscfifoSlot(fifo, head), fifo->itemSize_B,
+                item, itemSize_B);
+        RTATOMIC_STORE_RELEASE(&fifo->head, rtspscfifoNext(fifo, head));
+        pushed = RTTrue;
+    }
+    return pushed;
+}
+
+
+RTBool RTSpscFifoPop(RTSpscFifo* fifo, void* item, uint16_t itemSize_B)
+{
+    RTBool popped = RTFalse;
+    uint32_t tail;
+
+    RTASSERT(fifo != NULL);
+    RTASSERT(fifo->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B >= fifo->itemSize_B);
+
+    tail = RTATOMIC_LOAD_RELAXED(&fifo->tail);
+
+    /* Only look at the producer's cache line if the FIFO looks empty */
+    if (fifo->headCache == tail) {
+        fifo->headCache = RTATOMIC_LOAD_ACQUIRE(&fifo->head);
+    }
+
+    if (fifo->headCache != tail) {
+        RTMemcpy(item, itemSize_B,
+                rtspscfifoSlot(fifo, tail), fifo->itemSize_B);
+        RTATOMIC_STORE_RELEASE(&fifo->tail, rtspscfifoNext(fifo, tail));
+        popped = RTTrue;
+    }
+    return popped;
+}
+
+
+
+/*----------------------------------+
+ | Private function implementations |
+ +----------------------------------*/
+
+
+static uint32_t rtspscfifoNext(const RTSpscFifo* fifo, uint32_t index)
+{
+    index++;
+    if (index >= (2u * (uint32_t)fifo->capacity)) {
+        index = 0;
+    }
+    return index;
+}
+
+
+static uint32_t rtspscfifoDistance(const RTSpscFifo* fifo,
+        uint32_t head, uint32_t tail)
+{
+    uint32_t distance;
+    if (head >= tail) {
+        distance = head - tail;
+    } else {
+        distance = head + (2u * (uint32_t)fifo->capacity) - tail;
+    }
+    return distance;
+}
+
+
+static RTByte* rtspscfifoSlot(const RTSpscFifo* fifo, uint32_t index)
+{
+    if (index >= fifo->capacity) {
+        index -= fifo->capacity;
+    }
+    return &(fifo->buffer[index * fifo->itemSize_B]);
+}
@@ -0,0 +1,220 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "rtplf.h"
+#include "rtstealdeque.h"
+
+
+
+/*-------------------------------+
+ | Private function declarations |
+ +-------------------------------*/
+
+
+/** Get the address of the slot designated by a top or bottom index
+ *
+ * @param deque [in] The deque the index belongs to
+ * @param index [in] The top or bottom index
+ *
+ * @return A pointer to the slot inside `deque->buffer`
+ */
+static RTByte* rtstealdequeSlot(const RTStealDeque* deque, uint32_t index);
+
+
+/** Compute the number of items between a top and a bottom index
+ *
+ * @param bottom [in] Bottom index
+ * @param top    [in] Top index
+ *
+ * @return `bottom - top`, which is negative if the owner is popping the last
+ *         item
+ */
+static int32_t rtstealdequeDistance(uint32_t bottom, uint32_t top);
+
+
+
+/*---------------------------------+
+ | Public function implementations |
+ +---------------------------------*/
+
+
+void RTStealDequeInit(RTStealDeque* deque, uint16_t capacity,
+        uint16_t itemSize_B, RTByte* buffer)
+{
+    RTASSERT(deque != NULL);
+    RTASSERT(RTIS_POW2_15(capacity));
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(buffer != NULL);
+
+    deque->capacity = capacity;
+    deque->itemSize_B = itemSize_B;
+    deque->buffer = buffer;
+    deque->top = 0;
+    deque->bottom = 0;
+}
+
+
+uint16_t RTStealDequeSize(const RTStealDeque* deque)
+{
+    uint32_t top;
+    uint32_t bottom;
+    int32_t size;
+
+    RTASSERT(deque != NULL);
+
+    top = RTATOMIC_LOAD_ACQUIRE(&deque->top);
+    bottom = RTATOMIC_LOAD_ACQUIRE(&deque->bottom);
+    size = rtstealdequeDistance(bottom, top);
+    if (size < 0) {
+        size = 0;
+    } else if (size > (int32_t)deque->capacity) {
+        size = deque->capacity;
+    }
+    return (uint16_t)size;
+}
+
+
+uint16_t RTStealDequeCapacity(const RTStealDeque* deque)
+{
+    RTASSERT(deque != NULL);
+    return deque->capacity;
+}
+
+
+RTBool RTStealDequeIsEmpty(const RTStealDeque* deque)
+{
+    return RTStealDequeSize(deque) == 0;
+}
+
+
+RTBool RTStealDequePush(RTStealDeque* deque, const void* item,
+        uint16_t itemSize_B)
+{
+    RTBool pushed = RTFalse;
+    uint32_t bottom;
+    uint32_t top;
+
+    RTASSERT(deque != NULL);
+    RTASSERT(deque->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B <= deque->itemSize_B);
+
+    bottom = RTATOMIC_LOAD_RELAXED(&deque->bottom);
+    top = RTATOMIC_LOAD_ACQUIRE(&deque->top);
+    if (rtstealdequeDistance(bottom, top) < (int32_t)deque->capacity) {
+        RTMemcpy(rtstealdequeSlot(deque, bottom), deque->itemSize_B,
+                item, itemSize_B);
+        RTATOMIC_STORE_RELEASE(&deque->bottom, bottom + 1u);
+        pushed = RTTrue;
+    }
+    return pushed;
+}
+
+
+RTBool RTStealDequePop(RTStealDeque* deque, void* item, uint16_t itemSize_B)
+{
+    RTBool popped = RTFalse;
+    uint32_t bottom;
+    uint32_t top;
+
+    RTASSERT(deque != NULL);
+    RTASSERT(deque->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B >= deque->itemSize_B);
+
+    /* Reserve the bottom item first, then check whether thieves have taken it;
+     * the fence makes sure thieves see the new bottom before we read top */
+    bottom = RTATOMIC_LOAD_RELAXED(&deque->bottom) - 1u;
+    RTATOMIC_STORE_RELAXED(&deque->bottom, bottom);
+    RTATOMIC_FENCE();
+    top = RTATOMIC_LOAD_RELAXED(&deque->top);
+
+    if (rtstealdequeDistance(bottom, top) >= 0) {
+        RTMemcpy(item, itemSize_B, rtstealdequeSlot(deque, bottom),
+                deque->itemSize_B);
+        if (bottom == top) {
+            /* Last item => race against thieves for it */
+            popped = RTATOMIC_CAS(&deque->top, &top, top + 1u);
+            RTATOMIC_STORE_RELAXED(&deque->bottom, bottom + 1u);
+        } else {
+            popped = RTTrue;
+        }
+    } else {
+        /* Deque is empty */
+        RTATOMIC_STORE_RELAXED(&deque->bottom, bottom + 1u);
+    }
+    return popped;
+}
+
+
+RTBool RTStealDequeSteal(RTStealDeque* deque, void* item, uint16_t itemSize_B)
+{
+    RTBool stolen = RTFalse;
+    RTBool done = RTFalse;
+    uint32_t top;
+    uint32_t bottom;
+
+    RTASSERT(deque != NULL);
+    RTASSERT(deque->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(itemSize_B >= deque->itemSize_B);
+
+    while (!done) {
+        top = RTATOMIC_LOAD_ACQUIRE(&deque->top);
+        RTATOMIC_FENCE();
+        bottom = RTATOMIC_LOAD_ACQUIRE(&deque->bottom);
+
+        if (rtstealdequeDistance(bottom, top) > 0) {
+            /* The slot may be overwritten as soon as another thread takes
+             * item `top`, but then the CAS below fails and the copy is
+             * discarded */
+            RTMemcpy(item, itemSize_B, rtstealdequeSlot(deque, top),
+                    deque->itemSize_B);
+            if (RTATOMIC_CAS(&deque->top, &top, top + 1u)) {
+                stolen = RTTrue;
+                done = RTTrue;
+            }
+            /* else: another thread took item `top`, try again */
+
+        } else {
+            done = RTTrue;
+        }
+    }
+    return stolen;
+}
+
+
+
+/*----------------------------------+
+ | Private function implementations |
+ +----------------------------------*/
+
+
+static RTByte* rtstealdequeSlot(const RTStealDeque* deque, uint32_t index)
+{
+    uint32_t slot = index & ((uint32_t)deque->capacity - 1u);
+    return &(deque->buffer[slot * deque->itemSize_B]);
+}
+
+
+static int32_t rtstealdequeDistance(uint32_t bottom, uint32_t top)
+{
+    return (int32_t)(bottom - top);
+}
@@ -0,0 +1,197 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "rtbroadcastring.h"
+#include "rttest.h"
+#include "rtplf.h"
+#include <pthread.h>
+#include <sched.h>
+
+
+#define TEST_BROADCAST_ITEMS 100000u
+#define TEST_BROADCAST_CONSUMERS 3
+
+
+typedef struct {
+    uint32_t seq;
+    uint32_t payload;
+} TBroadcastItem;
+
+typedef struct {
+    uint32_t count;
+    uint32_t expected;
+    RTBool   inOrder;
+} TBroadcastCtx;
+
+static TBroadcastItem gBroadcastBuffer[4];
+static RTBroadcastCursor gBroadcastCursors[2];
+static RTBroadcastRing gBroadcastRing
+        = RT_BROADCAST_RING_INIT(gBroadcastBuffer, gBroadcastCursors);
+
+static TBroadcastItem gThreadedBuffer[64];
+static RTBroadcastCursor gThreadedCursors[TEST_BROADCAST_CONSUMERS];
+static RTBroadcastRing gThreadedRing;
+static TBroadcastCtx gThreadedCtx[TEST_BROADCAST_CONSUMERS];
+
+
+static void testBroadcastHandler(void* ctx, const void* item)
+{
+    TBroadcastCtx* c = ctx;
+    const TBroadcastItem* i = item;
+
+    if ((i->seq != c->expected) || (i->payload != (i->seq * 3u))) {
+        c->inOrder = RTFalse;
+    }
+    c->expected++;
+    c->count++;
+}
+
+
+static void* testBroadcastConsumer(void* arg)
+{
+    uint8_t consumer = (uint8_t)(long)arg;
+    TBroadcastCtx* ctx = &gThreadedCtx[consumer];
+
+    while (ctx->count < TEST_BROADCAST_ITEMS) {
+        /* Consumer 0 reads one item at a time, the others in batches */
+        uint32_t max = (consumer == 0) ? 1u : 0xFFFFFFFFu;
+        if (RTBroadcastRingRead(&gThreadedRing, consumer, testBroadcastHandler,
+                    ctx, max) == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+
+RTT_GROUP_START(TestBroadcastRing, 0x00020015u, NULL, NULL)
+
+RTT_TEST_START(broadcast_ring_should_be_empty_after_creation)
+{
+    TBroadcastItem item;
+
+    RTT_ASSERT(RTBroadcastRingCapacity(&gBroadcastRing) == 4u);
+    RTT_ASSERT(RTBroadcastRingConsumerCount(&gBroadcastRing) == 2u);
+    RTT_ASSERT(RTBroadcastRingAvailable(&gBroadcastRing, 0) == 0);
+    RTT_ASSERT(RTBroadcastRingAvailable(&gBroadcastRing, 1) == 0);
+    RTT_ASSERT(!RTBroadcastRingPop(&gBroadcastRing, 1, &item, sizeof(item)));
+}
+RTT_TEST_END
+
+RTT_TEST_START(broadcast_ring_should_be_gated_by_slowest_consumer)
+{
+    TBroadcastItem item;
+    uint32_t i;
+
+    for (i = 0; i < 4; i++) {
+        item.seq = i;
+        item.payload = i * 3u;
+        RTT_ASSERT(RTBroadcastRingPublish(&gBroadcastRing, &item,
+                    sizeof(item)));
+    }
+    RTT_ASSERT(!RTBroadcastRingPublish(&gBroadcastRing, &item, sizeof(item)));
+    RTT_ASSERT(RTBroadcastRingClaim(&gBroadcastRing) == NULL);
+
+    /* Consumer 0 reading everything is not enough */
+    for (i = 0; i < 4; i++) {
+        RTT_ASSERT(RTBroadcastRingPop(&gBroadcastRing, 0, &item,
+                    sizeof(item)));
+        RTT_ASSERT(item.seq == i);
+    }
+    RTT_ASSERT(!RTBroadcastRingPop(&gBroadcastRing, 0, &item, sizeof(item)));
+    RTT_ASSERT(RTBroadcastRingClaim(&gBroadcastRing) == NULL);
+
+    /* Consumer 1 reading the oldest item frees one slot */
+    RTT_ASSERT(RTBroadcastRingPop(&gBroadcastRing, 1, &item, sizeof(item)));
+    RTT_ASSERT(item.seq == 0);
+    RTT_ASSERT(RTBroadcastRingAvailable(&gBroadcastRing, 1) == 3u);
+    RTT_ASSERT(RTBroadcastRingClaim(&gBroadcastRing) != NULL);
+}
+RTT_TEST_END
+
+RTT_TEST_START(broadcast_ring_should_publish_claimed_slot)
+{
+    TBroadcastItem* slot;
+    TBroadcastItem item;
+
+    slot = RTBroadcastRingClaim(&gBroadcastRing);
+    RTT_ASSERT(slot != NULL);
+    slot->seq = 4;
+    slot->payload = 12;
+    RTBroadcastRingCommit(&gBroadcastRing);
+    RTT_ASSERT(RTBroadcastRingClaim(&gBroadcastRing) == NULL);
+
+    RTT_ASSERT(RTBroadcastRingPop(&gBroadcastRing, 0, &item, sizeof(item)));
+    RTT_ASSERT((item.seq == 4u) && (item.payload == 12u));
+}
+RTT_TEST_END
+
+RTT_TEST_START(broadcast_ring_should_read_a_batch_in_order)
+{
+    TBroadcastCtx ctx;
+
+    ctx.count = 0;
+    ctx.expected = 1;
+    ctx.inOrder = RTTrue;
+    RTT_ASSERT(RTBroadcastRingRead(&gBroadcastRing, 1, testBroadcastHandler,
+                &ctx, 2) == 2u);
+    RTT_ASSERT(RTBroadcastRingRead(&gBroadcastRing, 1, testBroadcastHandler,
+                &ctx, 10) == 2u);
+    RTT_EXPECT(ctx.inOrder);
+    RTT_EXPECT(ctx.expected == 5u);
+    RTT_ASSERT(RTBroadcastRingAvailable(&gBroadcastRing, 1) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(broadcast_ring_consumers_should_all_see_every_item)
+{
+    pthread_t threads[TEST_BROADCAST_CONSUMERS];
+    TBroadcastItem item;
+    uint32_t i;
+    long c;
+
+    RTBroadcastRingInit(&gThreadedRing, RTARRAYSIZE(gThreadedBuffer),
+            sizeof(gThreadedBuffer[0]), (RTByte*)gThreadedBuffer,
+            gThreadedCursors, TEST_BROADCAST_CONSUMERS);
+    for (c = 0; c < TEST_BROADCAST_CONSUMERS; c++) {
+        gThreadedCtx[c].count = 0;
+        gThreadedCtx[c].expected = 0;
+        gThreadedCtx[c].inOrder = RTTrue;
+        RTT_ASSERT(pthread_create(&threads[c], NULL, testBroadcastConsumer,
+                    (void*)c) == 0);
+    }
+    for (i = 0; i < TEST_BROADCAST_ITEMS; i++) {
+        item.seq = i;
+        item.payload = i * 3u;
+        while (!RTBroadcastRingPublish(&gThreadedRing, &item, sizeof(item))) {
+            sched_yield();
+        }
+    }
+    for (c = 0; c < TEST_BROADCAST_CONSUMERS; c++) {
+        pthread_join(threads[c], NULL);
+        RTT_EXPECT(gThreadedCtx[c].inOrder);
+        RTT_EXPECT(gThreadedCtx[c].count == TEST_BROADCAST_ITEMS);
+    }
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestBroadcastRing,
+        broadcast_ring_should_be_empty_after_creation,
+        broadcast_ring_should_be_gated_by_slowest_consumer,
+        broadcast_ring_should_publish_claimed_slot,
+        broadcast_ring_should_read_a_batch_in_order,
+        broadcast_ring_consumers_should_all_see_every_item)
@@ -127,7 +127,7 @@ RTT_TEST_END
 
 RTT_TEST_START(smallfifo_should_fail_to_push_when_filled_up)
 {
-    TSmallItem item;
+    TSmallItem item = { 0, 0 };
     RTT_ASSERT(!RTSmallFifoPush(&gSmallFifo, &item, sizeof(item)));
 }
 RTT_TEST_END
@@ -334,7 +334,7 @@ RTT_TEST_END
 
 RTT_TEST_START(fifo_should_fail_to_push_when_filled_up)
 {
-    TItem item;
+    TItem item = { 0 };
     RTT_ASSERT(!RTFifoPush(&gFifo, &item, sizeof(item)));
 }
 RTT_TEST_END
@@ -423,3 +423,653 @@ RTT_GROUP_END(TestFifo,
         fifo_capacity_should_be_1000_when_partially_full,
         fifo_should_pop_600_items,
         fifo_should_be_empty_when_emptied)
+
+
+static TSmallItem gSmallBulkBuffer[10];
+static RTSmallFifo gSmallBulkFifo = RT_SMALL_FIFO_INIT(gSmallBulkBuffer);
+
+RTT_GROUP_START(TestSmallFifoBulk, 0x00020006u, NULL, NULL)
+
+RTT_TEST_START(smallfifo_should_push_7_items_at_once)
+{
+    TSmallItem items[7];
+    uint8_t i;
+
+    for (i = 0; i < 7u; i++) {
+        items[i].a = i;
+        items[i].b = -(int8_t)i;
+    }
+    RTT_ASSERT(RTSmallFifoPushN(&gSmallBulkFifo, items, 7u) == 7u);
+    RTT_ASSERT(RTSmallFifoSize(&gSmallBulkFifo) == 7u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(smallfifo_should_pop_5_items_at_once)
+{
+    TSmallItem items[5];
+    uint8_t i;
+
+    RTT_ASSERT(RTSmallFifoPopN(&gSmallBulkFifo, items, 5u) == 5u);
+    for (i = 0; i < 5u; i++) {
+        RTT_EXPECT((items[i].a == i) && (items[i].b == -(int8_t)i));
+    }
+    RTT_ASSERT(RTSmallFifoSize(&gSmallBulkFifo) == 2u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(smallfifo_should_push_partially_across_the_wrap)
+{
+    TSmallItem items[10];
+    uint8_t i;
+
+    for (i = 0; i < 10u; i++) {
+        items[i].a = 7u + i;
+        items[i].b = -(int8_t)(7 + i);
+    }
+    RTT_ASSERT(RTSmallFifoPushN(&gSmallBulkFifo, items, 10u) == 8u);
+    RTT_ASSERT(RTSmallFifoIsFull(&gSmallBulkFifo));
+    RTT_ASSERT(RTSmallFifoPushN(&gSmallBulkFifo, items, 1u) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(smallfifo_should_pop_all_items_across_the_wrap)
+{
+    TSmallItem items[20];
+    uint8_t i;
+
+    RTT_ASSERT(RTSmallFifoPopN(&gSmallBulkFifo, items, 20u) == 10u);
+    for (i = 0; i < 10u; i++) {
+        RTT_EXPECT((items[i].a == (5u + i)) && (items[i].b == -(int8_t)(5 + i)));
+    }
+    RTT_ASSERT(RTSmallFifoIsEmpty(&gSmallBulkFifo));
+    RTT_ASSERT(RTSmallFifoPopN(&gSmallBulkFifo, items, 1u) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(smallfifo_should_mix_single_and_bulk_operations)
+{
+    TSmallItem items[4];
+    TSmallItem item;
+
+    item.a = 1000u;
+    item.b = 1;
+    RTT_ASSERT(RTSmallFifoPush(&gSmallBulkFifo, &item, sizeof(item)));
+    items[0].a = 1001u;
+    items[0].b = 2;
+    items[1].a = 1002u;
+    items[1].b = 3;
+    RTT_ASSERT(RTSmallFifoPushN(&gSmallBulkFifo, items, 2u) == 2u);
+    RTT_ASSERT(RTSmallFifoPop(&gSmallBulkFifo, &item, sizeof(item)));
+    RTT_EXPECT((item.a == 1000u) && (item.b == 1));
+    RTT_ASSERT(RTSmallFifoPopN(&gSmallBulkFifo, items, 4u) == 2u);
+    RTT_EXPECT((items[0].a == 1001u) && (items[1].a == 1002u));
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestSmallFifoBulk,
+        smallfifo_should_push_7_items_at_once,
+        smallfifo_should_pop_5_items_at_once,
+        smallfifo_should_push_partially_across_the_wrap,
+        smallfifo_should_pop_all_items_across_the_wrap,
+        smallfifo_should_mix_single_and_bulk_operations)
+
+
+static uint32_t gBulkBuffer[1000];
+static RTFifo gBulkFifo = RT_FIFO_INIT(gBulkBuffer);
+static uint32_t gBulkItems[1500];
+
+RTT_GROUP_START(TestFifoBulk, 0x00020007u, NULL, NULL)
+
+RTT_TEST_START(fifo_should_push_700_items_at_once)
+{
+    uint16_t i;
+
+    for (i = 0; i < 700u; i++) {
+        gBulkItems[i] = 50000u + i;
+    }
+    RTT_ASSERT(RTFifoPushN(&gBulkFifo, gBulkItems, 700u) == 700u);
+    RTT_ASSERT(RTFifoSize(&gBulkFifo) == 700u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(fifo_should_pop_600_items_at_once)
+{
+    uint16_t i;
+
+    RTT_ASSERT(RTFifoPopN(&gBulkFifo, gBulkItems, 600u) == 600u);
+    for (i = 0; i < 600u; i++) {
+        RTT_EXPECT(gBulkItems[i] == (50000u + i));
+    }
+    RTT_ASSERT(RTFifoSize(&gBulkFifo) == 100u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(fifo_should_push_partially_across_the_wrap)
+{
+    uint16_t i;
+
+    for (i = 0; i < 1500u; i++) {
+        gBulkItems[i] = 50700u + i;
+    }
+    RTT_ASSERT(RTFifoPushN(&gBulkFifo, gBulkItems, 1500u) == 900u);
+    RTT_ASSERT(RTFifoIsFull(&gBulkFifo));
+    RTT_ASSERT(RTFifoPushN(&gBulkFifo, gBulkItems, 1u) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(fifo_should_pop_all_items_across_the_wrap)
+{
+    uint16_t i;
+
+    RTT_ASSERT(RTFifoPopN(&gBulkFifo, gBulkItems, 1500u) == 1000u);
+    for (i = 0; i < 1000u; i++) {
+        RTT_EXPECT(gBulkItems[i] == (50600u + i));
+    }
+    RTT_ASSERT(RTFifoIsEmpty(&gBulkFifo));
+    RTT_ASSERT(RTFifoPopN(&gBulkFifo, gBulkItems, 1u) == 0);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestFifoBulk,
+        fifo_should_push_700_items_at_once,
+        fifo_should_pop_600_items_at_once,
+        fifo_should_push_partially_across_the_wrap,
+        fifo_should_pop_all_items_across_the_wrap)
+
+
+static TItem gZeroCopyBuffer[3];
+static RTFifo gZeroCopyFifo = RT_FIFO_INIT(gZeroCopyBuffer);
+
+RTT_GROUP_START(TestFifoZeroCopy, 0x00020008u, NULL, NULL)
+
+RTT_TEST_START(fifo_should_not_peek_when_empty)
+{
+    RTT_ASSERT(RTFifoPeek(&gZeroCopyFifo) == NULL);
+}
+RTT_TEST_END
+
+RTT_TEST_START(fifo_should_reserve_the_same_slot_until_committed)
+{
+    TItem* slot = RTFifoReserve(&gZeroCopyFifo);
+    RTT_ASSERT(slot != NULL);
+    RTT_ASSERT(RTFifoReserve(&gZeroCopyFifo) == slot);
+    RTT_ASSERT(RTFifoIsEmpty(&gZeroCopyFifo));
+}
+RTT_TEST_END
+
+RTT_TEST_START(fifo_should_push_items_written_in_place)
+{
+    uint32_t i;
+
+    for (i = 0; i < 3u; i++) {
+        TItem* slot = RTFifoReserve(&gZeroCopyFifo);
+        RTT_ASSERT(slot != NULL);
+        slot->a = 700u + i;
+        slot->b = -(int32_t)i;
+        RTFifoCommit(&gZeroCopyFifo);
+    }
+    RTT_ASSERT(RTFifoIsFull(&gZeroCopyFifo));
+    RTT_ASSERT(RTFifoReserve(&gZeroCopyFifo) == NULL);
+}
+RTT_TEST_END
+
+RTT_TEST_START(fifo_should_peek_and_release_items_in_order)
+{
+    uint32_t i;
+
+    for (i = 0; i < 2u; i++) {
+        const TItem* item = RTFifoPeek(&gZeroCopyFifo);
+        RTT_ASSERT(item != NULL);
+        RTT_EXPECT((item->a == (700u + i)) && (item->b == -(int32_t)i));
+        RTT_ASSERT(RTFifoPeek(&gZeroCopyFifo) == item);
+        RTFifoRelease(&gZeroCopyFifo);
+    }
+    RTT_ASSERT(RTFifoSize(&gZeroCopyFifo) == 1u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(fifo_should_mix_zero_copy_and_regular_operations)
+{
+    TItem item;
+    TItem* slot;
+
+    item.a = 800u;
+    item.b = 8;
+    RTT_ASSERT(RTFifoPush(&gZeroCopyFifo, &item, sizeof(item)));
+    slot = RTFifoReserve(&gZeroCopyFifo);
+    RTT_ASSERT(slot != NULL);
+    slot->a = 801u;
+    slot->b = 9;
+    RTFifoCommit(&gZeroCopyFifo);
+
+    RTT_ASSERT(RTFifoPop(&gZeroCopyFifo, &item, sizeof(item)));
+    RTT_EXPECT(item.a == 702u);
+    RTT_EXPECT(((const TItem*)RTFifoPeek(&gZeroCopyFifo))->a == 800u);
+    RTFifoRelease(&gZeroCopyFifo);
+    RTT_ASSERT(RTFifoPop(&gZeroCopyFifo, &item, sizeof(item)));
+    RTT_EXPECT((item.a == 801u) && (item.b == 9));
+    RTT_ASSERT(RTFifoIsEmpty(&gZeroCopyFifo));
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestFifoZeroCopy,
+        fifo_should_not_peek_when_empty,
+        fifo_should_reserve_the_same_slot_until_committed,
+        fifo_should_push_items_written_in_place,
+        fifo_should_peek_and_release_items_in_order,
+        fifo_should_mix_zero_copy_and_regular_operations)
+
+
+typedef struct {
+    uint32_t a;
+    int16_t b;
+    uint8_t c[6];
+} TTypedItem;
+
+RT_TYPED_FIFO(TTypedFifo, TTypedItem, 5)
+
+static TTypedFifo gTypedFifo;
+
+RTT_GROUP_START(TestTypedFifo, 0x0002000Au, NULL, NULL)
+
+RTT_TEST_START(typed_fifo_should_be_empty_when_zero_initialised)
+{
+    RTT_ASSERT(TTypedFifoIsEmpty(&gTypedFifo));
+    RTT_ASSERT(!TTypedFifoIsFull(&gTypedFifo));
+    RTT_ASSERT(TTypedFifoSize(&gTypedFifo) == 0);
+    RTT_ASSERT(TTypedFifoCapacity(&gTypedFifo) == 5u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(typed_fifo_should_push_until_full)
+{
+    TTypedItem item;
+    uint16_t i;
+
+    item.c[0] = 0;
+    item.c[5] = 0;
+    for (i = 0; i < 5u; i++) {
+        item.a = 900u + i;
+        item.b = -(int16_t)i;
+        item.c[5] = (uint8_t)i;
+        RTT_ASSERT(TTypedFifoPush(&gTypedFifo, &item));
+    }
+    RTT_ASSERT(TTypedFifoIsFull(&gTypedFifo));
+    RTT_ASSERT(!TTypedFifoPush(&gTypedFifo, &item));
+}
+RTT_TEST_END
+
+RTT_TEST_START(typed_fifo_should_pop_in_order_and_wrap_around)
+{
+    TTypedItem item;
+    uint16_t i;
+
+    for (i = 0; i < 3u; i++) {
+        RTT_ASSERT(TTypedFifoPop(&gTypedFifo, &item));
+        RTT_EXPECT((item.a == (900u + i)) && (item.b == -(int16_t)i));
+        RTT_EXPECT(item.c[5] == (uint8_t)i);
+    }
+    for (i = 5; i < 8u; i++) {
+        item.a = 900u + i;
+        item.b = -(int16_t)i;
+        item.c[5] = (uint8_t)i;
+        RTT_ASSERT(TTypedFifoPush(&gTypedFifo, &item));
+    }
+    for (i = 3; i < 8u; i++) {
+        RTT_ASSERT(TTypedFifoPop(&gTypedFifo, &item));
+        RTT_EXPECT((item.a == (900u + i)) && (item.c[5] == (uint8_t)i));
+    }
+    RTT_ASSERT(!TTypedFifoPop(&gTypedFifo, &item));
+}
+RTT_TEST_END
+
+RTT_TEST_START(typed_fifo_should_initialise_dynamically)
+{
+    TTypedFifo fifo;
+    TTypedItem item;
+
+    TTypedFifoInit(&fifo);
+    RTT_ASSERT(TTypedFifoIsEmpty(&fifo));
+    item.a = 42u;
+    item.b = 0;
+    RTT_ASSERT(TTypedFifoPush(&fifo, &item));
+    item.a = 0;
+    RTT_ASSERT(TTypedFifoPop(&fifo, &item));
+    RTT_EXPECT(item.a == 42u);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestTypedFifo,
+        typed_fifo_should_be_empty_when_zero_initialised,
+        typed_fifo_should_push_until_full,
+        typed_fifo_should_pop_in_order_and_wrap_around,
+        typed_fifo_should_initialise_dynamically)
+
+
+static TItem gNotifiedBuffer[4];
+static RTFifo gNotifiedFifo = RT_FIFO_INIT(gNotifiedBuffer);
+static RTNotifier gNotifier;
+
+static RTBool TestFifoNotifierEntry(void)
+{
+    RTBool ok = RTNotifierInit(&gNotifier);
+    if (ok) {
+        RTFifoSetNotifier(&gNotifiedFifo, &gNotifier);
+    }
+    return ok;
+}
+
+static RTBool TestFifoNotifierExit(void)
+{
+    RTFifoSetNotifier(&gNotifiedFifo, NULL);
+    RTNotifierDestroy(&gNotifier);
+    return RTTrue;
+}
+
+RTT_GROUP_START(TestFifoNotifier, 0x0002000Eu, TestFifoNotifierEntry,
+        TestFifoNotifierExit)
+
+RTT_TEST_START(fifo_notifier_should_not_be_raised_after_creation)
+{
+    RTT_ASSERT(RTNotifierFd(&gNotifier) >= 0);
+    RTT_ASSERT(!RTNotifierClear(&gNotifier));
+}
+RTT_TEST_END
+
+RTT_TEST_START(fifo_notifier_should_be_raised_once_per_burst)
+{
+    TItem item = { 0 };
+
+    RTT_ASSERT(RTFifoPush(&gNotifiedFifo, &item, sizeof(item)));
+    RTT_ASSERT(RTFifoPush(&gNotifiedFifo, &item, sizeof(item)));
+    RTT_ASSERT(RTNotifierClear(&gNotifier));
+    RTT_ASSERT(RTFifoPush(&gNotifiedFifo, &item, sizeof(item)));
+    RTT_ASSERT(!RTNotifierClear(&gNotifier));
+}
+RTT_TEST_END
+
+RTT_TEST_START(fifo_notifier_should_be_raised_again_after_emptying)
+{
+    TItem items[3];
+    TItem* slot;
+
+    RTT_ASSERT(RTFifoPopN(&gNotifiedFifo, items, 3) == 3u);
+    RTT_ASSERT(!RTNotifierClear(&gNotifier));
+
+    RTT_ASSERT(RTFifoPushN(&gNotifiedFifo, items, 2) == 2u);
+    RTT_ASSERT(RTNotifierClear(&gNotifier));
+    RTT_ASSERT(RTFifoPopN(&gNotifiedFifo, items, 3) == 2u);
+
+    slot = RTFifoReserve(&gNotifiedFifo);
+    RTT_ASSERT(slot != NULL);
+    RTFifoCommit(&gNotifiedFifo);
+    RTT_ASSERT(RTNotifierClear(&gNotifier));
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestFifoNotifier,
+        fifo_notifier_should_not_be_raised_after_creation,
+        fifo_notifier_should_be_raised_once_per_burst,
+        fifo_notifier_should_be_raised_again_after_emptying)
+
+
+static TSmallItem gOverwriteSmallBuffer[3];
+static RTSmallFifo gOverwriteSmallFifo
+        = RT_SMALL_FIFO_INIT(gOverwriteSmallBuffer);
+static TItem gOverwriteBuffer[3];
+static RTFifo gOverwriteFifo = RT_FIFO_INIT(gOverwriteBuffer);
+
+RTT_GROUP_START(TestFifoOverwrite, 0x00020011u, NULL, NULL)
+
+RTT_TEST_START(small_fifo_should_not_drop_when_not_full)
+{
+    TSmallItem item = { 0, 0 };
+    uint16_t i;
+
+    for (i = 0; i < 3; i++) {
+        item.a = i;
+        RTT_ASSERT(!RTSmallFifoPushOverwrite(&gOverwriteSmallFifo, &item,
+                    sizeof(item)));
+    }
+    RTT_ASSERT(RTSmallFifoIsFull(&gOverwriteSmallFifo));
+    RTT_EXPECT(RTSmallFifoDropCount(&gOverwriteSmallFifo) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(small_fifo_should_drop_oldest_when_full)
+{
+    TSmallItem item = { 0, 0 };
+    uint16_t i;
+
+    for (i = 3; i < 8; i++) {
+        item.a = i;
+        RTT_ASSERT(RTSmallFifoPushOverwrite(&gOverwriteSmallFifo, &item,
+                    sizeof(item)));
+    }
+    RTT_ASSERT(RTSmallFifoSize(&gOverwriteSmallFifo) == 3);
+    RTT_ASSERT(RTSmallFifoDropCount(&gOverwriteSmallFifo) == 5);
+    for (i = 5; i < 8; i++) {
+        RTT_ASSERT(RTSmallFifoPop(&gOverwriteSmallFifo, &item, sizeof(item)));
+        RTT_EXPECT(item.a == i);
+    }
+    RTT_ASSERT(RTSmallFifoIsEmpty(&gOverwriteSmallFifo));
+}
+RTT_TEST_END
+
+RTT_TEST_START(small_fifo_should_reset_drop_count)
+{
+    RTSmallFifoResetDropCount(&gOverwriteSmallFifo);
+    RTT_EXPECT(RTSmallFifoDropCount(&gOverwriteSmallFifo) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(fifo_should_drop_oldest_when_full)
+{
+    TItem item;
+    uint32_t i;
+
+    item.b = 0;
+    for (i = 0; i < 10; i++) {
+        item.a = i;
+        RTT_ASSERT(RTFifoPushOverwrite(&gOverwriteFifo, &item, sizeof(item))
+                == (i >= 3));
+    }
+    RTT_ASSERT(RTFifoSize(&gOverwriteFifo) == 3);
+    RTT_ASSERT(RTFifoDropCount(&gOverwriteFifo) == 7);
+    for (i = 7; i < 10; i++) {
+        RTT_ASSERT(RTFifoPop(&gOverwriteFifo, &item, sizeof(item)));
+        RTT_EXPECT(item.a == i);
+    }
+    RTT_ASSERT(RTFifoIsEmpty(&gOverwriteFifo));
+}
+RTT_TEST_END
+
+RTT_TEST_START(fifo_should_keep_drop_count_until_reset)
+{
+    TItem item;
+
+    item.a = 1;
+    item.b = 0;
+    RTT_ASSERT(!RTFifoPushOverwrite(&gOverwriteFifo, &item, sizeof(item)));
+    RTT_ASSERT(RTFifoDropCount(&gOverwriteFifo) == 7);
+    RTFifoResetDropCount(&gOverwriteFifo);
+    RTT_EXPECT(RTFifoDropCount(&gOverwriteFifo) == 0);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestFifoOverwrite,
+        small_fifo_should_not_drop_when_not_full,
+        small_fifo_should_drop_oldest_when_full,
+        small_fifo_should_reset_drop_count,
+        fifo_should_drop_oldest_when_full,
+        fifo_should_keep_drop_count_until_reset)
+
+
+#if RTFIFO_STATS
+static TSmallItem gStatsSmallBuffer[4];
+static RTSmallFifo gStatsSmallFifo = RT_SMALL_FIFO_INIT(gStatsSmallBuffer);
+static TItem gStatsBuffer[8];
+static RTFifo gStatsFifo = RT_FIFO_INIT(gStatsBuffer);
+static TItem gStatsItems[10];
+
+RTT_GROUP_START(TestFifoStats, 0x00020013u, NULL, NULL)
+
+RTT_TEST_START(small_fifo_stats_should_count_pushes_and_pops)
+{
+    TSmallItem item = { 0, 0 };
+    RTFifoStats stats;
+    int i;
+
+    RTT_ASSERT(!RTSmallFifoPop(&gStatsSmallFifo, &item, sizeof(item)));
+    for (i = 0; i < 5; i++) {
+        (void)RTSmallFifoPush(&gStatsSmallFifo, &item, sizeof(item));
+    }
+    RTT_ASSERT(RTSmallFifoPop(&gStatsSmallFifo, &item, sizeof(item)));
+
+    RTSmallFifoReadStats(&gStatsSmallFifo, &stats, RTTrue);
+    RTT_EXPECT(stats.pushes == 4u);
+    RTT_EXPECT(stats.pops == 1u);
+    RTT_EXPECT(stats.pushFailures == 1u);
+    RTT_EXPECT(stats.popFailures == 1u);
+    RTT_EXPECT(stats.highWatermark == 4u);
+    for (i = 0; i < RTFIFO_STATS_BINS; i += 2) {
+        RTT_EXPECT(stats.histogram[i] == 0);
+        RTT_EXPECT(stats.histogram[i + 1] == 1u);
+    }
+}
+RTT_TEST_END
+
+RTT_TEST_START(small_fifo_stats_should_restart_from_current_size)
+{
+    RTFifoStats stats;
+
+    RTSmallFifoReadStats(&gStatsSmallFifo, &stats, RTFalse);
+    RTT_EXPECT(stats.pushes == 0);
+    RTT_EXPECT(stats.pops == 0);
+    RTT_EXPECT(stats.pushFailures == 0);
+    RTT_EXPECT(stats.popFailures == 0);
+    RTT_EXPECT(stats.highWatermark == 3u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(fifo_stats_should_count_bulk_and_zero_copy)
+{
+    RTFifoStats stats;
+
+    RTT_ASSERT(RTFifoPushN(&gStatsFifo, gStatsItems, 10) == 8u);
+    RTT_ASSERT(RTFifoReserve(&gStatsFifo) == NULL);
+    RTT_ASSERT(RTFifoPopN(&gStatsFifo, gStatsItems, 3) == 3u);
+    RTT_ASSERT(RTFifoReserve(&gStatsFifo) != NULL);
+    RTFifoCommit(&gStatsFifo);
+    RTT_ASSERT(RTFifoPeek(&gStatsFifo) != NULL);
+    RTFifoRelease(&gStatsFifo);
+    RTT_ASSERT(RTFifoPopN(&gStatsFifo, gStatsItems, 10) == 5u);
+    RTT_ASSERT(RTFifoPeek(&gStatsFifo) == NULL);
+
+    RTFifoReadStats(&gStatsFifo, &stats, RTTrue);
+    RTT_EXPECT(stats.pushes == 9u);
+    RTT_EXPECT(stats.pops == 9u);
+    RTT_EXPECT(stats.pushFailures == 2u);
+    RTT_EXPECT(stats.popFailures == 1u);
+    RTT_EXPECT(stats.highWatermark == 8u);
+    RTT_EXPECT(stats.histogram[RTFIFO_STATS_BINS - 1] == 1u);
+    RTT_EXPECT(stats.histogram[5] == 1u);
+
+    RTFifoReadStats(&gStatsFifo, &stats, RTFalse);
+    RTT_EXPECT(stats.pushes == 0);
+    RTT_EXPECT(stats.highWatermark == 0);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestFifoStats,
+        small_fifo_stats_should_count_pushes_and_pops,
+        small_fifo_stats_should_restart_from_current_size,
+        fifo_stats_should_count_bulk_and_zero_copy)
+#endif
+
+
+typedef struct {
+    uint32_t count;
+    uint32_t sum;
+    uint32_t last;
+} TDrainCtx;
+
+static void testFifoHandler(void* ctx, const void* item)
+{
+    TDrainCtx* c = ctx;
+    const TItem* i = item;
+
+    c->count++;
+    c->sum += i->a;
+    c->last = i->a;
+}
+
+static TItem gDrainBuffer[5];
+static RTFifo gDrainFifo = RT_FIFO_INIT(gDrainBuffer);
+
+RTT_GROUP_START(TestFifoDrain, 0x00020014u, NULL, NULL)
+
+RTT_TEST_START(fifo_drain_should_do_nothing_when_empty)
+{
+    TDrainCtx ctx = { 0, 0, 0 };
+
+    RTT_ASSERT(RTFifoDrain(&gDrainFifo, testFifoHandler, &ctx, 10) == 0);
+    RTT_ASSERT(RTFifoForEach(&gDrainFifo, testFifoHandler, &ctx) == 0);
+    RTT_EXPECT(ctx.count == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(fifo_for_each_should_visit_wrapped_items_in_order)
+{
+    TDrainCtx ctx = { 0, 0, 0 };
+    TItem item;
+    uint32_t i;
+
+    /* Move the tail to the middle of the buffer, so the items wrap */
+    item.b = 0;
+    for (i = 0; i < 3; i++) {
+        item.a = 0;
+        RTT_ASSERT(RTFifoPush(&gDrainFifo, &item, sizeof(item)));
+        RTT_ASSERT(RTFifoPop(&gDrainFifo, &item, sizeof(item)));
+    }
+    for (i = 1; i <= 5; i++) {
+        item.a = i;
+        RTT_ASSERT(RTFifoPush(&gDrainFifo, &item, sizeof(item)));
+    }
+    RTT_ASSERT(RTFifoForEach(&gDrainFifo, testFifoHandler, &ctx) == 5u);
+    RTT_EXPECT(ctx.count == 5u);
+    RTT_EXPECT(ctx.sum == 15u);
+    RTT_EXPECT(ctx.last == 5u);
+    RTT_EXPECT(RTFifoSize(&gDrainFifo) == 5u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(fifo_drain_should_stop_after_max_items)
+{
+    TDrainCtx ctx = { 0, 0, 0 };
+    TItem item;
+
+    RTT_ASSERT(RTFifoDrain(&gDrainFifo, testFifoHandler, &ctx, 3) == 3u);
+    RTT_EXPECT(ctx.sum == 6u);
+    RTT_EXPECT(ctx.last == 3u);
+    RTT_ASSERT(RTFifoSize(&gDrainFifo) == 2u);
+    RTT_ASSERT(RTFifoPop(&gDrainFifo, &item, sizeof(item)));
+    RTT_EXPECT(item.a == 4u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(fifo_drain_should_empty_the_fifo)
+{
+    TDrainCtx ctx = { 0, 0, 0 };
+
+    RTT_ASSERT(RTFifoDrain(&gDrainFifo, testFifoHandler, &ctx, 10) == 1u);
+    RTT_EXPECT(ctx.last == 5u);
+    RTT_ASSERT(RTFifoIsEmpty(&gDrainFifo));
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestFifoDrain,
+        fifo_drain_should_do_nothing_when_empty,
+        fifo_for_each_should_visit_wrapped_items_in_order,
+        fifo_drain_should_stop_after_max_items,
+        fifo_drain_should_empty_the_fifo)
@@ -0,0 +1,242 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtjournalfifo.h"
+#include "rttest.h"
+#include "rtplf.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+#define TEST_JOURNAL_PATH "test-rtjournalfifo.jnl"
+#define TEST_JOURNAL_OTHER_PATH "test-rtjournalfifo.bin"
+#define TEST_JOURNAL_CAPACITY 4u
+
+
+typedef struct {
+    uint32_t seq;
+    uint32_t check;
+} TJournalItem;
+
+
+/** Push the items `first` to `last` (excluded) into a journal FIFO
+ *
+ * @return `RTTrue` if all the items have been pushed, `RTFalse` otherwise
+ */
+static RTBool testJournalPush(RTJournalFifo* fifo, uint32_t first,
+        uint32_t last)
+{
+    RTBool ok = RTTrue;
+    TJournalItem item;
+
+    for (item.seq = first; ok && (item.seq < last); item.seq++) {
+        item.check = ~item.seq;
+        ok = RTJournalFifoPush(fifo, &item, sizeof(item));
+    }
+    return ok;
+}
+
+
+/** Pop `count` items from a journal FIFO and check they are in order
+ *
+ * @return `RTTrue` if the items `first` to `first + count` (excluded) have
+ *         been popped, `RTFalse` otherwise
+ */
+static RTBool testJournalPop(RTJournalFifo* fifo, uint32_t first,
+        uint32_t count)
+{
+    RTBool ok = RTTrue;
+    TJournalItem item;
+    uint32_t i;
+
+    for (i = 0; ok && (i < count); i++) {
+        ok = RTJournalFifoPop(fifo, &item, sizeof(item))
+            && (item.seq == (first + i)) && (item.check == ~item.seq);
+    }
+    return ok;
+}
+
+
+/** Get the size of a file, or -1 if it can't be found */
+static long testJournalFileSize(const char* path)
+{
+    struct stat st;
+    long size_B = -1;
+
+    if (stat(path, &st) == 0) {
+        size_B = (long)st.st_size;
+    }
+    return size_B;
+}
+
+
+static RTBool testJournalEntry(void)
+{
+    (void)unlink(TEST_JOURNAL_PATH);
+    (void)unlink(TEST_JOURNAL_OTHER_PATH);
+    return RTTrue;
+}
+
+
+static RTBool testJournalExit(void)
+{
+    (void)unlink(TEST_JOURNAL_OTHER_PATH);
+    return unlink(TEST_JOURNAL_PATH) == 0;
+}
+
+
+RTT_GROUP_START(TestJournalFifo, 0x00020018u, testJournalEntry,
+        testJournalExit)
+
+RTT_TEST_START(journal_fifo_should_be_empty_after_creation)
+{
+    RTJournalFifo fifo;
+    TJournalItem item;
+
+    RTT_ASSERT(RTJournalFifoOpen(&fifo, TEST_JOURNAL_PATH,
+                TEST_JOURNAL_CAPACITY, sizeof(TJournalItem)));
+    RTT_EXPECT(RTJournalFifoCapacity(&fifo) == TEST_JOURNAL_CAPACITY);
+    RTT_EXPECT(RTJournalFifoSize(&fifo) == 0);
+    RTT_EXPECT(RTJournalFifoIsEmpty(&fifo));
+    RTT_EXPECT(!RTJournalFifoIsFull(&fifo));
+    RTT_EXPECT(!RTJournalFifoPop(&fifo, &item, sizeof(item)));
+    RTJournalFifoClose(&fifo);
+}
+RTT_TEST_END
+
+RTT_TEST_START(journal_fifo_should_not_open_with_other_geometry)
+{
+    RTJournalFifo fifo;
+    long size_B = testJournalFileSize(TEST_JOURNAL_PATH);
+
+    RTT_ASSERT(size_B > 0);
+    RTT_EXPECT(!RTJournalFifoOpen(&fifo, TEST_JOURNAL_PATH,
+                TEST_JOURNAL_CAPACITY + 1000u, sizeof(TJournalItem)));
+    RTT_EXPECT(!RTJournalFifoOpen(&fifo, TEST_JOURNAL_PATH,
+                TEST_JOURNAL_CAPACITY, sizeof(TJournalItem) + 1u));
+    RTT_EXPECT(testJournalFileSize(TEST_JOURNAL_PATH) == size_B);
+}
+RTT_TEST_END
+
+RTT_TEST_START(journal_fifo_should_not_overwrite_other_files)
+{
+    static const RTByte zeros[64] = { 0 };
+    RTJournalFifo fifo;
+    int fd;
+
+    fd = open(TEST_JOURNAL_OTHER_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    RTT_ASSERT(fd >= 0);
+    RTT_ASSERT(write(fd, zeros, sizeof(zeros)) == (ssize_t)sizeof(zeros));
+    RTT_ASSERT(close(fd) == 0);
+
+    RTT_EXPECT(!RTJournalFifoOpen(&fifo, TEST_JOURNAL_OTHER_PATH,
+                TEST_JOURNAL_CAPACITY, sizeof(TJournalItem)));
+    RTT_EXPECT(testJournalFileSize(TEST_JOURNAL_OTHER_PATH)
+            == (long)sizeof(zeros));
+    RTT_EXPECT(unlink(TEST_JOURNAL_OTHER_PATH) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(journal_fifo_should_reuse_slots_once_pops_are_committed)
+{
+    RTJournalFifo fifo;
+
+    RTT_ASSERT(RTJournalFifoOpen(&fifo, TEST_JOURNAL_PATH,
+                TEST_JOURNAL_CAPACITY, sizeof(TJournalItem)));
+    RTT_ASSERT(testJournalPush(&fifo, 0, 4));
+    RTT_EXPECT(RTJournalFifoIsFull(&fifo));
+    RTT_ASSERT(testJournalPop(&fifo, 0, 2));
+    RTT_EXPECT(RTJournalFifoSize(&fifo) == 2u);
+    RTT_EXPECT(RTJournalFifoIsFull(&fifo));
+    RTT_EXPECT(!testJournalPush(&fifo, 4, 5));
+    RTT_ASSERT(RTJournalFifoCommit(&fifo));
+    RTT_EXPECT(!RTJournalFifoIsFull(&fifo));
+    RTT_ASSERT(testJournalPush(&fifo, 4, 6));
+    RTT_ASSERT(testJournalPop(&fifo, 2, 4));
+    RTT_ASSERT(RTJournalFifoCommit(&fifo));
+    RTT_EXPECT(RTJournalFifoIsEmpty(&fifo));
+    RTJournalFifoClose(&fifo);
+}
+RTT_TEST_END
+
+RTT_TEST_START(journal_fifo_should_reopen_as_of_last_commit)
+{
+    RTJournalFifo fifo;
+
+    RTT_ASSERT(RTJournalFifoOpen(&fifo, TEST_JOURNAL_PATH,
+                TEST_JOURNAL_CAPACITY, sizeof(TJournalItem)));
+    RTT_EXPECT(RTJournalFifoIsEmpty(&fifo));
+    RTT_ASSERT(testJournalPush(&fifo, 10, 13));
+    RTT_ASSERT(RTJournalFifoCommit(&fifo));
+    RTT_ASSERT(testJournalPop(&fifo, 10, 2));
+    RTT_ASSERT(testJournalPush(&fifo, 13, 14));
+    RTJournalFifoClose(&fifo);
+
+    /* The uncommitted pops and push are forgotten */
+    RTT_ASSERT(RTJournalFifoOpen(&fifo, TEST_JOURNAL_PATH,
+                TEST_JOURNAL_CAPACITY, sizeof(TJournalItem)));
+    RTT_EXPECT(RTJournalFifoSize(&fifo) == 3u);
+    RTT_ASSERT(testJournalPop(&fifo, 10, 3));
+    RTT_EXPECT(RTJournalFifoIsEmpty(&fifo));
+    RTT_ASSERT(RTJournalFifoCommit(&fifo));
+    RTJournalFifoClose(&fifo);
+}
+RTT_TEST_END
+
+RTT_TEST_START(journal_fifo_should_resume_after_a_crash)
+{
+    RTJournalFifo fifo;
+    pid_t pid;
+    int status;
+
+    pid = fork();
+    RTT_ASSERT(pid >= 0);
+    if (pid == 0) {
+        /* Child process: commit 3 items and 1 pop, then die without
+         * committing or closing anything */
+        if (!RTJournalFifoOpen(&fifo, TEST_JOURNAL_PATH,
+                    TEST_JOURNAL_CAPACITY, sizeof(TJournalItem))
+                || !testJournalPush(&fifo, 20, 23)
+                || !testJournalPop(&fifo, 20, 1)
+                || !RTJournalFifoCommit(&fifo)
+                || !testJournalPop(&fifo, 21, 2)
+                || !testJournalPush(&fifo, 23, 25)) {
+            _exit(1);
+        }
+        _exit(0);
+    }
+    RTT_ASSERT(waitpid(pid, &status, 0) == pid);
+    RTT_ASSERT(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+
+    RTT_ASSERT(RTJournalFifoOpen(&fifo, TEST_JOURNAL_PATH,
+                TEST_JOURNAL_CAPACITY, sizeof(TJournalItem)));
+    RTT_EXPECT(RTJournalFifoSize(&fifo) == 2u);
+    RTT_ASSERT(testJournalPop(&fifo, 21, 2));
+    RTT_EXPECT(RTJournalFifoIsEmpty(&fifo));
+    RTJournalFifoClose(&fifo);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestJournalFifo,
+        journal_fifo_should_be_empty_after_creation,
+        journal_fifo_should_not_open_with_other_geometry,
+        journal_fifo_should_not_overwrite_other_files,
+        journal_fifo_should_reuse_slots_once_pops_are_committed,
+        journal_fifo_should_reopen_as_of_last_commit,
+        journal_fifo_should_resume_after_a_crash)
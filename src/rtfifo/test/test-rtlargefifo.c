@@ -0,0 +1,87 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtlargefifo.h"
+#include "rttest.h"
+#include "rtplf.h"
+
+
+#define TEST_LARGE_CAPACITY 100000u
+#define TEST_LARGE_ITEM_B 70000u
+
+static uint32_t gLargeBuffer[TEST_LARGE_CAPACITY];
+static RTLargeFifo gLargeFifo = RT_LARGE_FIFO_INIT(gLargeBuffer);
+
+static RTByte gBigItemBuffer[3 * TEST_LARGE_ITEM_B];
+static RTByte gBigItem[TEST_LARGE_ITEM_B];
+
+RTT_GROUP_START(TestLargeFifo, 0x0002000Cu, NULL, NULL)
+
+RTT_TEST_START(largefifo_should_be_empty_after_creation)
+{
+    RTT_ASSERT(RTLargeFifoIsEmpty(&gLargeFifo));
+    RTT_ASSERT(!RTLargeFifoIsFull(&gLargeFifo));
+    RTT_ASSERT(RTLargeFifoSize(&gLargeFifo) == 0);
+    RTT_ASSERT(RTLargeFifoCapacity(&gLargeFifo) == TEST_LARGE_CAPACITY);
+}
+RTT_TEST_END
+
+RTT_TEST_START(largefifo_should_hold_more_than_65535_items)
+{
+    uint32_t item;
+    uint32_t i;
+
+    for (i = 0; i < TEST_LARGE_CAPACITY; i++) {
+        RTT_ASSERT(RTLargeFifoPush(&gLargeFifo, &i, sizeof(i)));
+    }
+    RTT_ASSERT(RTLargeFifoIsFull(&gLargeFifo));
+    RTT_ASSERT(RTLargeFifoSize(&gLargeFifo) == TEST_LARGE_CAPACITY);
+    RTT_ASSERT(!RTLargeFifoPush(&gLargeFifo, &i, sizeof(i)));
+
+    for (i = 0; i < TEST_LARGE_CAPACITY; i++) {
+        RTT_ASSERT(RTLargeFifoPop(&gLargeFifo, &item, sizeof(item)));
+        RTT_ASSERT(item == i);
+    }
+    RTT_ASSERT(RTLargeFifoIsEmpty(&gLargeFifo));
+    RTT_ASSERT(!RTLargeFifoPop(&gLargeFifo, &item, sizeof(item)));
+}
+RTT_TEST_END
+
+RTT_TEST_START(largefifo_should_hold_items_larger_than_65535_bytes)
+{
+    RTLargeFifo fifo;
+    uint32_t i;
+
+    RTLargeFifoInit(&fifo, 3, TEST_LARGE_ITEM_B, gBigItemBuffer);
+    for (i = 0; i < 5u; i++) {
+        gBigItem[0] = (RTByte)i;
+        gBigItem[TEST_LARGE_ITEM_B - 1u] = (RTByte)(0x80u + i);
+        RTT_ASSERT(RTLargeFifoPush(&fifo, gBigItem, sizeof(gBigItem)));
+        if (i >= 1u) {
+            RTT_ASSERT(RTLargeFifoPop(&fifo, gBigItem, sizeof(gBigItem)));
+            RTT_EXPECT(gBigItem[0] == (RTByte)(i - 1u));
+            RTT_EXPECT(gBigItem[TEST_LARGE_ITEM_B - 1u]
+                    == (RTByte)(0x80u + i - 1u));
+        }
+    }
+    RTT_ASSERT(RTLargeFifoSize(&fifo) == 1u);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestLargeFifo,
+        largefifo_should_be_empty_after_creation,
+        largefifo_should_hold_more_than_65535_items,
+        largefifo_should_hold_items_larger_than_65535_bytes)
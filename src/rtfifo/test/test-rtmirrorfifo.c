@@ -0,0 +1,111 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtmirrorfifo.h"
+#include "rttest.h"
+#include "rtplf.h"
+
+
+static RTMirrorFifo gMirrorFifo;
+static RTByte gMirrorData[1000];
+
+
+static RTBool TestMirrorFifoEntry(void)
+{
+    uint32_t i;
+    for (i = 0; i < sizeof(gMirrorData); i++) {
+        gMirrorData[i] = (RTByte)(i * 7u);
+    }
+    return RTMirrorFifoCreate(&gMirrorFifo, 1000);
+}
+
+static RTBool TestMirrorFifoExit(void)
+{
+    RTMirrorFifoDestroy(&gMirrorFifo);
+    return RTTrue;
+}
+
+RTT_GROUP_START(TestMirrorFifo, 0x00020010u, TestMirrorFifoEntry,
+        TestMirrorFifoExit)
+
+RTT_TEST_START(mirrorfifo_should_be_empty_after_creation)
+{
+    size_t span_B;
+    RTT_ASSERT(RTMirrorFifoSize(&gMirrorFifo) == 0);
+    RTT_ASSERT(RTMirrorFifoCapacity(&gMirrorFifo) >= 1000u);
+    RTT_ASSERT(RTMirrorFifoPeek(&gMirrorFifo, &span_B) != NULL);
+    RTT_ASSERT(span_B == 0);
+    RTT_ASSERT(RTMirrorFifoRead(&gMirrorFifo, gMirrorData, 1) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(mirrorfifo_should_see_wrapped_data_as_one_span)
+{
+    size_t capacity_B = RTMirrorFifoCapacity(&gMirrorFifo);
+    const RTByte* data;
+    RTByte* space;
+    size_t span_B;
+    size_t i;
+
+    /* Move head and tail close to the end of the buffer */
+    space = RTMirrorFifoReserve(&gMirrorFifo, &span_B);
+    RTT_ASSERT(span_B == capacity_B);
+    RTMirrorFifoCommit(&gMirrorFifo, capacity_B - 100u);
+    RTMirrorFifoRelease(&gMirrorFifo, capacity_B - 100u);
+    RTT_ASSERT(RTMirrorFifoSize(&gMirrorFifo) == 0);
+
+    /* Write 1000 bytes, which wraps around */
+    RTT_ASSERT(RTMirrorFifoWrite(&gMirrorFifo, gMirrorData,
+                sizeof(gMirrorData)) == sizeof(gMirrorData));
+    data = RTMirrorFifoPeek(&gMirrorFifo, &span_B);
+    RTT_ASSERT(span_B == sizeof(gMirrorData));
+    for (i = 0; i < span_B; i++) {
+        RTT_ASSERT(data[i] == gMirrorData[i]);
+    }
+    RTT_ASSERT(data == (space + capacity_B - 100u));
+}
+RTT_TEST_END
+
+RTT_TEST_START(mirrorfifo_should_fill_up_and_read_back)
+{
+    size_t capacity_B = RTMirrorFifoCapacity(&gMirrorFifo);
+    RTByte* space;
+    RTByte byte;
+    size_t span_B;
+    size_t i;
+
+    space = RTMirrorFifoReserve(&gMirrorFifo, &span_B);
+    RTT_ASSERT(span_B == (capacity_B - sizeof(gMirrorData)));
+    for (i = 0; i < span_B; i++) {
+        space[i] = (RTByte)i;
+    }
+    RTMirrorFifoCommit(&gMirrorFifo, span_B);
+    RTT_ASSERT(RTMirrorFifoSize(&gMirrorFifo) == capacity_B);
+    RTT_ASSERT(RTMirrorFifoWrite(&gMirrorFifo, gMirrorData, 1) == 0);
+
+    RTMirrorFifoRelease(&gMirrorFifo, sizeof(gMirrorData));
+    for (i = 0; i < (capacity_B - sizeof(gMirrorData)); i++) {
+        RTT_ASSERT(RTMirrorFifoRead(&gMirrorFifo, &byte, 1) == 1u);
+        RTT_ASSERT(byte == (RTByte)i);
+    }
+    RTT_ASSERT(RTMirrorFifoSize(&gMirrorFifo) == 0);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestMirrorFifo,
+        mirrorfifo_should_be_empty_after_creation,
+        mirrorfifo_should_see_wrapped_data_as_one_span,
+        mirrorfifo_should_fill_up_and_read_back)
@@ -0,0 +1,305 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtmpmcfifo.h"
+#include "rttest.h"
+#include "rtplf.h"
+#include <pthread.h>
+#include <sched.h>
+
+
+#define TEST_MPMC_PRODUCERS 3
+#define TEST_MPMC_CONSUMERS 3
+#define TEST_MPMC_ITEMS_PER_PRODUCER 50000u
+#define TEST_MPMC_ITEMS (TEST_MPMC_PRODUCERS * TEST_MPMC_ITEMS_PER_PRODUCER)
+
+
+typedef struct {
+    uint32_t a;
+    int16_t b;
+} TMpmcItem;
+
+static TMpmcItem gMpmcBuffer[10];
+static uint32_t gMpmcSeqs[10];
+static RTMpmcFifo gMpmcFifo = RT_MPMC_FIFO_INIT(gMpmcBuffer, gMpmcSeqs);
+
+static TMpmcItem gStressBuffer[8];
+static uint32_t gStressSeqs[8];
+static RTMpmcFifo gStressFifo;
+static uint32_t gStressSeen[TEST_MPMC_ITEMS];
+static uint32_t gStressPopped;
+static uint32_t gStressConsumed[TEST_MPMC_CONSUMERS];
+
+
+/** Push this producer's share of the `TEST_MPMC_ITEMS` numbered items */
+static void* testMpmcProducer(void* arg)
+{
+    uint32_t first = (uint32_t)(long)arg * TEST_MPMC_ITEMS_PER_PRODUCER;
+    TMpmcItem item;
+    uint32_t i;
+
+    for (i = first; i < (first + TEST_MPMC_ITEMS_PER_PRODUCER); i++) {
+        item.a = i;
+        item.b = (int16_t)i;
+        while (!RTMpmcFifoPush(&gStressFifo, &item, sizeof(item))) {
+            sched_yield(); /* Let the consumers run, even on a single CPU */
+        }
+    }
+    return NULL;
+}
+
+
+/** Pop items and tick them in `gStressSeen` until all items are popped */
+static void* testMpmcConsumer(void* arg)
+{
+    long consumer = (long)arg;
+    TMpmcItem item;
+
+    while (RTATOMIC_LOAD_ACQUIRE(&gStressPopped) < TEST_MPMC_ITEMS) {
+        if (RTMpmcFifoPop(&gStressFifo, &item, sizeof(item))) {
+            if ((item.a < TEST_MPMC_ITEMS) && (item.b == (int16_t)item.a)) {
+                RTATOMIC_FETCH_ADD(&gStressSeen[item.a], 1u);
+            }
+            gStressConsumed[consumer]++;
+            RTATOMIC_FETCH_ADD(&gStressPopped, 1u);
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+
+RTT_GROUP_START(TestMpmcFifo, 0x00020005u, NULL, NULL)
+
+RTT_TEST_START(mpmcfifo_should_be_empty_after_creation)
+{
+    TMpmcItem item;
+
+    RTT_ASSERT(RTMpmcFifoCapacity(&gMpmcFifo) == 10u);
+    RTT_ASSERT(RTMpmcFifoIsEmpty(&gMpmcFifo));
+    RTT_ASSERT(!RTMpmcFifoIsFull(&gMpmcFifo));
+    RTT_ASSERT(RTMpmcFifoSize(&gMpmcFifo) == 0);
+    RTT_ASSERT(!RTMpmcFifoPop(&gMpmcFifo, &item, sizeof(item)));
+}
+RTT_TEST_END
+
+RTT_TEST_START(mpmcfifo_should_work_with_a_capacity_of_1)
+{
+    RTMpmcFifo fifo;
+    TMpmcItem buffer[1];
+    uint32_t seqs[1];
+    TMpmcItem item;
+    uint32_t i;
+
+    seqs[0] = 0xDeadBeef;
+    RTMpmcFifoInit(&fifo, 1, sizeof(item), (RTByte*)buffer, seqs);
+    RTT_ASSERT(RTMpmcFifoCapacity(&fifo) == 1u);
+    for (i = 0; i < 50u; i++) {
+        item.a = i;
+        item.b = 0;
+        RTT_ASSERT(RTMpmcFifoPush(&fifo, &item, sizeof(item)));
+        RTT_ASSERT(RTMpmcFifoIsFull(&fifo));
+        RTT_ASSERT(!RTMpmcFifoPush(&fifo, &item, sizeof(item)));
+        RTT_ASSERT(RTMpmcFifoPop(&fifo, &item, sizeof(item)));
+        RTT_EXPECT(item.a == i);
+        RTT_ASSERT(!RTMpmcFifoPop(&fifo, &item, sizeof(item)));
+    }
+}
+RTT_TEST_END
+
+RTT_TEST_START(mpmcfifo_should_hand_out_every_item_exactly_once)
+{
+    pthread_t producers[TEST_MPMC_PRODUCERS];
+    pthread_t consumers[TEST_MPMC_CONSUMERS];
+    uint32_t consumed = 0;
+    uint32_t i;
+    long t;
+
+    RTMpmcFifoInit(&gStressFifo, RTARRAYSIZE(gStressBuffer),
+            sizeof(gStressBuffer[0]), (RTByte*)gStressBuffer, gStressSeqs);
+    gStressPopped = 0;
+    for (t = 0; t < TEST_MPMC_CONSUMERS; t++) {
+        gStressConsumed[t] = 0;
+        RTT_ASSERT(pthread_create(&consumers[t], NULL, testMpmcConsumer,
+                    (void*)t) == 0);
+    }
+    for (t = 0; t < TEST_MPMC_PRODUCERS; t++) {
+        RTT_ASSERT(pthread_create(&producers[t], NULL, testMpmcProducer,
+                    (void*)t) == 0);
+    }
+    for (t = 0; t < TEST_MPMC_PRODUCERS; t++) {
+        pthread_join(producers[t], NULL);
+    }
+    for (t = 0; t < TEST_MPMC_CONSUMERS; t++) {
+        pthread_join(consumers[t], NULL);
+        consumed += gStressConsumed[t];
+    }
+
+    RTT_ASSERT(consumed == TEST_MPMC_ITEMS);
+    RTT_ASSERT(RTMpmcFifoIsEmpty(&gStressFifo));
+    for (i = 0; i < TEST_MPMC_ITEMS; i++) {
+        RTT_ASSERT(gStressSeen[i] == 1u);
+    }
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestMpmcFifo,
+        mpmcfifo_should_be_empty_after_creation,
+        mpmcfifo_should_work_with_a_capacity_of_1,
+        mpmcfifo_should_hand_out_every_item_exactly_once)
+
+static TMpmcItem gMpmcWaitBuffer[2];
+static uint32_t gMpmcWaitSeqs[2];
+static RTMpmcFifo gMpmcWaitFifo = RT_MPMC_FIFO_INIT(gMpmcWaitBuffer,
+        gMpmcWaitSeqs);
+static uint32_t gMpmcIdleDone;
+
+
+/** Wait 20 ms, then push one item into `gMpmcWaitFifo` */
+static void* testMpmcDelayedPush(void* arg)
+{
+    uint32_t dummy = 0;
+    TMpmcItem item;
+
+    (void)RTWait(&dummy, 0, 20);
+    item.a = 1234u;
+    item.b = 0;
+    RTASSERT(RTMpmcFifoPush(&gMpmcWaitFifo, &item, sizeof(item)));
+    return NULL;
+}
+
+
+/** Pop one item from `gMpmcWaitFifo`, waiting forever, then set
+ * `gMpmcIdleDone` */
+static void* testMpmcIdleWaiter(void* arg)
+{
+    TMpmcItem item;
+
+    item.a = 0;
+    RTASSERT(RTMpmcFifoPopWait(&gMpmcWaitFifo, &item, sizeof(item),
+                RTWAIT_FOREVER));
+    RTASSERT(item.a == 4321u);
+    RTATOMIC_STORE_RELEASE(&gMpmcIdleDone, 1u);
+    return NULL;
+}
+
+
+/** Wait 20 ms, then pop one item from `gMpmcWaitFifo` */
+static void* testMpmcDelayedPop(void* arg)
+{
+    uint32_t dummy = 0;
+    TMpmcItem item;
+
+    (void)RTWait(&dummy, 0, 20);
+    RTASSERT(RTMpmcFifoPop(&gMpmcWaitFifo, &item, sizeof(item)));
+    return NULL;
+}
+
+
+RTT_GROUP_START(TestMpmcFifoWait, 0x0002000Du, NULL, NULL)
+
+RTT_TEST_START(mpmcfifo_popwait_should_time_out_when_empty)
+{
+    TMpmcItem item;
+    uint32_t start_us = RTNow_us();
+
+    RTT_ASSERT(!RTMpmcFifoPopWait(&gMpmcWaitFifo, &item, sizeof(item), 20));
+    RTT_EXPECT((RTNow_us() - start_us) >= 19000u);
+    RTT_ASSERT(!RTMpmcFifoPopWait(&gMpmcWaitFifo, &item, sizeof(item), 0));
+}
+RTT_TEST_END
+
+RTT_TEST_START(mpmcfifo_popwait_should_block_until_item_is_pushed)
+{
+    TMpmcItem item;
+    pthread_t thread;
+
+    RTT_ASSERT(pthread_create(&thread, NULL, testMpmcDelayedPush, NULL) == 0);
+    item.a = 0;
+    RTT_ASSERT(RTMpmcFifoPopWait(&gMpmcWaitFifo, &item, sizeof(item),
+                RTWAIT_FOREVER));
+    RTT_EXPECT(item.a == 1234u);
+    pthread_join(thread, NULL);
+    RTT_ASSERT(RTMpmcFifoIsEmpty(&gMpmcWaitFifo));
+}
+RTT_TEST_END
+
+RTT_TEST_START(mpmcfifo_idle_popwait_should_be_woken_by_a_single_push)
+{
+    uint32_t dummy = 0;
+    uint32_t start_us;
+    TMpmcItem item;
+    pthread_t thread;
+
+    gMpmcIdleDone = 0;
+    RTT_ASSERT(pthread_create(&thread, NULL, testMpmcIdleWaiter, NULL) == 0);
+    /* Give the waiter plenty of time to block */
+    (void)RTWait(&dummy, 0, 50);
+    RTT_ASSERT(RTATOMIC_LOAD_ACQUIRE(&gMpmcIdleDone) == 0);
+    item.a = 4321u;
+    item.b = 0;
+    RTT_ASSERT(RTMpmcFifoPush(&gMpmcWaitFifo, &item, sizeof(item)));
+    start_us = RTNow_us();
+    while ((RTATOMIC_LOAD_ACQUIRE(&gMpmcIdleDone) == 0)
+            && ((RTNow_us() - start_us) < 1000000u)) {
+        sched_yield();
+    }
+    RTT_ASSERT(RTATOMIC_LOAD_ACQUIRE(&gMpmcIdleDone) == 1u);
+    pthread_join(thread, NULL);
+    RTT_ASSERT(RTMpmcFifoIsEmpty(&gMpmcWaitFifo));
+}
+RTT_TEST_END
+
+RTT_TEST_START(mpmcfifo_pushwait_should_time_out_when_full)
+{
+    TMpmcItem item;
+    uint32_t start_us;
+
+    item.a = 1u;
+    item.b = 0;
+    RTT_ASSERT(RTMpmcFifoPushWait(&gMpmcWaitFifo, &item, sizeof(item), 20));
+    RTT_ASSERT(RTMpmcFifoPushWait(&gMpmcWaitFifo, &item, sizeof(item), 20));
+    start_us = RTNow_us();
+    RTT_ASSERT(!RTMpmcFifoPushWait(&gMpmcWaitFifo, &item, sizeof(item), 20));
+    RTT_EXPECT((RTNow_us() - start_us) >= 19000u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(mpmcfifo_pushwait_should_block_until_item_is_popped)
+{
+    TMpmcItem item;
+    pthread_t thread;
+
+    RTT_ASSERT(RTMpmcFifoIsFull(&gMpmcWaitFifo));
+    RTT_ASSERT(pthread_create(&thread, NULL, testMpmcDelayedPop, NULL) == 0);
+    item.a = 2u;
+    item.b = 0;
+    RTT_ASSERT(RTMpmcFifoPushWait(&gMpmcWaitFifo, &item, sizeof(item),
+                RTWAIT_FOREVER));
+    pthread_join(thread, NULL);
+    RTT_ASSERT(RTMpmcFifoPop(&gMpmcWaitFifo, &item, sizeof(item)));
+    RTT_ASSERT(RTMpmcFifoPop(&gMpmcWaitFifo, &item, sizeof(item)));
+    RTT_EXPECT(item.a == 2u);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestMpmcFifoWait,
+        mpmcfifo_popwait_should_time_out_when_empty,
+        mpmcfifo_popwait_should_block_until_item_is_pushed,
+        mpmcfifo_idle_popwait_should_be_woken_by_a_single_push,
+        mpmcfifo_pushwait_should_time_out_when_full,
+        mpmcfifo_pushwait_should_block_until_item_is_popped)
@@ -0,0 +1,136 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtmpscfifo.h"
+#include "rttest.h"
+#include "rtplf.h"
+#include <pthread.h>
+#include <sched.h>
+
+
+#define TEST_MPSC_PRODUCERS 4
+#define TEST_MPSC_ITEMS_PER_PRODUCER 50000u
+
+
+typedef struct {
+    uint32_t producer;
+    uint32_t index;
+} TMpscItem;
+
+static TMpscItem gMpscBuffer[10];
+static uint32_t gMpscSeqs[10];
+static RTMpscFifo gMpscFifo = RT_MPSC_FIFO_INIT(gMpscBuffer, gMpscSeqs);
+
+static TMpscItem gStressBuffer[8];
+static uint32_t gStressSeqs[8];
+static RTMpscFifo gStressFifo;
+
+
+/** Push `TEST_MPSC_ITEMS_PER_PRODUCER` numbered items into `gStressFifo` */
+static void* testMpscProducer(void* arg)
+{
+    TMpscItem item;
+    uint32_t i;
+
+    item.producer = (uint32_t)(long)arg;
+    for (i = 0; i < TEST_MPSC_ITEMS_PER_PRODUCER; i++) {
+        item.index = i;
+        while (!RTMpscFifoPush(&gStressFifo, &item, sizeof(item))) {
+            sched_yield(); /* Let the consumer run, even on a single CPU */
+        }
+    }
+    return NULL;
+}
+
+
+RTT_GROUP_START(TestMpscFifo, 0x00020004u, NULL, NULL)
+
+RTT_TEST_START(mpscfifo_should_be_empty_after_creation)
+{
+    TMpscItem item;
+
+    RTT_ASSERT(RTMpscFifoCapacity(&gMpscFifo) == 10u);
+    RTT_ASSERT(RTMpscFifoIsEmpty(&gMpscFifo));
+    RTT_ASSERT(!RTMpscFifoIsFull(&gMpscFifo));
+    RTT_ASSERT(RTMpscFifoSize(&gMpscFifo) == 0);
+    RTT_ASSERT(!RTMpscFifoPop(&gMpscFifo, &item, sizeof(item)));
+}
+RTT_TEST_END
+
+RTT_TEST_START(mpscfifo_should_work_with_a_capacity_of_1)
+{
+    RTMpscFifo fifo;
+    TMpscItem buffer[1];
+    uint32_t seqs[1];
+    TMpscItem item;
+    uint32_t i;
+
+    seqs[0] = 0xDeadBeef;
+    RTMpscFifoInit(&fifo, 1, sizeof(item), (RTByte*)buffer, seqs);
+    RTT_ASSERT(RTMpscFifoCapacity(&fifo) == 1u);
+    for (i = 0; i < 50u; i++) {
+        item.producer = 0;
+        item.index = i;
+        RTT_ASSERT(RTMpscFifoPush(&fifo, &item, sizeof(item)));
+        RTT_ASSERT(RTMpscFifoIsFull(&fifo));
+        RTT_ASSERT(!RTMpscFifoPush(&fifo, &item, sizeof(item)));
+        RTT_ASSERT(RTMpscFifoPop(&fifo, &item, sizeof(item)));
+        RTT_EXPECT(item.index == i);
+        RTT_ASSERT(!RTMpscFifoPop(&fifo, &item, sizeof(item)));
+    }
+}
+RTT_TEST_END
+
+RTT_TEST_START(mpscfifo_should_deliver_each_item_once_in_producer_order)
+{
+    pthread_t threads[TEST_MPSC_PRODUCERS];
+    uint32_t next[TEST_MPSC_PRODUCERS];
+    TMpscItem item;
+    uint32_t received = 0;
+    long p;
+
+    RTMpscFifoInit(&gStressFifo, RTARRAYSIZE(gStressBuffer),
+            sizeof(gStressBuffer[0]), (RTByte*)gStressBuffer, gStressSeqs);
+    for (p = 0; p < TEST_MPSC_PRODUCERS; p++) {
+        next[p] = 0;
+        RTT_ASSERT(pthread_create(&threads[p], NULL, testMpscProducer,
+                    (void*)p) == 0);
+    }
+
+    /* Each producer's items must come out exactly once and in order; the
+     * small buffer makes the indices wrap around many times */
+    while (received < (TEST_MPSC_PRODUCERS * TEST_MPSC_ITEMS_PER_PRODUCER)) {
+        if (RTMpscFifoPop(&gStressFifo, &item, sizeof(item))) {
+            RTT_ASSERT(item.producer < TEST_MPSC_PRODUCERS);
+            RTT_ASSERT(item.index == next[item.producer]);
+            next[item.producer]++;
+            received++;
+        } else {
+            sched_yield();
+        }
+    }
+    for (p = 0; p < TEST_MPSC_PRODUCERS; p++) {
+        pthread_join(threads[p], NULL);
+        RTT_ASSERT(next[p] == TEST_MPSC_ITEMS_PER_PRODUCER);
+    }
+    RTT_ASSERT(RTMpscFifoIsEmpty(&gStressFifo));
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestMpscFifo,
+        mpscfifo_should_be_empty_after_creation,
+        mpscfifo_should_work_with_a_capacity_of_1,
+        mpscfifo_should_deliver_each_item_once_in_producer_order)
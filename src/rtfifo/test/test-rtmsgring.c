@@ -0,0 +1,217 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtmsgring.h"
+#include "rttest.h"
+#include "rtplf.h"
+
+
+/* 64 bytes */
+static uint32_t gMsgRingBuffer[16];
+static RTMsgRing gMsgRing = RT_MSG_RING_INIT(gMsgRingBuffer);
+
+
+/** Fill in a message whose bytes are `seed`, `seed + 1`, etc. */
+static void testMsgRingFill(RTByte* msg, uint16_t size_B, RTByte seed)
+{
+    uint16_t i;
+    for (i = 0; i < size_B; i++) {
+        msg[i] = (RTByte)(seed + i);
+    }
+}
+
+
+/** Check a message filled in by `testMsgRingFill()` */
+static RTBool testMsgRingCheck(const RTByte* msg, uint16_t size_B, RTByte seed)
+{
+    RTBool ok = RTTrue;
+    uint16_t i;
+    for (i = 0; i < size_B; i++) {
+        if (msg[i] != (RTByte)(seed + i)) {
+            ok = RTFalse;
+        }
+    }
+    return ok;
+}
+
+
+typedef struct {
+    uint32_t count;
+    uint32_t total_B;
+    RTBool   ok;
+} TMsgRingDrainCtx;
+
+
+static void testMsgRingHandler(void* ctx, const void* msg, uint16_t size_B)
+{
+    TMsgRingDrainCtx* drain = (TMsgRingDrainCtx*)ctx;
+    if (!testMsgRingCheck(msg, size_B, (RTByte)(drain->count * 16u))) {
+        drain->ok = RTFalse;
+    }
+    drain->count++;
+    drain->total_B += size_B;
+}
+
+
+RTT_GROUP_START(TestMsgRing, 0x0002000Bu, NULL, NULL)
+
+RTT_TEST_START(msgring_should_be_empty_after_creation)
+{
+    RTByte msg[4];
+    RTT_ASSERT(RTMsgRingIsEmpty(&gMsgRing));
+    RTT_ASSERT(RTMsgRingCount(&gMsgRing) == 0);
+    RTT_ASSERT(RTMsgRingNextSize(&gMsgRing) == 0);
+    RTT_ASSERT(RTMsgRingPeek(&gMsgRing, NULL) == NULL);
+    RTT_ASSERT(RTMsgRingPop(&gMsgRing, msg, sizeof(msg)) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(msgring_should_push_messages_of_different_sizes)
+{
+    RTByte msg[32];
+
+    /* Records: 4+4, 4+12, 4+20 => 48 bytes */
+    testMsgRingFill(msg, 1, 1);
+    RTT_ASSERT(RTMsgRingPush(&gMsgRing, msg, 1));
+    testMsgRingFill(msg, 10, 2);
+    RTT_ASSERT(RTMsgRingPush(&gMsgRing, msg, 10));
+    testMsgRingFill(msg, 20, 3);
+    RTT_ASSERT(RTMsgRingPush(&gMsgRing, msg, 20));
+    RTT_ASSERT(RTMsgRingCount(&gMsgRing) == 3u);
+
+    /* 16 bytes left */
+    RTT_ASSERT(!RTMsgRingPush(&gMsgRing, msg, 13));
+    RTT_ASSERT(RTMsgRingPush(&gMsgRing, msg, 12));
+    RTT_ASSERT(!RTMsgRingPush(&gMsgRing, msg, 1));
+    RTT_ASSERT(RTMsgRingCount(&gMsgRing) == 4u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(msgring_should_pop_and_peek_messages_in_order)
+{
+    RTByte msg[32];
+    const RTByte* p;
+    uint16_t size_B;
+
+    RTT_ASSERT(RTMsgRingNextSize(&gMsgRing) == 1u);
+    RTT_ASSERT(RTMsgRingPop(&gMsgRing, msg, sizeof(msg)) == 1u);
+    RTT_EXPECT(testMsgRingCheck(msg, 1, 1));
+
+    p = RTMsgRingPeek(&gMsgRing, &size_B);
+    RTT_ASSERT(p != NULL);
+    RTT_ASSERT(size_B == 10u);
+    RTT_EXPECT(testMsgRingCheck(p, 10, 2));
+    RTT_EXPECT((((uintptr_t)p) % 4u) == 0);
+    RTMsgRingRelease(&gMsgRing);
+    RTT_ASSERT(RTMsgRingCount(&gMsgRing) == 2u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(msgring_should_wrap_records_around)
+{
+    RTByte msg[32];
+
+    /* Head has wrapped around, 24 bytes are free before tail */
+    testMsgRingFill(msg, 16, 4);
+    RTT_ASSERT(!RTMsgRingPush(&gMsgRing, msg, 24));
+    RTT_ASSERT(RTMsgRingPush(&gMsgRing, msg, 16));
+    RTT_ASSERT(RTMsgRingCount(&gMsgRing) == 3u);
+
+    RTT_ASSERT(RTMsgRingPop(&gMsgRing, msg, sizeof(msg)) == 20u);
+    RTT_EXPECT(testMsgRingCheck(msg, 20, 3));
+    RTT_ASSERT(RTMsgRingPop(&gMsgRing, msg, sizeof(msg)) == 12u);
+    RTT_ASSERT(RTMsgRingPop(&gMsgRing, msg, sizeof(msg)) == 16u);
+    RTT_EXPECT(testMsgRingCheck(msg, 16, 4));
+    RTT_ASSERT(RTMsgRingIsEmpty(&gMsgRing));
+}
+RTT_TEST_END
+
+RTT_TEST_START(msgring_should_skip_wrap_marker)
+{
+    RTByte msg[32];
+
+    /* Use 48 bytes, free the first 32, then push a record that does not fit
+     * in the last 16 bytes */
+    testMsgRingFill(msg, 28, 0);
+    RTT_ASSERT(RTMsgRingPush(&gMsgRing, msg, 28));
+    RTT_ASSERT(RTMsgRingPush(&gMsgRing, msg, 12));
+    RTT_ASSERT(RTMsgRingPop(&gMsgRing, msg, sizeof(msg)) == 28u);
+    RTT_ASSERT(!RTMsgRingPush(&gMsgRing, msg, 29));
+    testMsgRingFill(msg, 20, 9);
+    RTT_ASSERT(RTMsgRingPush(&gMsgRing, msg, 20));
+
+    RTT_ASSERT(RTMsgRingPop(&gMsgRing, msg, sizeof(msg)) == 12u);
+    RTT_ASSERT(RTMsgRingNextSize(&gMsgRing) == 20u);
+    RTT_ASSERT(RTMsgRingPop(&gMsgRing, msg, sizeof(msg)) == 20u);
+    RTT_EXPECT(testMsgRingCheck(msg, 20, 9));
+    RTT_ASSERT(RTMsgRingIsEmpty(&gMsgRing));
+}
+RTT_TEST_END
+
+RTT_TEST_START(msgring_should_drain_messages)
+{
+    RTByte msg[32];
+    TMsgRingDrainCtx drain;
+    uint32_t i;
+    uint32_t pushed = 0;
+    uint32_t popped = 0;
+
+    drain.count = 0;
+    drain.total_B = 0;
+    drain.ok = RTTrue;
+
+    /* Push and drain many times so records wrap around repeatedly */
+    for (i = 0; i < 200u; i++) {
+        uint16_t size_B = (uint16_t)(1u + (i % 13u));
+        testMsgRingFill(msg, size_B, (RTByte)(pushed * 16u));
+        if (RTMsgRingPush(&gMsgRing, msg, size_B)) {
+            pushed++;
+        } else {
+            popped += RTMsgRingDrain(&gMsgRing, testMsgRingHandler, &drain, 2);
+        }
+    }
+    popped += RTMsgRingDrain(&gMsgRing, testMsgRingHandler, &drain, 1000u);
+    RTT_EXPECT(drain.ok);
+    RTT_ASSERT(popped == pushed);
+    RTT_ASSERT(drain.count == pushed);
+    RTT_ASSERT(RTMsgRingIsEmpty(&gMsgRing));
+}
+RTT_TEST_END
+
+RTT_TEST_START(msgring_should_initialise_dynamically)
+{
+    uint32_t buffer[4];
+    RTMsgRing ring;
+    RTByte msg[12];
+
+    RTMsgRingInit(&ring, (RTByte*)buffer, sizeof(buffer));
+    testMsgRingFill(msg, 12, 7);
+    RTT_ASSERT(RTMsgRingPush(&ring, msg, 12));
+    RTT_ASSERT(!RTMsgRingPush(&ring, msg, 1));
+    RTT_ASSERT(RTMsgRingPop(&ring, msg, sizeof(msg)) == 12u);
+    RTT_EXPECT(testMsgRingCheck(msg, 12, 7));
+    RTT_ASSERT(RTMsgRingIsEmpty(&ring));
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestMsgRing,
+        msgring_should_be_empty_after_creation,
+        msgring_should_push_messages_of_different_sizes,
+        msgring_should_pop_and_peek_messages_in_order,
+        msgring_should_wrap_records_around,
+        msgring_should_skip_wrap_marker,
+        msgring_should_drain_messages,
+        msgring_should_initialise_dynamically)
@@ -0,0 +1,138 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtpow2fifo.h"
+#include "rttest.h"
+#include "rtplf.h"
+
+
+typedef struct {
+    uint32_t a;
+    int32_t b;
+} TPow2Item;
+
+static TPow2Item gPow2Buffer[8];
+static RTPow2Fifo gPow2Fifo = RT_POW2_FIFO_INIT(gPow2Buffer);
+
+RTT_GROUP_START(TestPow2Fifo, 0x00020009u, NULL, NULL)
+
+RTT_TEST_START(pow2fifo_should_be_empty_after_creation)
+{
+    RTT_ASSERT(RTPow2FifoIsEmpty(&gPow2Fifo));
+    RTT_ASSERT(!RTPow2FifoIsFull(&gPow2Fifo));
+    RTT_ASSERT(RTPow2FifoSize(&gPow2Fifo) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(pow2fifo_capacity_should_be_8)
+{
+    RTT_ASSERT(RTPow2FifoCapacity(&gPow2Fifo) == 8u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(pow2fifo_should_not_pop_after_creation)
+{
+    TPow2Item item;
+    RTT_ASSERT(!RTPow2FifoPop(&gPow2Fifo, &item, sizeof(item)));
+}
+RTT_TEST_END
+
+RTT_TEST_START(pow2fifo_should_be_full_after_8_pushes)
+{
+    TPow2Item item;
+    uint16_t i;
+
+    for (i = 0; i < 8u; i++) {
+        item.a = 100u + i;
+        item.b = -(int32_t)i;
+        RTT_ASSERT(RTPow2FifoPush(&gPow2Fifo, &item, sizeof(item)));
+    }
+    RTT_ASSERT(RTPow2FifoIsFull(&gPow2Fifo));
+    RTT_ASSERT(RTPow2FifoSize(&gPow2Fifo) == 8u);
+    RTT_ASSERT(!RTPow2FifoPush(&gPow2Fifo, &item, sizeof(item)));
+}
+RTT_TEST_END
+
+RTT_TEST_START(pow2fifo_should_pop_items_in_order)
+{
+    TPow2Item item;
+    uint16_t i;
+
+    for (i = 0; i < 5u; i++) {
+        RTT_ASSERT(RTPow2FifoPop(&gPow2Fifo, &item, sizeof(item)));
+        RTT_EXPECT((item.a == (100u + i)) && (item.b == -(int32_t)i));
+    }
+    RTT_ASSERT(RTPow2FifoSize(&gPow2Fifo) == 3u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(pow2fifo_should_wrap_counters_around)
+{
+    TPow2Item item;
+    uint32_t expected = 105u;
+    uint32_t next = 108u;
+    uint32_t i;
+
+    /* Run head and tail through more than 2^16 items */
+    for (i = 0; i < 70000u; i++) {
+        item.a = next++;
+        item.b = 0;
+        RTT_ASSERT(RTPow2FifoPush(&gPow2Fifo, &item, sizeof(item)));
+        RTT_ASSERT(RTPow2FifoPop(&gPow2Fifo, &item, sizeof(item)));
+        RTT_ASSERT(item.a == expected);
+        expected++;
+        RTT_ASSERT(RTPow2FifoSize(&gPow2Fifo) == 3u);
+    }
+    while (RTPow2FifoPop(&gPow2Fifo, &item, sizeof(item))) {
+        RTT_EXPECT(item.a == expected);
+        expected++;
+    }
+    RTT_ASSERT(expected == next);
+    RTT_ASSERT(RTPow2FifoIsEmpty(&gPow2Fifo));
+}
+RTT_TEST_END
+
+RTT_TEST_START(pow2fifo_should_initialise_dynamically)
+{
+    RTByte buffer[4 * 16];
+    RTByte item[16];
+    RTPow2Fifo fifo;
+    uint8_t i;
+
+    RTPow2FifoInit(&fifo, 4, 16, buffer);
+    RTT_ASSERT(RTPow2FifoCapacity(&fifo) == 4u);
+    for (i = 0; i < 4u; i++) {
+        item[0] = i;
+        item[15] = (RTByte)(0xF0u | i);
+        RTT_ASSERT(RTPow2FifoPush(&fifo, item, sizeof(item)));
+    }
+    RTT_ASSERT(!RTPow2FifoPush(&fifo, item, sizeof(item)));
+    for (i = 0; i < 4u; i++) {
+        RTT_ASSERT(RTPow2FifoPop(&fifo, item, sizeof(item)));
+        RTT_EXPECT((item[0] == i) && (item[15] == (RTByte)(0xF0u | i)));
+    }
+    RTT_ASSERT(RTPow2FifoIsEmpty(&fifo));
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestPow2Fifo,
+        pow2fifo_should_be_empty_after_creation,
+        pow2fifo_capacity_should_be_8,
+        pow2fifo_should_not_pop_after_creation,
+        pow2fifo_should_be_full_after_8_pushes,
+        pow2fifo_should_pop_items_in_order,
+        pow2fifo_should_wrap_counters_around,
+        pow2fifo_should_initialise_dynamically)
@@ -0,0 +1,131 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "rtpriofifo.h"
+#include "rttest.h"
+#include "rtplf.h"
+
+
+typedef struct {
+    uint32_t seq;
+    uint32_t lane;
+} TPrioItem;
+
+static TPrioItem gPrioUrgentBuffer[2];
+static TPrioItem gPrioNormalBuffer[4];
+static TPrioItem gPrioBulkBuffer[8];
+static RTFifo gPrioLanes[3] = {
+    RT_FIFO_INIT(gPrioUrgentBuffer),
+    RT_FIFO_INIT(gPrioNormalBuffer),
+    RT_FIFO_INIT(gPrioBulkBuffer)
+};
+static RTPrioFifo gPrioFifo = RT_PRIO_FIFO_INIT(gPrioLanes);
+
+RTT_GROUP_START(TestPrioFifo, 0x00020012u, NULL, NULL)
+
+RTT_TEST_START(priofifo_should_be_empty_after_creation)
+{
+    TPrioItem item;
+
+    RTT_ASSERT(RTPrioFifoLaneCount(&gPrioFifo) == 3u);
+    RTT_ASSERT(RTPrioFifoIsEmpty(&gPrioFifo));
+    RTT_ASSERT(RTPrioFifoSize(&gPrioFifo) == 0);
+    RTT_ASSERT(!RTPrioFifoPop(&gPrioFifo, &item, sizeof(item), NULL));
+}
+RTT_TEST_END
+
+RTT_TEST_START(priofifo_should_fill_lanes_independently)
+{
+    TPrioItem item;
+    uint32_t i;
+
+    for (i = 0; i < 8; i++) {
+        item.seq = i;
+        item.lane = 2;
+        RTT_ASSERT(RTPrioFifoPush(&gPrioFifo, 2, &item, sizeof(item)));
+    }
+    RTT_ASSERT(!RTPrioFifoPush(&gPrioFifo, 2, &item, sizeof(item)));
+    for (i = 0; i < 2; i++) {
+        item.seq = i;
+        item.lane = 0;
+        RTT_ASSERT(RTPrioFifoPush(&gPrioFifo, 0, &item, sizeof(item)));
+    }
+    RTT_ASSERT(!RTPrioFifoPush(&gPrioFifo, 0, &item, sizeof(item)));
+    RTT_ASSERT(!RTPrioFifoIsEmpty(&gPrioFifo));
+    RTT_ASSERT(RTPrioFifoSize(&gPrioFifo) == 10u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(priofifo_should_pop_highest_priority_first)
+{
+    TPrioItem item;
+    uint8_t lane = 0xFF;
+
+    RTT_ASSERT(RTPrioFifoPop(&gPrioFifo, &item, sizeof(item), &lane));
+    RTT_ASSERT((lane == 0) && (item.lane == 0) && (item.seq == 0));
+
+    /* A late urgent item overtakes the bulk backlog */
+    item.seq = 0;
+    item.lane = 1;
+    RTT_ASSERT(RTPrioFifoPush(&gPrioFifo, 1, &item, sizeof(item)));
+
+    RTT_ASSERT(RTPrioFifoPop(&gPrioFifo, &item, sizeof(item), &lane));
+    RTT_ASSERT((lane == 0) && (item.lane == 0) && (item.seq == 1));
+    RTT_ASSERT(RTPrioFifoPop(&gPrioFifo, &item, sizeof(item), &lane));
+    RTT_ASSERT((lane == 1) && (item.lane == 1) && (item.seq == 0));
+    RTT_ASSERT(RTPrioFifoSize(&gPrioFifo) == 8u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(priofifo_should_pop_each_lane_in_fifo_order)
+{
+    TPrioItem item;
+    uint8_t lane;
+    uint32_t i;
+
+    for (i = 0; i < 8; i++) {
+        RTT_ASSERT(RTPrioFifoPop(&gPrioFifo, &item, sizeof(item), &lane));
+        RTT_ASSERT((lane == 2) && (item.seq == i));
+    }
+    RTT_ASSERT(RTPrioFifoIsEmpty(&gPrioFifo));
+    RTT_ASSERT(!RTPrioFifoPop(&gPrioFifo, &item, sizeof(item), &lane));
+}
+RTT_TEST_END
+
+RTT_TEST_START(priofifo_should_initialise_from_non_empty_lanes)
+{
+    RTPrioFifo fifo;
+    TPrioItem item;
+    uint8_t lane;
+
+    item.seq = 7;
+    item.lane = 1;
+    RTT_ASSERT(RTFifoPush(&gPrioLanes[1], &item, sizeof(item)));
+    RTPrioFifoInit(&fifo, gPrioLanes, 3);
+    RTT_ASSERT(RTPrioFifoSize(&fifo) == 1u);
+    RTT_ASSERT(RTPrioFifoPop(&fifo, &item, sizeof(item), &lane));
+    RTT_ASSERT((lane == 1) && (item.seq == 7));
+    RTT_ASSERT(RTPrioFifoIsEmpty(&fifo));
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestPrioFifo,
+        priofifo_should_be_empty_after_creation,
+        priofifo_should_fill_lanes_independently,
+        priofifo_should_pop_highest_priority_first,
+        priofifo_should_pop_each_lane_in_fifo_order,
+        priofifo_should_initialise_from_non_empty_lanes)
@@ -0,0 +1,254 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define _GNU_SOURCE
+#include "rtshardedqueue.h"
+#include "rttest.h"
+#include "rtplf.h"
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+
+#define TEST_SHARDED_ITEMS 50000u
+#define TEST_SHARDED_PRODUCERS 6
+#define TEST_SHARDED_SHARDS 4
+#define TEST_SHARDED_CAPACITY 64
+#define TEST_SHARDED_HOP_ITEMS 1000u
+
+
+typedef struct {
+    uint32_t producer;
+    uint32_t seq;
+} TShardedItem;
+
+static TShardedItem gShardedBuffer0[4];
+static TShardedItem gShardedBuffer1[4];
+static TShardedItem gShardedBuffer2[4];
+static uint32_t gShardedSeqs0[4];
+static uint32_t gShardedSeqs1[4];
+static uint32_t gShardedSeqs2[4];
+static RTMpscFifo gShards[3] = {
+    RT_MPSC_FIFO_INIT(gShardedBuffer0, gShardedSeqs0),
+    RT_MPSC_FIFO_INIT(gShardedBuffer1, gShardedSeqs1),
+    RT_MPSC_FIFO_INIT(gShardedBuffer2, gShardedSeqs2)
+};
+static RTShardedQueue gShardedQueue = RT_SHARDED_QUEUE_INIT(gShards);
+
+static TShardedItem gStressBuffers[TEST_SHARDED_SHARDS][TEST_SHARDED_CAPACITY];
+static uint32_t gStressSeqs[TEST_SHARDED_SHARDS][TEST_SHARDED_CAPACITY];
+static RTMpscFifo gStressShards[TEST_SHARDED_SHARDS];
+static RTShardedQueue gStressQueue;
+
+
+/* Move the calling thread to another CPU, if there is more than one */
+static void testShardedHop(uint32_t cpu)
+{
+    cpu_set_t set;
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpus > 1) {
+        CPU_ZERO(&set);
+        CPU_SET((int)(cpu % (uint32_t)ncpus), &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+}
+
+
+/* The first half of the producers push into a fixed shard; the other half
+ * bind to the shard of their CPU and then keep hopping from CPU to CPU */
+static void* testShardedProducer(void* arg)
+{
+    TShardedItem item;
+    uint16_t shard;
+    RTBool hop;
+    uint32_t i;
+
+    item.producer = (uint32_t)(long)arg;
+    hop = (item.producer >= (TEST_SHARDED_PRODUCERS / 2));
+    if (hop) {
+        testShardedHop(item.producer);
+        shard = RTShardedQueueBind(&gStressQueue);
+    } else {
+        shard = (uint16_t)(item.producer % TEST_SHARDED_SHARDS);
+    }
+    for (i = 0; i < TEST_SHARDED_ITEMS; i++) {
+        item.seq = i;
+        if (hop && ((i % TEST_SHARDED_HOP_ITEMS) == 0)) {
+            testShardedHop(item.producer + (i / TEST_SHARDED_HOP_ITEMS));
+        }
+        while (!RTShardedQueuePushTo(&gStressQueue, shard, &item,
+                    sizeof(item))) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+
+RTT_GROUP_START(TestShardedQueue, 0x00020017u, NULL, NULL)
+
+RTT_TEST_START(sharded_queue_should_be_empty_after_creation)
+{
+    TShardedItem item;
+
+    RTT_ASSERT(RTShardedQueueShardCount(&gShardedQueue) == 3u);
+    RTT_ASSERT(RTShardedQueueSize(&gShardedQueue) == 0);
+    RTT_ASSERT(!RTShardedQueuePop(&gShardedQueue, &item, sizeof(item)));
+}
+RTT_TEST_END
+
+RTT_TEST_START(sharded_queue_should_drain_shards_round_robin_in_batches)
+{
+    TShardedItem items[16];
+    TShardedItem item;
+    uint32_t i;
+
+    item.producer = 0;
+    for (i = 0; i < 4; i++) {
+        item.seq = i;
+        RTT_ASSERT(RTShardedQueuePushTo(&gShardedQueue, 0, &item,
+                    sizeof(item)));
+    }
+    RTT_ASSERT(!RTShardedQueuePushTo(&gShardedQueue, 0, &item, sizeof(item)));
+    for (i = 10; i < 12; i++) {
+        item.seq = i;
+        RTT_ASSERT(RTShardedQueuePushTo(&gShardedQueue, 1, &item,
+                    sizeof(item)));
+    }
+    item.seq = 20;
+    RTT_ASSERT(RTShardedQueuePushTo(&gShardedQueue, 2, &item, sizeof(item)));
+    RTT_ASSERT(RTShardedQueueSize(&gShardedQueue) == 7u);
+
+    RTT_ASSERT(RTShardedQueuePopN(&gShardedQueue, items, sizeof(items[0]),
+                RTARRAYSIZE(items), 2) == 7u);
+    RTT_EXPECT(items[0].seq == 0);
+    RTT_EXPECT(items[1].seq == 1u);
+    RTT_EXPECT(items[2].seq == 10u);
+    RTT_EXPECT(items[3].seq == 11u);
+    RTT_EXPECT(items[4].seq == 20u);
+    RTT_EXPECT(items[5].seq == 2u);
+    RTT_EXPECT(items[6].seq == 3u);
+    RTT_ASSERT(RTShardedQueueSize(&gShardedQueue) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(sharded_queue_should_stop_popping_at_count)
+{
+    TShardedItem items[2];
+    TShardedItem item;
+    uint32_t i;
+
+    item.producer = 0;
+    for (i = 0; i < 3; i++) {
+        item.seq = i;
+        RTT_ASSERT(RTShardedQueuePushTo(&gShardedQueue, 2, &item,
+                    sizeof(item)));
+    }
+    RTT_ASSERT(RTShardedQueuePopN(&gShardedQueue, items, sizeof(items[0]),
+                RTARRAYSIZE(items), 8) == 2u);
+    RTT_EXPECT(items[0].seq == 0);
+    RTT_EXPECT(items[1].seq == 1u);
+    RTT_ASSERT(RTShardedQueuePop(&gShardedQueue, &item, sizeof(item)));
+    RTT_EXPECT(item.seq == 2u);
+    RTT_ASSERT(!RTShardedQueuePop(&gShardedQueue, &item, sizeof(item)));
+}
+RTT_TEST_END
+
+RTT_TEST_START(sharded_queue_should_push_into_current_cpu_shard)
+{
+    TShardedItem item;
+
+    item.producer = 0;
+    item.seq = 42;
+    RTT_ASSERT(RTShardedQueuePush(&gShardedQueue, &item, sizeof(item)));
+    RTT_ASSERT(RTShardedQueueSize(&gShardedQueue) == 1u);
+    item.seq = 0;
+    RTT_ASSERT(RTShardedQueuePop(&gShardedQueue, &item, sizeof(item)));
+    RTT_EXPECT(item.seq == 42u);
+    RTT_ASSERT(RTShardedQueueSize(&gShardedQueue) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(sharded_queue_should_bind_to_a_valid_shard)
+{
+    TShardedItem item;
+    uint16_t shard;
+
+    shard = RTShardedQueueBind(&gShardedQueue);
+    RTT_ASSERT(shard < RTShardedQueueShardCount(&gShardedQueue));
+    item.producer = 0;
+    item.seq = 43;
+    RTT_ASSERT(RTShardedQueuePushTo(&gShardedQueue, shard, &item,
+                sizeof(item)));
+    RTT_ASSERT(RTShardedQueueSize(&gShardedQueue) == 1u);
+    item.seq = 0;
+    RTT_ASSERT(RTShardedQueuePop(&gShardedQueue, &item, sizeof(item)));
+    RTT_EXPECT(item.seq == 43u);
+    RTT_ASSERT(RTShardedQueueSize(&gShardedQueue) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(sharded_queue_should_keep_per_producer_order)
+{
+    pthread_t threads[TEST_SHARDED_PRODUCERS];
+    uint32_t expected[TEST_SHARDED_PRODUCERS];
+    TShardedItem items[16];
+    uint32_t total = 0;
+    uint32_t n;
+    uint32_t i;
+    long p;
+
+    for (i = 0; i < TEST_SHARDED_SHARDS; i++) {
+        RTMpscFifoInit(&gStressShards[i], TEST_SHARDED_CAPACITY,
+                sizeof(TShardedItem), (RTByte*)gStressBuffers[i],
+                gStressSeqs[i]);
+    }
+    RTShardedQueueInit(&gStressQueue, gStressShards, TEST_SHARDED_SHARDS);
+    for (p = 0; p < TEST_SHARDED_PRODUCERS; p++) {
+        expected[p] = 0;
+        RTT_ASSERT(pthread_create(&threads[p], NULL, testShardedProducer,
+                    (void*)p) == 0);
+    }
+
+    while (total < (TEST_SHARDED_ITEMS * TEST_SHARDED_PRODUCERS)) {
+        n = RTShardedQueuePopN(&gStressQueue, items, sizeof(items[0]),
+                RTARRAYSIZE(items), 4);
+        for (i = 0; i < n; i++) {
+            RTT_ASSERT(items[i].producer < TEST_SHARDED_PRODUCERS);
+            RTT_ASSERT(items[i].seq == expected[items[i].producer]);
+            expected[items[i].producer]++;
+        }
+        total += n;
+        if (n == 0) {
+            sched_yield();
+        }
+    }
+    for (p = 0; p < TEST_SHARDED_PRODUCERS; p++) {
+        pthread_join(threads[p], NULL);
+    }
+
+    RTT_ASSERT(RTShardedQueueSize(&gStressQueue) == 0);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestShardedQueue,
+        sharded_queue_should_be_empty_after_creation,
+        sharded_queue_should_drain_shards_round_robin_in_batches,
+        sharded_queue_should_stop_popping_at_count,
+        sharded_queue_should_push_into_current_cpu_shard,
+        sharded_queue_should_bind_to_a_valid_shard,
+        sharded_queue_should_keep_per_producer_order)
@@ -0,0 +1,221 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _GNU_SOURCE
+#include "rtshmfifo.h"
+#include "rttest.h"
+#include "rtplf.h"
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+#define TEST_SHM_CAPACITY 16u
+#define TEST_SHM_ITEMS 20000u
+#define TEST_SHM_PRODUCERS 2u
+
+
+typedef struct {
+    uint32_t producer;
+    uint32_t seq;
+} TShmItem;
+
+
+/** Map the shared memory `fd` again and push `TEST_SHM_ITEMS` items
+ *
+ * This is run in a child process.
+ *
+ * @return 0 if success, 1 if something went wrong
+ */
+static int testShmProducer(int fd, uint32_t producer)
+{
+    int ret = 1;
+    RTSharedMem shm;
+
+    if (RTSharedMemMap(&shm, fd)) {
+        RTShmFifo fifo;
+        if (RTShmFifoAttach(&fifo, shm.addr, shm.size_B)) {
+            TShmItem item;
+            item.producer = producer;
+            for (item.seq = 0; item.seq < TEST_SHM_ITEMS; item.seq++) {
+                while (!RTShmFifoPush(&fifo, &item, sizeof(item))) {
+                    sched_yield();
+                }
+            }
+            ret = 0;
+        }
+        RTSharedMemDestroy(&shm);
+    }
+    return ret;
+}
+
+
+/** Reap the producers that have exited, without blocking
+ *
+ * @param pids   [in,out] Pids of the producers; set to 0 once reaped
+ * @param failed [in,out] Incremented for each producer that did not succeed
+ *
+ * @return The number of producers reaped by this call
+ */
+static uint32_t testShmReap(pid_t* pids, uint32_t* failed)
+{
+    uint32_t reaped = 0;
+    uint32_t i;
+    int status;
+
+    for (i = 0; i < TEST_SHM_PRODUCERS; i++) {
+        if ((pids[i] > 0) && (waitpid(pids[i], &status, WNOHANG) == pids[i])) {
+            if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+                (*failed)++;
+            }
+            pids[i] = 0;
+            reaped++;
+        }
+    }
+    return reaped;
+}
+
+
+RTT_GROUP_START(TestShmFifo, 0x0002000Fu, NULL, NULL)
+
+RTT_TEST_START(shmfifo_should_not_attach_to_blank_memory)
+{
+    uint32_t mem[256];
+    RTShmFifo fifo;
+    uint32_t i;
+
+    for (i = 0; i < RTARRAYSIZE(mem); i++) {
+        mem[i] = 0;
+    }
+    RTT_ASSERT(!RTShmFifoAttach(&fifo, mem, sizeof(mem)));
+}
+RTT_TEST_END
+
+RTT_TEST_START(shmfifo_should_push_and_pop_in_one_process)
+{
+    uint32_t mem[256];
+    RTShmFifo fifo;
+    RTShmFifo attached;
+    TShmItem item;
+    uint32_t i;
+
+    RTT_ASSERT(RTShmFifoFootprint_B(3, sizeof(item)) <= sizeof(mem));
+    RTShmFifoCreate(&fifo, mem, sizeof(mem), 3, sizeof(item));
+    RTT_ASSERT(RTShmFifoCapacity(&fifo) == 3u);
+    RTT_ASSERT(RTShmFifoIsEmpty(&fifo));
+    RTT_ASSERT(RTShmFifoAttach(&attached, mem, sizeof(mem)));
+    RTT_ASSERT(RTShmFifoCapacity(&attached) == 3u);
+    RTT_ASSERT(!RTShmFifoAttach(&attached, mem, 16));
+
+    item.producer = 0;
+    for (i = 0; i < 3u; i++) {
+        item.seq = i;
+        RTT_ASSERT(RTShmFifoPush(&attached, &item, sizeof(item)));
+    }
+    RTT_ASSERT(RTShmFifoIsFull(&fifo));
+    RTT_ASSERT(!RTShmFifoPush(&attached, &item, sizeof(item)));
+    for (i = 0; i < 3u; i++) {
+        RTT_ASSERT(RTShmFifoPop(&fifo, &item, sizeof(item)));
+        RTT_EXPECT(item.seq == i);
+    }
+    RTT_ASSERT(!RTShmFifoPop(&fifo, &item, sizeof(item)));
+}
+RTT_TEST_END
+
+RTT_TEST_START(shmfifo_should_not_attach_if_geometry_does_not_fit)
+{
+    uint32_t mem[256];
+    RTShmFifo fifo;
+    RTShmFifo attached;
+
+    RTShmFifoCreate(&fifo, mem, sizeof(mem), 3, sizeof(TShmItem));
+
+    /* Another process claims the FIFO is bigger than the memory area */
+    fifo.header->capacity = 1000u;
+    RTT_ASSERT(!RTShmFifoAttach(&attached, mem, sizeof(mem)));
+    fifo.header->capacity = 0;
+    RTT_ASSERT(!RTShmFifoAttach(&attached, mem, sizeof(mem)));
+    fifo.header->capacity = 3u;
+    fifo.header->itemSize_B = 60000u;
+    RTT_ASSERT(!RTShmFifoAttach(&attached, mem, sizeof(mem)));
+
+    /* The handle of the creator does not depend on the header */
+    RTT_ASSERT(RTShmFifoCapacity(&fifo) == 3u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(shmfifo_should_carry_items_across_processes)
+{
+    RTSharedMem shm;
+    RTShmFifo fifo;
+    pid_t pids[TEST_SHM_PRODUCERS];
+    uint32_t next[TEST_SHM_PRODUCERS];
+    uint32_t received = 0;
+    uint32_t reaped = 0;
+    uint32_t failed = 0;
+    uint32_t errors = 0;
+    RTBool done = RTFalse;
+    TShmItem item;
+    uint32_t i;
+
+    RTT_ASSERT(RTSharedMemCreate(&shm, "test-rtshmfifo",
+                RTShmFifoFootprint_B(TEST_SHM_CAPACITY, sizeof(item))));
+    RTShmFifoCreate(&fifo, shm.addr, shm.size_B, TEST_SHM_CAPACITY,
+            sizeof(item));
+
+    for (i = 0; i < TEST_SHM_PRODUCERS; i++) {
+        next[i] = 0;
+        pids[i] = fork();
+        RTT_ASSERT(pids[i] >= 0);
+        if (pids[i] == 0) {
+            _exit(testShmProducer(shm.fd, i));
+        }
+    }
+
+    /* Items from each producer must come out in order. Stop once all the
+     * producers have exited and the FIFO is empty, so a producer that dies
+     * can't make this loop spin forever. */
+    while (!done) {
+        if (RTShmFifoPop(&fifo, &item, sizeof(item))) {
+            if (    (item.producer < TEST_SHM_PRODUCERS)
+                 && (item.seq == next[item.producer])) {
+                next[item.producer]++;
+            } else {
+                errors++;
+            }
+            received++;
+        } else if (reaped < TEST_SHM_PRODUCERS) {
+            reaped += testShmReap(pids, &failed);
+            sched_yield();
+        } else {
+            done = RTTrue;
+        }
+    }
+
+    RTT_EXPECT(failed == 0);
+    RTT_EXPECT(errors == 0);
+    RTT_ASSERT(received == (TEST_SHM_PRODUCERS * TEST_SHM_ITEMS));
+    RTT_ASSERT(RTShmFifoIsEmpty(&fifo));
+    RTSharedMemDestroy(&shm);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestShmFifo,
+        shmfifo_should_not_attach_to_blank_memory,
+        shmfifo_should_push_and_pop_in_one_process,
+        shmfifo_should_not_attach_if_geometry_does_not_fit,
+        shmfifo_should_carry_items_across_processes)
@@ -0,0 +1,129 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtspscfifo.h"
+#include "rttest.h"
+#include "rtplf.h"
+#include <pthread.h>
+#include <sched.h>
+
+
+#define TEST_SPSC_ITEMS 200000u
+
+
+typedef struct {
+    uint32_t a;
+    uint32_t b;
+} TSpscItem;
+
+static TSpscItem gSpscBuffer[10];
+static RTSpscFifo gSpscFifo = RT_SPSC_FIFO_INIT(gSpscBuffer);
+
+static TSpscItem gStressBuffer[16];
+static RTSpscFifo gStressFifo;
+
+
+/** Push `TEST_SPSC_ITEMS` numbered items into `gStressFifo` */
+static void* testSpscProducer(void* arg)
+{
+    TSpscItem item;
+    uint32_t i;
+
+    for (i = 0; i < TEST_SPSC_ITEMS; i++) {
+        item.a = i;
+        item.b = ~i;
+        while (!RTSpscFifoPush(&gStressFifo, &item, sizeof(item))) {
+            sched_yield(); /* Let the consumer run, even on a single CPU */
+        }
+    }
+    return NULL;
+}
+
+
+RTT_GROUP_START(TestSpscFifo, 0x00020003u, NULL, NULL)
+
+RTT_TEST_START(spscfifo_should_be_empty_after_creation)
+{
+    TSpscItem item;
+
+    RTT_ASSERT(RTSpscFifoCapacity(&gSpscFifo) == 10u);
+    RTT_ASSERT(RTSpscFifoIsEmpty(&gSpscFifo));
+    RTT_ASSERT(!RTSpscFifoIsFull(&gSpscFifo));
+    RTT_ASSERT(RTSpscFifoSize(&gSpscFifo) == 0);
+    RTT_ASSERT(!RTSpscFifoPop(&gSpscFifo, &item, sizeof(item)));
+}
+RTT_TEST_END
+
+RTT_TEST_START(spscfifo_should_fill_up_and_wrap_around)
+{
+    TSpscItem item;
+    uint32_t pushed = 0;
+    uint32_t popped = 0;
+    uint32_t i;
+
+    /* Fill up, then keep the FIFO full while cycling through the buffer */
+    for (i = 0; i < 10u; i++) {
+        item.a = pushed++;
+        RTT_ASSERT(RTSpscFifoPush(&gSpscFifo, &item, sizeof(item)));
+    }
+    for (i = 0; i < 25u; i++) {
+        RTT_ASSERT(RTSpscFifoIsFull(&gSpscFifo));
+        RTT_ASSERT(RTSpscFifoSize(&gSpscFifo) == 10u);
+        RTT_ASSERT(!RTSpscFifoPush(&gSpscFifo, &item, sizeof(item)));
+        RTT_ASSERT(RTSpscFifoPop(&gSpscFifo, &item, sizeof(item)));
+        RTT_EXPECT(item.a == popped);
+        popped++;
+        item.a = pushed++;
+        RTT_ASSERT(RTSpscFifoPush(&gSpscFifo, &item, sizeof(item)));
+    }
+    while (RTSpscFifoPop(&gSpscFifo, &item, sizeof(item))) {
+        RTT_EXPECT(item.a == popped);
+        popped++;
+    }
+    RTT_ASSERT(popped == pushed);
+    RTT_ASSERT(RTSpscFifoIsEmpty(&gSpscFifo));
+}
+RTT_TEST_END
+
+RTT_TEST_START(spscfifo_should_pass_items_in_order_across_threads)
+{
+    pthread_t thread;
+    TSpscItem item;
+    uint32_t expected = 0;
+    uint16_t size;
+
+    RTSpscFifoInit(&gStressFifo, RTARRAYSIZE(gStressBuffer),
+            sizeof(gStressBuffer[0]), (RTByte*)gStressBuffer);
+    RTT_ASSERT(pthread_create(&thread, NULL, testSpscProducer, NULL) == 0);
+    while (expected < TEST_SPSC_ITEMS) {
+        size = RTSpscFifoSize(&gStressFifo);
+        RTT_ASSERT(size <= RTARRAYSIZE(gStressBuffer));
+        if (RTSpscFifoPop(&gStressFifo, &item, sizeof(item))) {
+            RTT_ASSERT((item.a == expected) && (item.b == ~expected));
+            expected++;
+        } else {
+            sched_yield();
+        }
+    }
+    pthread_join(thread, NULL);
+    RTT_ASSERT(RTSpscFifoIsEmpty(&gStressFifo));
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestSpscFifo,
+        spscfifo_should_be_empty_after_creation,
+        spscfifo_should_fill_up_and_wrap_around,
+        spscfifo_should_pass_items_in_order_across_threads)
@@ -0,0 +1,195 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "rtstealdeque.h"
+#include "rttest.h"
+#include "rtplf.h"
+#include <pthread.h>
+#include <sched.h>
+
+
+#define TEST_STEAL_ITEMS 200000u
+#define TEST_STEAL_THIEVES 3
+
+
+typedef struct {
+    uint32_t a;
+    uint32_t b;
+} TStealItem;
+
+static TStealItem gDequeBuffer[4];
+static RTStealDeque gDeque = RT_STEAL_DEQUE_INIT(gDequeBuffer);
+
+static TStealItem gStressBuffer[256];
+static RTStealDeque gStressDeque;
+static uint32_t gStressSeen[TEST_STEAL_ITEMS];
+static uint32_t gStressDone;
+static uint32_t gStressStolen[TEST_STEAL_THIEVES];
+
+
+static void testStealRecord(const TStealItem* item)
+{
+    if ((item->a < TEST_STEAL_ITEMS) && (item->b == ~item->a)) {
+        RTATOMIC_FETCH_ADD(&gStressSeen[item->a], 1u);
+    }
+}
+
+
+static void* testStealThief(void* arg)
+{
+    long thief = (long)arg;
+    TStealItem item;
+    RTBool done = RTFalse;
+
+    while (!done) {
+        if (RTStealDequeSteal(&gStressDeque, &item, sizeof(item))) {
+            testStealRecord(&item);
+            gStressStolen[thief]++;
+        } else if (RTATOMIC_LOAD_ACQUIRE(&gStressDone)) {
+            done = RTTrue;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+
+RTT_GROUP_START(TestStealDeque, 0x00020016u, NULL, NULL)
+
+RTT_TEST_START(steal_deque_should_be_empty_after_creation)
+{
+    TStealItem item;
+
+    RTT_ASSERT(RTStealDequeCapacity(&gDeque) == 4u);
+    RTT_ASSERT(RTStealDequeIsEmpty(&gDeque));
+    RTT_ASSERT(!RTStealDequePop(&gDeque, &item, sizeof(item)));
+    RTT_ASSERT(!RTStealDequeSteal(&gDeque, &item, sizeof(item)));
+    RTT_ASSERT(RTStealDequeSize(&gDeque) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(steal_deque_should_push_until_full)
+{
+    TStealItem item;
+    uint32_t i;
+
+    for (i = 0; i < 4; i++) {
+        item.a = i;
+        item.b = ~i;
+        RTT_ASSERT(RTStealDequePush(&gDeque, &item, sizeof(item)));
+    }
+    RTT_ASSERT(!RTStealDequePush(&gDeque, &item, sizeof(item)));
+    RTT_ASSERT(RTStealDequeSize(&gDeque) == 4u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(steal_deque_owner_should_pop_newest_and_thief_oldest)
+{
+    TStealItem item;
+
+    RTT_ASSERT(RTStealDequePop(&gDeque, &item, sizeof(item)));
+    RTT_EXPECT(item.a == 3u);
+    RTT_ASSERT(RTStealDequeSteal(&gDeque, &item, sizeof(item)));
+    RTT_EXPECT(item.a == 0);
+    RTT_ASSERT(RTStealDequeSteal(&gDeque, &item, sizeof(item)));
+    RTT_EXPECT(item.a == 1u);
+    RTT_ASSERT(RTStealDequeSize(&gDeque) == 1u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(steal_deque_should_wrap_around)
+{
+    TStealItem item;
+    uint32_t i;
+
+    for (i = 10; i < 13; i++) {
+        item.a = i;
+        RTT_ASSERT(RTStealDequePush(&gDeque, &item, sizeof(item)));
+    }
+    RTT_ASSERT(!RTStealDequePush(&gDeque, &item, sizeof(item)));
+    RTT_ASSERT(RTStealDequeSteal(&gDeque, &item, sizeof(item)));
+    RTT_EXPECT(item.a == 2u);
+    for (i = 13; i > 10; i--) {
+        RTT_ASSERT(RTStealDequePop(&gDeque, &item, sizeof(item)));
+        RTT_EXPECT(item.a == (i - 1u));
+    }
+    RTT_ASSERT(!RTStealDequePop(&gDeque, &item, sizeof(item)));
+    RTT_ASSERT(RTStealDequeIsEmpty(&gDeque));
+}
+RTT_TEST_END
+
+RTT_TEST_START(steal_deque_should_hand_out_every_item_exactly_once)
+{
+    pthread_t threads[TEST_STEAL_THIEVES];
+    TStealItem item;
+    uint32_t stolen = 0;
+    uint32_t i;
+    long t;
+
+    RTStealDequeInit(&gStressDeque, RTARRAYSIZE(gStressBuffer),
+            sizeof(gStressBuffer[0]), (RTByte*)gStressBuffer);
+    gStressDone = 0;
+    for (t = 0; t < TEST_STEAL_THIEVES; t++) {
+        gStressStolen[t] = 0;
+        RTT_ASSERT(pthread_create(&threads[t], NULL, testStealThief,
+                    (void*)t) == 0);
+    }
+
+    /* The owner pops one item every 3 pushes, and when the deque is full */
+    for (i = 0; i < TEST_STEAL_ITEMS; i++) {
+        item.a = i;
+        item.b = ~i;
+        while (!RTStealDequePush(&gStressDeque, &item, sizeof(item))) {
+            TStealItem popped;
+            if (RTStealDequePop(&gStressDeque, &popped, sizeof(popped))) {
+                testStealRecord(&popped);
+            }
+        }
+        if ((i % 3u) == 0) {
+            TStealItem popped;
+            if (RTStealDequePop(&gStressDeque, &popped, sizeof(popped))) {
+                testStealRecord(&popped);
+            }
+        }
+        if ((i % 1024u) == 0) {
+            sched_yield(); /* Let thieves run, even on a single CPU */
+        }
+    }
+    while (RTStealDequePop(&gStressDeque, &item, sizeof(item))) {
+        testStealRecord(&item);
+    }
+    RTATOMIC_STORE_RELEASE(&gStressDone, 1u);
+    for (t = 0; t < TEST_STEAL_THIEVES; t++) {
+        pthread_join(threads[t], NULL);
+        stolen += gStressStolen[t];
+    }
+
+    RTT_ASSERT(RTStealDequeIsEmpty(&gStressDeque));
+    for (i = 0; i < TEST_STEAL_ITEMS; i++) {
+        RTT_ASSERT(gStressSeen[i] == 1u);
+    }
+    RTT_EXPECT(stolen > 0);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestStealDeque,
+        steal_deque_should_be_empty_after_creation,
+        steal_deque_should_push_until_full,
+        steal_deque_owner_should_pop_newest_and_thief_oldest,
+        steal_deque_should_wrap_around,
+        steal_deque_should_hand_out_every_item_exactly_once)
@@ -0,0 +1,160 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Hold-model benchmark of heaps vs a sorted array
+ *
+ * A queue of jobs ordered by deadline is filled with `n` jobs, then each
+ * operation pops the job with the earliest deadline and pushes a new job with
+ * a later deadline, so the queue size stays at `n`. This is what a deadline
+ * scheduler does. The baseline is a sorted array where a push moves all the
+ * jobs with a later deadline, which is O(n).
+ */
+
+#include "rtheap.h"
+#include "rtplf.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+
+#define BENCH_MAX_JOBS 32768u
+#define BENCH_OPS 1000000u
+
+
+typedef struct {
+    uint32_t deadline;
+    uint32_t id;
+} BenchJob;
+
+static BenchJob gBuffer[BENCH_MAX_JOBS];
+static uint32_t gSeed;
+
+
+static double benchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+
+static uint32_t benchRandom(void)
+{
+    gSeed = (gSeed * 1103515245u) + 12345u;
+    return (gSeed >> 8) % 100000u;
+}
+
+
+static RTBool benchBefore(const void* a, const void* b)
+{
+    return ((const BenchJob*)a)->deadline < ((const BenchJob*)b)->deadline;
+}
+
+
+/** Push a job into an array sorted by decreasing deadline */
+static void benchSortedPush(uint32_t* size, const BenchJob* job)
+{
+    uint32_t lo = 0;
+    uint32_t hi = *size;
+
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2u;
+        if (gBuffer[mid].deadline > job->deadline) {
+            lo = mid + 1u;
+        } else {
+            hi = mid;
+        }
+    }
+    memmove(&gBuffer[lo + 1u], &gBuffer[lo], (*size - lo) * sizeof(BenchJob));
+    gBuffer[lo] = *job;
+    (*size)++;
+}
+
+
+/** Pop the job with the earliest deadline, which is at the end */
+static void benchSortedPop(uint32_t* size, BenchJob* job)
+{
+    (*size)--;
+    *job = gBuffer[*size];
+}
+
+
+static void benchPrint(const char* name, uint32_t n, double elapsed)
+{
+    printf("%-8s jobs=%-6u ops=%u seconds=%.3f Mops/s=%.2f\n", name, n,
+            BENCH_OPS, elapsed, ((double)BENCH_OPS / elapsed) / 1e6);
+}
+
+
+static void benchHeap(const char* name, uint8_t arity, uint32_t n)
+{
+    RTHeap heap;
+    BenchJob job;
+    uint32_t i;
+    double start;
+
+    gSeed = 1;
+    RTHeapInit(&heap, (uint16_t)n, sizeof(BenchJob), (RTByte*)gBuffer,
+            benchBefore, arity);
+    for (i = 0; i < n; i++) {
+        job.deadline = benchRandom();
+        job.id = i;
+        RTASSERT(RTHeapPush(&heap, &job, sizeof(job)));
+    }
+    start = benchNow();
+    for (i = 0; i < BENCH_OPS; i++) {
+        RTASSERT(RTHeapPop(&heap, &job, sizeof(job)));
+        job.deadline += benchRandom();
+        RTASSERT(RTHeapPush(&heap, &job, sizeof(job)));
+    }
+    benchPrint(name, n, benchNow() - start);
+}
+
+
+static void benchSorted(uint32_t n)
+{
+    BenchJob job;
+    uint32_t size = 0;
+    uint32_t i;
+    double start;
+
+    gSeed = 1;
+    for (i = 0; i < n; i++) {
+        job.deadline = benchRandom();
+        job.id = i;
+        benchSortedPush(&size, &job);
+    }
+    start = benchNow();
+    for (i = 0; i < BENCH_OPS; i++) {
+        benchSortedPop(&size, &job);
+        job.deadline += benchRandom();
+        benchSortedPush(&size, &job);
+    }
+    benchPrint("sorted", n, benchNow() - start);
+}
+
+
+int main(void)
+{
+    uint32_t n;
+
+    for (n = 64; n <= BENCH_MAX_JOBS; n *= 8) {
+        benchHeap("heap2", 2, n);
+        benchHeap("heap4", 4, n);
+        benchSorted(n);
+    }
+    return 0;
+}
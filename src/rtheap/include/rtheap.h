@@ -0,0 +1,203 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Binary heaps
+ *
+ * @defgroup rtheap Heaps
+ * @addtogroup rtheap
+ * @{
+ *
+ * A heap is a priority queue with a fixed capacity. Like a FIFO, it stores
+ * copies of fixed-size items in a buffer provided by the user. But instead of
+ * the oldest item, a pop returns the item that comes first according to a
+ * function provided by the user, eg: the item with the earliest deadline.
+ *
+ * Both pushes and pops take O(log n) time. Items that come first equally are
+ * popped in an unspecified order.
+ *
+ * A heap can be binary, or 4-ary. A 4-ary heap is half as deep as a binary
+ * one, and the 4 children of an item are next to each other in the buffer, so
+ * a pop touches fewer cache lines; this is usually faster for large heaps of
+ * small items, at the cost of more comparisons per level.
+ *
+ * Like regular FIFOs, heaps are not thread-safe.
+ */
+
+#ifndef RTHEAP_h_
+#define RTHEAP_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Function telling whether an item must be popped before another one
+ *
+ * @param a [in] An item in the heap, or being pushed
+ * @param b [in] Another item in the heap, or being pushed
+ *
+ * @return `RTTrue` if `a` must be popped before `b`, `RTFalse` otherwise (in
+ *         particular if `a` and `b` come first equally)
+ */
+typedef RTBool (*RTHeapBefore)(const void* a, const void* b);
+
+
+#include "rtheap_priv.h"
+
+
+/** "Opaque" type that represents a heap
+ *
+ * This heap can take up to 65,535 items. Items must be of the same size, which
+ * can be up to 65,535 bytes.
+ *
+ * *Important note*: Never access the structure directly! Always use the heap
+ * functions.
+ */
+typedef struct RTHeap RTHeap;
+
+
+/** Macro initialiser for a statically-allocated heap
+ *
+ * This macro can be used to initialise a heap when the underlying buffer has
+ * been previously *statically* declared as an array. `_arity` is the number of
+ * children of each item; compilation will fail if it is not 2 or 4.
+ *
+ * The heap will then take ownership of the `_buffer`, which should then not
+ * be accessed by anything else.
+ *
+ * For example:
+ *   typedef struct { uint32_t deadline; ... } MyJob;
+ *   static RTBool myJobBefore(const void* a, const void* b)
+ *   {
+ *       return ((const MyJob*)a)->deadline < ((const MyJob*)b)->deadline;
+ *   }
+ *   static MyJob gMyBuffer[64];
+ *   static RTHeap gMyHeap = RT_HEAP_INIT(gMyBuffer, myJobBefore, 4);
+ */
+#define RT_HEAP_INIT(_buffer, _before, _arity) \
+    RTPRIV_HEAP_INIT(_buffer, _before, _arity)
+
+
+
+/*------------------------------+
+ | Public function declarations |
+ +------------------------------*/
+
+
+/** Dynamically initialise a heap
+ *
+ * **DO NOT** call this function on a heap that has been already initialised
+ * with `RT_HEAP_INIT()`.
+ *
+ * @param heap       [in,out] Heap to initialise; must not be NULL.
+ * @param capacity   [in]     Heap capacity, in number of items; must be > 0.
+ * @param itemSize_B [in]     Size of a single item in the heap, in bytes; must
+ *                            be > 0.
+ * @param buffer     [in]     Where the heap items should be stored. `buffer`
+ *                            must not be NULL and must point to a memory area
+ *                            at least `capacity` * `itemSize_B` in size (in
+ *                            bytes).
+ * @param before     [in]     Function ordering the items; must not be NULL.
+ * @param arity      [in]     Number of children of each item; must be 2 or 4.
+ *
+ * @return Nothing
+ */
+void RTHeapInit(RTHeap* heap, uint16_t capacity, uint16_t itemSize_B,
+        RTByte* buffer, RTHeapBefore before, uint8_t arity);
+
+
+/** Get the number of items in a heap
+ *
+ * @param heap [in] Heap to query; must not be NULL.
+ *
+ * @return The number of items currently stored in the heap
+ */
+uint16_t RTHeapSize(const RTHeap* heap);
+
+
+/** Get the capacity of a heap
+ *
+ * @param heap [in] Heap to query; must not be NULL.
+ *
+ * @return The maximum number of items the heap can hold
+ */
+uint16_t RTHeapCapacity(const RTHeap* heap);
+
+
+/** Test if a heap is empty
+ *
+ * @param heap [in] Heap to query; must not be NULL.
+ *
+ * @return `RTTrue` if the heap is empty, `RTFalse` if not
+ */
+RTBool RTHeapIsEmpty(const RTHeap* heap);
+
+
+/** Test if a heap is full
+ *
+ * @param heap [in] Heap to query; must not be NULL.
+ *
+ * @return `RTTrue` if the heap is full, `RTFalse` if not
+ */
+RTBool RTHeapIsFull(const RTHeap* heap);
+
+
+/** Push an item into a heap
+ *
+ * @param heap       [in,out] Heap where to push the item; must not be NULL.
+ * @param item       [in]     The item to push; must not be NULL. The item
+ *                            itself will be copied, so you retain the ownership
+ *                            of the `item`.
+ * @param itemSize_B [in]     The size of the `item`, in bytes. `itemSize_B`
+ *                            must be equal to the size of heap items, as the
+ *                            whole item is passed to the `before` function.
+ *
+ * @return `RTTrue` if success, `RTFalse` if the heap is full
+ */
+RTBool RTHeapPush(RTHeap* heap, const void* item, uint16_t itemSize_B);
+
+
+/** Pop the item that comes first from a heap
+ *
+ * @param heap       [in,out] Heap from where to pop the item; must not be NULL.
+ * @param item       [out]    Where to write the popped item; must not be NULL.
+ * @param itemSize_B [in]     Size of the `item` buffer, in bytes. `itemSize_B`
+ *                            must be >= the size of heap items.
+ *
+ * @return `RTTrue` if success, `RTFalse` if the heap is empty
+ */
+RTBool RTHeapPop(RTHeap* heap, void* item, uint16_t itemSize_B);
+
+
+/** Get a pointer to the item that comes first in a heap
+ *
+ * The heap is not modified by this function.
+ *
+ * @param heap [in] Heap to query; must not be NULL.
+ *
+ * @return A pointer to the item that comes first, or NULL if the heap is
+ *         empty. The pointer remains valid until the next push or pop.
+ */
+const void* RTHeapPeek(const RTHeap* heap);
+
+
+
+#endif /* RTHEAP_h_ */
+/* @} */
@@ -0,0 +1,61 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* You should not include this file directly; include "rtheap.h" instead. */
+
+#ifndef RTHEAP_PRIV_h_
+#define RTHEAP_PRIV_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Heap structure
+ *
+ * The items are stored in `buffer` as an implicit tree: the children of item
+ * `i` are items `arity * i + 1` to `arity * i + arity`. Every item comes
+ * first equally or before its children, so item 0 comes first.
+ */
+struct RTHeap {
+    uint16_t     capacity;   /**< Capacity of the heap, in items */
+    uint16_t     itemSize_B; /**< Size of one item, in bytes */
+    uint16_t     size;       /**< Number of items in the heap */
+    uint8_t      arity;      /**< Number of children of each item */
+    RTHeapBefore before;     /**< Function ordering the items */
+    RTByte*      buffer;     /**< Where to store the items */
+};
+
+
+/** Macro initialiser for a statically-allocated heap */
+#define RTPRIV_HEAP_INIT(_buffer, _before, _arity)                      \
+    {                                                                   \
+        RTARRAYSIZE(_buffer),                                           \
+        sizeof((_buffer)[0]),                                           \
+        0,                                                              \
+        (_arity)                                                        \
+            + RTSTATIC_CHECK(((_arity) == 2) || ((_arity) == 4)),       \
+        (_before),                                                      \
+        (RTByte*)(_buffer)                                              \
+    }
+
+
+
+#endif /* RTHEAP_PRIV_h_ */
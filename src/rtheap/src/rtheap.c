@@ -0,0 +1,224 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtplf.h"
+#include "rtheap.h"
+
+
+
+/*-------------------------------+
+ | Private function declarations |
+ +-------------------------------*/
+
+
+/** Get a pointer to an item of a heap
+ *
+ * @param heap  [in] The heap the item belongs to
+ * @param index [in] Index of the item
+ *
+ * @return A pointer to the item in the heap buffer
+ */
+static RTByte* rtheapItem(const RTHeap* heap, uint32_t index);
+
+
+/** Move down a hole until `item` can be written into it
+ *
+ * The children that come before `item` are moved up into the hole, one level
+ * at a time.
+ *
+ * @param heap [in,out] The heap
+ * @param hole [in]     Index of the hole
+ * @param item [in]     The item that will fill the hole
+ *
+ * @return The final index of the hole
+ */
+static uint32_t rtheapSiftDown(RTHeap* heap, uint32_t hole,
+        const RTByte* item);
+
+
+
+/*---------------------------------+
+ | Public function implementations |
+ +---------------------------------*/
+
+
+void RTHeapInit(RTHeap* heap, uint16_t capacity, uint16_t itemSize_B,
+        RTByte* buffer, RTHeapBefore before, uint8_t arity)
+{
+    RTASSERT(heap != NULL);
+    RTASSERT(capacity > 0);
+    RTASSERT(itemSize_B > 0);
+    RTASSERT(buffer != NULL);
+    RTASSERT(before != NULL);
+    RTASSERT((2 == arity) || (4 == arity));
+
+    heap->capacity = capacity;
+    heap->itemSize_B = itemSize_B;
+    heap->size = 0;
+    heap->arity = arity;
+    heap->before = before;
+    heap->buffer = buffer;
+}
+
+
+uint16_t RTHeapSize(const RTHeap* heap)
+{
+    RTASSERT(heap != NULL);
+    return heap->size;
+}
+
+
+uint16_t RTHeapCapacity(const RTHeap* heap)
+{
+    RTASSERT(heap != NULL);
+    return heap->capacity;
+}
+
+
+RTBool RTHeapIsEmpty(const RTHeap* heap)
+{
+    RTASSERT(heap != NULL);
+    return 0 == heap->size;
+}
+
+
+RTBool RTHeapIsFull(const RTHeap* heap)
+{
+    RTASSERT(heap != NULL);
+    return heap->size >= heap->capacity;
+}
+
+
+RTBool RTHeapPush(RTHeap* heap, const void* item, uint16_t itemSize_B)
+{
+    RTBool pushed = RTFalse;
+    RTBool done = RTFalse;
+    uint32_t hole;
+
+    RTASSERT(heap != NULL);
+    RTASSERT(heap->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B == heap->itemSize_B);
+
+    if (heap->size < heap->capacity) {
+        /* Move up a hole from the end of the heap until `item` does not come
+         * before the parent of the hole */
+        hole = heap->size;
+        while (!done && (hole > 0)) {
+            uint32_t parent = (hole - 1u) / heap->arity;
+            RTByte* parentItem = rtheapItem(heap, parent);
+            if (heap->before(item, parentItem)) {
+                RTMemcpy(rtheapItem(heap, hole), heap->itemSize_B,
+                        parentItem, heap->itemSize_B);
+                hole = parent;
+            } else {
+                done = RTTrue;
+            }
+        }
+        RTMemcpy(rtheapItem(heap, hole), heap->itemSize_B, item, itemSize_B);
+        heap->size++;
+        pushed = RTTrue;
+    }
+    return pushed;
+}
+
+
+RTBool RTHeapPop(RTHeap* heap, void* item, uint16_t itemSize_B)
+{
+    RTBool popped = RTFalse;
+
+    RTASSERT(heap != NULL);
+    RTASSERT(heap->buffer != NULL);
+    RTASSERT(item != NULL);
+    RTASSERT(itemSize_B >= heap->itemSize_B);
+
+    if (heap->size > 0) {
+        RTMemcpy(item, itemSize_B, heap->buffer, heap->itemSize_B);
+        heap->size--;
+        if (heap->size > 0) {
+            /* Fill the hole at the top with the last item; the last item is
+             * beyond the new size, so the hole never reaches it */
+            RTByte* last = rtheapItem(heap, heap->size);
+            uint32_t hole = rtheapSiftDown(heap, 0, last);
+            RTMemcpy(rtheapItem(heap, hole), heap->itemSize_B,
+                    last, heap->itemSize_B);
+        }
+        popped = RTTrue;
+    }
+    return popped;
+}
+
+
+const void* RTHeapPeek(const RTHeap* heap)
+{
+    const void* item = NULL;
+
+    RTASSERT(heap != NULL);
+
+    if (heap->size > 0) {
+        item = heap->buffer;
+    }
+    return item;
+}
+
+
+
+/*----------------------------------+
+ | Private function implementations |
+ +----------------------------------*/
+
+
+static RTByte* rtheapItem(const RTHeap* heap, uint32_t index)
+{
+    return &(heap->buffer[(size_t)index * heap->itemSize_B]);
+}
+
+
+static uint32_t rtheapSiftDown(RTHeap* heap, uint32_t hole,
+        const RTByte* item)
+{
+    RTBool done = RTFalse;
+
+    while (!done) {
+        uint32_t first = (heap->arity * hole) + 1u;
+        uint32_t end = first + heap->arity;
+        uint32_t best = first;
+        uint32_t child;
+
+        if (first >= heap->size) {
+            done = RTTrue;
+        } else {
+            /* Find the child that comes first */
+            if (end > heap->size) {
+                end = heap->size;
+            }
+            for (child = first + 1u; child < end; child++) {
+                if (heap->before(rtheapItem(heap, child),
+                            rtheapItem(heap, best))) {
+                    best = child;
+                }
+            }
+            if (heap->before(rtheapItem(heap, best), item)) {
+                RTMemcpy(rtheapItem(heap, hole), heap->itemSize_B,
+                        rtheapItem(heap, best), heap->itemSize_B);
+                hole = best;
+            } else {
+                done = RTTrue;
+            }
+        }
+    }
+    return hole;
+}
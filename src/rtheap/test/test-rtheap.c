@@ -0,0 +1,149 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "rtheap.h"
+#include "rttest.h"
+#include "rtplf.h"
+
+
+#define TEST_HEAP_ITEMS 1000u
+
+
+typedef struct {
+    uint32_t deadline;
+    uint32_t id;
+} THeapJob;
+
+
+static RTBool testHeapBefore(const void* a, const void* b)
+{
+    return ((const THeapJob*)a)->deadline < ((const THeapJob*)b)->deadline;
+}
+
+static THeapJob gHeapBuffer[5];
+static RTHeap gHeap = RT_HEAP_INIT(gHeapBuffer, testHeapBefore, 2);
+
+static THeapJob gStressBuffer[TEST_HEAP_ITEMS];
+static RTHeap gStressHeap;
+
+
+/** Push pseudo-random jobs into `gStressHeap` and check they pop in order
+ *
+ * Pops are interleaved with pushes, so items are pushed into a heap which is
+ * neither empty nor freshly built.
+ *
+ * @return `RTTrue` if all the jobs have been popped in order
+ */
+static RTBool testHeapStress(uint8_t arity)
+{
+    RTBool ok = RTTrue;
+    uint32_t seed = 12345u;
+    uint32_t popped = 0;
+    uint32_t last = 0;
+    THeapJob job;
+    uint32_t i;
+
+    RTHeapInit(&gStressHeap, TEST_HEAP_ITEMS, sizeof(THeapJob),
+            (RTByte*)gStressBuffer, testHeapBefore, arity);
+    for (i = 0; i < TEST_HEAP_ITEMS; i++) {
+        seed = (seed * 1103515245u) + 12345u;
+        job.deadline = (seed >> 8) % 10000u;
+        job.id = i;
+        ok = ok && RTHeapPush(&gStressHeap, &job, sizeof(job));
+        if ((i % 4u) == 3u) {
+            /* The popped job must come first among the jobs in the heap */
+            ok = ok && RTHeapPop(&gStressHeap, &job, sizeof(job));
+            ok = ok && (RTHeapIsEmpty(&gStressHeap)
+                    || (job.deadline <= ((const THeapJob*)
+                            RTHeapPeek(&gStressHeap))->deadline));
+            popped++;
+        }
+    }
+    while (RTHeapPop(&gStressHeap, &job, sizeof(job))) {
+        ok = ok && (job.deadline >= last);
+        last = job.deadline;
+        popped++;
+    }
+    return ok && (TEST_HEAP_ITEMS == popped);
+}
+
+
+RTT_GROUP_START(TestHeap, 0x00040001u, NULL, NULL)
+
+RTT_TEST_START(heap_should_be_empty_after_creation)
+{
+    THeapJob job;
+
+    RTT_ASSERT(RTHeapCapacity(&gHeap) == 5u);
+    RTT_ASSERT(RTHeapSize(&gHeap) == 0);
+    RTT_ASSERT(RTHeapIsEmpty(&gHeap));
+    RTT_ASSERT(!RTHeapIsFull(&gHeap));
+    RTT_ASSERT(RTHeapPeek(&gHeap) == NULL);
+    RTT_ASSERT(!RTHeapPop(&gHeap, &job, sizeof(job)));
+}
+RTT_TEST_END
+
+RTT_TEST_START(heap_should_push_until_full)
+{
+    static const uint32_t deadlines[5] = { 30, 10, 50, 20, 40 };
+    THeapJob job;
+    uint32_t i;
+
+    for (i = 0; i < 5; i++) {
+        job.deadline = deadlines[i];
+        job.id = i;
+        RTT_ASSERT(RTHeapPush(&gHeap, &job, sizeof(job)));
+    }
+    RTT_ASSERT(RTHeapIsFull(&gHeap));
+    RTT_ASSERT(!RTHeapPush(&gHeap, &job, sizeof(job)));
+    RTT_ASSERT(RTHeapSize(&gHeap) == 5u);
+    RTT_EXPECT(((const THeapJob*)RTHeapPeek(&gHeap))->deadline == 10u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(heap_should_pop_earliest_first)
+{
+    THeapJob job;
+    uint32_t i;
+
+    for (i = 1; i <= 5; i++) {
+        RTT_ASSERT(RTHeapPop(&gHeap, &job, sizeof(job)));
+        RTT_EXPECT(job.deadline == (i * 10u));
+    }
+    RTT_ASSERT(RTHeapIsEmpty(&gHeap));
+    RTT_ASSERT(!RTHeapPop(&gHeap, &job, sizeof(job)));
+}
+RTT_TEST_END
+
+RTT_TEST_START(binary_heap_should_pop_random_items_in_order)
+{
+    RTT_ASSERT(testHeapStress(2));
+}
+RTT_TEST_END
+
+RTT_TEST_START(quaternary_heap_should_pop_random_items_in_order)
+{
+    RTT_ASSERT(testHeapStress(4));
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestHeap,
+        heap_should_be_empty_after_creation,
+        heap_should_push_until_full,
+        heap_should_pop_earliest_first,
+        binary_heap_should_pop_random_items_in_order,
+        quaternary_heap_should_pop_random_items_in_order)
@@ -66,6 +66,7 @@
 
 #include "rtplf.h"
 #include "rtfifo.h"
+#include "rtmpscfifo.h"
 
 
 
@@ -270,7 +271,8 @@ typedef struct {
     uint8_t     statesSize; /**< Size of `states` array */
     RTHsmState* global;     /**< The global state for this state machine */
     RTHsmState* current;    /**< Current state */
-    RTFifo*     eventQueue; /**< Event queue */
+    RTFifo*     eventQueue; /**< Event queue, or NULL if `mpscQueue` is used */
+    RTMpscFifo* mpscQueue;  /**< Event queue, or NULL if `eventQueue` is used */
 } RTHsm;
 
 
@@ -308,11 +310,34 @@ void RTHsmInit(RTHsm* hsm, RTHsmState* states, uint8_t statesSize,
         RTFifo* eventQueue);
 
 
+/** Initialise a state machine that uses an MPSC FIFO as event queue
+ *
+ * This is the same as `RTHsmInit()`, except that events are queued in an MPSC
+ * FIFO. `RTHsmPushEvent()` can then be called from several threads at the same
+ * time without any lock, while `RTHsmStep()` is called from a single thread.
+ *
+ * The items of `eventQueue` must be `RTHsmEvent` structures.
+ *
+ * @param hsm        [out]    The HSM structure to initialise
+ * @param states     [in,out] Array of states for this state machine; see
+ *                            `RTHsmInit()`.
+ * @param statesSize [in,out] Size of the above array
+ * @param eventQueue [in,out] Event queue to use; the ownership is transferred
+ *                            to this module, do not touch the FIFO once
+ *                            `RTHsmInitMpsc()` is called.
+ */
+void RTHsmInitMpsc(RTHsm* hsm, RTHsmState* states, uint8_t statesSize,
+        RTMpscFifo* eventQueue);
+
+
 /** Push an event to a state machine
  *
  * This is just a utility function that encapsulates a call to push the event
  * onto the state machine queue.
  *
+ * If the state machine has been initialised with `RTHsmInitMpsc()`, this
+ * function may be called concurrently from several threads.
+ *
  * @param hsm   [in,out] The HSM where to push the event
  * @param event [in]     The event to push; a copy of the `event` will be made,
  *                       so the ownership of the `event` remains with you.
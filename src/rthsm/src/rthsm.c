@@ -24,6 +24,25 @@
  +-------------------------------*/
 
 
+/** Initialise a state machine, except for its event queue
+ *
+ * @param hsm        [out]    The HSM structure to initialise
+ * @param states     [in,out] Array of states for this state machine
+ * @param statesSize [in,out] Size of the above array
+ */
+static void rthsmInit(RTHsm* hsm, RTHsmState* states, uint8_t statesSize);
+
+
+/** Pop the next event from the event queue of a state machine
+ *
+ * @param hsm   [in,out] The state machine to work on
+ * @param event [out]    Where to write the popped event
+ *
+ * @return `RTTrue` if an event has been popped, `RTFalse` if the queue is empty
+ */
+static RTBool rthsmPopEvent(RTHsm* hsm, RTHsmEvent* event);
+
+
 /** Lookup a state from its id
  *
  * @param hsm [in] The state machine to query
@@ -103,19 +122,104 @@ static void rthsmDoTransition(RTHsm* hsm,
 
 void RTHsmInit(RTHsm* hsm, RTHsmState* states, uint8_t statesSize,
         RTFifo* eventQueue)
+{
+    RTASSERT(hsm != NULL);
+    RTASSERT(eventQueue != NULL);
+
+    hsm->eventQueue = eventQueue;
+    hsm->mpscQueue = NULL;
+    rthsmInit(hsm, states, statesSize);
+}
+
+
+void RTHsmInitMpsc(RTHsm* hsm, RTHsmState* states, uint8_t statesSize,
+        RTMpscFifo* eventQueue)
+{
+    RTASSERT(hsm != NULL);
+    RTASSERT(eventQueue != NULL);
+
+    hsm->eventQueue = NULL;
+    hsm->mpscQueue = eventQueue;
+    rthsmInit(hsm, states, statesSize);
+}
+
+
+RTBool RTHsmPushEvent(RTHsm* hsm, const RTHsmEvent* event)
+{
+    RTBool pushed;
+    if (hsm->mpscQueue != NULL) {
+        pushed = RTMpscFifoPush(hsm->mpscQueue, event, sizeof(*event));
+    } else {
+        pushed = RTFifoPush(hsm->eventQueue, event, sizeof(*event));
+    }
+    return pushed;
+}
+
+
+RTHsmResult RTHsmStep(RTHsm* hsm, uint8_t* guardResult)
+{
+    RTHsmResult result;
+    RTHsmEvent event;
+
+    RTASSERT(hsm != NULL);
+
+    if (hsm->current == NULL) {
+        /* This is the first time `RTHsmStep()` is called */
+        rthsmTraverseToChildmostState(hsm, hsm->global);
+        result = RTHSM_STEP_RESULT_OK;
+
+    } else if (hsm->current->flags & RTHSM_STATE_FLAG_FINAL) {
+        /* This state machine is now terminated */
+        result = RTHSM_STEP_RESULT_TERMINATED;
+
+    } else if (!rthsmPopEvent(hsm, &event)) {
+        result = RTHSM_STEP_RESULT_EMPTY;
+
+    } else {
+        uint8_t gresult;
+        RTHsmTransition* transition = rthsmGetBestTransition(hsm,
+                &event, &gresult);
+
+        if (transition == NULL) {
+            if (gresult != 0) {
+                result = RTHSM_STEP_RESULT_GUARD;
+                if (guardResult != NULL) {
+                    *guardResult = gresult;
+                }
+            } else {
+                result = RTHSM_STEP_RESULT_DISCARDED;
+            }
+        } else {
+            if (transition->toState == hsm->current) {
+                rthsmDoSelfTransition(hsm, transition, &event);
+            } else {
+                rthsmDoTransition(hsm, transition, &event);
+            }
+            result = RTHSM_STEP_RESULT_OK;
+        }
+    }
+    return result;
+}
+
+
+
+/*----------------------------------+
+ | Private function implementations |
+ +----------------------------------*/
+
+
+static void rthsmInit(RTHsm* hsm, RTHsmState* states, uint8_t statesSize)
 {
     uint8_t i;
 
     RTASSERT(hsm != NULL);
     RTASSERT(states != NULL);
     RTASSERT(statesSize > 0);
-    RTASSERT(eventQueue != NULL);
 
     hsm->states = states;
     hsm->statesSize = statesSize;
     hsm->global = NULL;
     hsm->current = NULL;
-    hsm->eventQueue = eventQueue;
 
     /* Cache state pointers from ids, & check there is only one global state */
     for (i = 0; i < hsm->statesSize; i++) {
@@ -205,64 +309,18 @@ void RTHsmInit(RTHsm* hsm, RTHsmState* states, uint8_t statesSize,
 }
 
 
-RTBool RTHsmPushEvent(RTHsm* hsm, const RTHsmEvent* event)
+static RTBool rthsmPopEvent(RTHsm* hsm, RTHsmEvent* event)
 {
-    return RTFifoPush(hsm->eventQueue, event, sizeof(*event));
-}
-
-
-RTHsmResult RTHsmStep(RTHsm* hsm, uint8_t* guardResult)
-{
-    RTHsmResult result;
-    RTHsmEvent event;
-
-    RTASSERT(hsm != NULL);
-
-    if (hsm->current == NULL) {
-        /* This is the first time `RTHsmStep()` is called */
-        rthsmTraverseToChildmostState(hsm, hsm->global);
-        result = RTHSM_STEP_RESULT_OK;
-
-    } else if (hsm->current->flags & RTHSM_STATE_FLAG_FINAL) {
-        /* This state machine is now terminated */
-        result = RTHSM_STEP_RESULT_TERMINATED;
-
-    } else if (!RTFifoPop(hsm->eventQueue, &event, sizeof(event))) {
-        result = RTHSM_STEP_RESULT_EMPTY;
-
+    RTBool popped;
+    if (hsm->mpscQueue != NULL) {
+        popped = RTMpscFifoPop(hsm->mpscQueue, event, sizeof(*event));
     } else {
-        uint8_t gresult;
-        RTHsmTransition* transition = rthsmGetBestTransition(hsm,
-                &event, &gresult);
-
-        if (transition == NULL) {
-            if (gresult != 0) {
-                result = RTHSM_STEP_RESULT_GUARD;
-                if (guardResult != NULL) {
-                    *guardResult = gresult;
-                }
-            } else {
-                result = RTHSM_STEP_RESULT_DISCARDED;
-            }
-        } else {
-            if (transition->toState == hsm->current) {
-                rthsmDoSelfTransition(hsm, transition, &event);
-            } else {
-                rthsmDoTransition(hsm, transition, &event);
-            }
-            result = RTHSM_STEP_RESULT_OK;
-        }
+        popped = RTFifoPop(hsm->eventQueue, event, sizeof(*event));
     }
-    return result;
+    return popped;
 }
 
 
-
-/*----------------------------------+
- | Private function implementations |
- +----------------------------------*/
-
-
 static RTHsmState* rthsmLookupStateFromId(const RTHsm* hsm, uint8_t id)
 {
     RTHsmState* state = NULL;
@@ -22,6 +22,8 @@
 #include "rttest.h"
 #include "rtplf.h"
 #include "rtfifo.h"
+#include <pthread.h>
+#include <sched.h>
 
 #if (RTHSM_MAX_NESTED_STATES != 3)
 #error "RTHSM_MAX_NESTED_STATES must be set to 3"
@@ -967,3 +969,270 @@ RTT_GROUP_END(HsmRunStateMachine,
         hsm_iter5_should_discard_useless_events,
         hsm_iter5_should_do_nothing_if_no_event,
         hsm_iter5_should_step_to_starting_state)
+
+
+/* --- Small state machine fed through an MPSC FIFO --- */
+
+static RTHsm gMpscHsm;
+static RTHsmEvent gMpscEventsBuffer[4];
+static uint32_t gMpscEventsSeqs[4];
+static RTMpscFifo gMpscEventQueue = RT_MPSC_FIFO_INIT(gMpscEventsBuffer,
+        gMpscEventsSeqs);
+
+static RTHsmTransition gMpscIdleTransitions[] =
+{
+    {
+        STATE_ID_FINISHED, /* toStateId */
+        EV_NEXT,           /* eventId */
+        0,                 /* flags */
+        NULL,              /* guard */
+        NULL,              /* action */
+        NULL,              /* cookie */
+        NULL               /* private: toState */
+    }
+};
+
+static RTHsmState gMpscStates[] =
+{
+    {
+        STATE_ID_GLOBAL,     /* id */
+        0,                   /* flags */
+        RTHSM_NULL_STATE_ID, /* parentId */
+        STATE_ID_STARTING,   /* initialId */
+        NULL,                /* entryAction */
+        NULL,                /* exitAction */
+        NULL,                /* cookie */
+        NULL,                /* transitions */
+        0,                   /* transitionsSize */
+        NULL,                /* private: parent */
+        NULL                 /* private: initial */
+    },
+    {
+        STATE_ID_STARTING,                  /* id */
+        0,                                  /* flags */
+        STATE_ID_GLOBAL,                    /* parentId */
+        RTHSM_NULL_STATE_ID,                /* initialId */
+        NULL,                               /* entryAction */
+        NULL,                               /* exitAction */
+        NULL,                               /* cookie */
+        gMpscIdleTransitions,               /* transitions */
+        RTARRAYSIZE(gMpscIdleTransitions),  /* transitionsSize */
+        NULL,                               /* private: parent */
+        NULL                                /* private: initial */
+    },
+    {
+        STATE_ID_FINISHED,      /* id */
+        RTHSM_STATE_FLAG_FINAL, /* flags */
+        STATE_ID_GLOBAL,        /* parentId */
+        RTHSM_NULL_STATE_ID,    /* initialId */
+        NULL,                   /* entryAction */
+        NULL,                   /* exitAction */
+        NULL,                   /* cookie */
+        NULL,                   /* transitions */
+        0,                      /* transitionsSize */
+        NULL,                   /* private: parent */
+        NULL                    /* private: initial */
+    }
+};
+
+
+RTT_GROUP_START(HsmMpscEventQueue, 0x00030003u, NULL, NULL)
+
+RTT_TEST_START(hsm_mpsc_should_initialise)
+{
+    RTHsmInitMpsc(&gMpscHsm, gMpscStates, RTARRAYSIZE(gMpscStates),
+            &gMpscEventQueue);
+    RTT_ASSERT(gMpscHsm.current == NULL);
+    RTT_ASSERT(RTHsmStep(&gMpscHsm, NULL) == RTHSM_STEP_RESULT_OK);
+    RTT_ASSERT(gMpscHsm.current->id == STATE_ID_STARTING);
+}
+RTT_TEST_END
+
+RTT_TEST_START(hsm_mpsc_should_do_nothing_if_no_event)
+{
+    RTT_ASSERT(RTHsmStep(&gMpscHsm, NULL) == RTHSM_STEP_RESULT_EMPTY);
+}
+RTT_TEST_END
+
+RTT_TEST_START(hsm_mpsc_should_process_events_in_order)
+{
+    RTHsmEvent event;
+    event.id = EV_DATA;
+    RTT_ASSERT(RTHsmPushEvent(&gMpscHsm, &event));
+    event.id = EV_NEXT;
+    RTT_ASSERT(RTHsmPushEvent(&gMpscHsm, &event));
+    RTT_ASSERT(RTHsmStep(&gMpscHsm, NULL) == RTHSM_STEP_RESULT_DISCARDED);
+    RTT_ASSERT(RTHsmStep(&gMpscHsm, NULL) == RTHSM_STEP_RESULT_OK);
+    RTT_ASSERT(gMpscHsm.current->id == STATE_ID_FINISHED);
+    RTT_ASSERT(RTHsmStep(&gMpscHsm, NULL) == RTHSM_STEP_RESULT_TERMINATED);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(HsmMpscEventQueue,
+        hsm_mpsc_should_initialise,
+        hsm_mpsc_should_do_nothing_if_no_event,
+        hsm_mpsc_should_process_events_in_order)
+
+
+/* --- Same kind of state machine, fed concurrently by several threads --- */
+
+#define TEST_HSM_PRODUCERS 4
+#define TEST_HSM_EVENTS_PER_PRODUCER 20000u
+
+static RTHsm gPostHsm;
+static RTHsmEvent gPostEventsBuffer[4];
+static uint32_t gPostEventsSeqs[4];
+static RTMpscFifo gPostEventQueue = RT_MPSC_FIFO_INIT(gPostEventsBuffer,
+        gPostEventsSeqs);
+static uint32_t gPostNext[TEST_HSM_PRODUCERS];
+static uint32_t gPostReceived = 0;
+static uint32_t gPostErrors = 0;
+
+
+/** Check that each producer's events are processed once and in order
+ *
+ * `params[0]` is the producer index, `params[1]` is the event index within
+ * that producer.
+ */
+static void rthsmTestPostAction(const RTHsmEvent* event, void* cookie)
+{
+    uint32_t producer = event->params[0];
+
+    (void)cookie; /* unused argument */
+
+    if (    (producer >= TEST_HSM_PRODUCERS)
+         || (event->params[1] != gPostNext[producer])) {
+        gPostErrors++;
+    } else {
+        gPostNext[producer]++;
+    }
+    gPostReceived++;
+}
+
+
+/** Post `TEST_HSM_EVENTS_PER_PRODUCER` numbered events to `gPostHsm` */
+static void* rthsmTestPostProducer(void* arg)
+{
+    RTHsmEvent event;
+    uint32_t i;
+
+    event.id = EV_DATA;
+    event.params[0] = (uint32_t)(long)arg;
+    for (i = 0; i < TEST_HSM_EVENTS_PER_PRODUCER; i++) {
+        event.params[1] = i;
+        while (!RTHsmPushEvent(&gPostHsm, &event)) {
+            sched_yield(); /* Let the state machine run, even on a single CPU */
+        }
+    }
+    return NULL;
+}
+
+
+static RTHsmTransition gPostIdleTransitions[] =
+{
+    {
+        STATE_ID_STARTING,              /* toStateId */
+        EV_DATA,                        /* eventId */
+        RTHSM_TRANSITION_FLAG_INTERNAL, /* flags */
+        NULL,                           /* guard */
+        rthsmTestPostAction,            /* action */
+        NULL,                           /* cookie */
+        NULL                            /* private: toState */
+    },
+    {
+        STATE_ID_FINISHED, /* toStateId */
+        EV_NEXT,           /* eventId */
+        0,                 /* flags */
+        NULL,              /* guard */
+        NULL,              /* action */
+        NULL,              /* cookie */
+        NULL               /* private: toState */
+    }
+};
+
+static RTHsmState gPostStates[] =
+{
+    {
+        STATE_ID_GLOBAL,     /* id */
+        0,                   /* flags */
+        RTHSM_NULL_STATE_ID, /* parentId */
+        STATE_ID_STARTING,   /* initialId */
+        NULL,                /* entryAction */
+        NULL,                /* exitAction */
+        NULL,                /* cookie */
+        NULL,                /* transitions */
+        0,                   /* transitionsSize */
+        NULL,                /* private: parent */
+        NULL                 /* private: initial */
+    },
+    {
+        STATE_ID_STARTING,                  /* id */
+        0,                                  /* flags */
+        STATE_ID_GLOBAL,                    /* parentId */
+        RTHSM_NULL_STATE_ID,                /* initialId */
+        NULL,                               /* entryAction */
+        NULL,                               /* exitAction */
+        NULL,                               /* cookie */
+        gPostIdleTransitions,               /* transitions */
+        RTARRAYSIZE(gPostIdleTransitions),  /* transitionsSize */
+        NULL,                               /* private: parent */
+        NULL                                /* private: initial */
+    },
+    {
+        STATE_ID_FINISHED,      /* id */
+        RTHSM_STATE_FLAG_FINAL, /* flags */
+        STATE_ID_GLOBAL,        /* parentId */
+        RTHSM_NULL_STATE_ID,    /* initialId */
+        NULL,                   /* entryAction */
+        NULL,                   /* exitAction */
+        NULL,                   /* cookie */
+        NULL,                   /* transitions */
+        0,                      /* transitionsSize */
+        NULL,                   /* private: parent */
+        NULL                    /* private: initial */
+    }
+};
+
+
+RTT_GROUP_START(HsmMpscConcurrentPost, 0x00030004u, NULL, NULL)
+
+RTT_TEST_START(hsm_mpsc_should_process_events_posted_from_several_threads)
+{
+    pthread_t threads[TEST_HSM_PRODUCERS];
+    RTHsmEvent event;
+    RTHsmResult result;
+    uint32_t total = TEST_HSM_PRODUCERS * TEST_HSM_EVENTS_PER_PRODUCER;
+    long p;
+
+    RTHsmInitMpsc(&gPostHsm, gPostStates, RTARRAYSIZE(gPostStates),
+            &gPostEventQueue);
+    RTT_ASSERT(RTHsmStep(&gPostHsm, NULL) == RTHSM_STEP_RESULT_OK);
+    for (p = 0; p < TEST_HSM_PRODUCERS; p++) {
+        gPostNext[p] = 0;
+        RTT_ASSERT(pthread_create(&threads[p], NULL, rthsmTestPostProducer,
+                    (void*)p) == 0);
+    }
+
+    while (gPostReceived < total) {
+        result = RTHsmStep(&gPostHsm, NULL);
+        if (result == RTHSM_STEP_RESULT_EMPTY) {
+            sched_yield();
+        } else {
+            RTT_ASSERT(result == RTHSM_STEP_RESULT_OK);
+        }
+    }
+    for (p = 0; p < TEST_HSM_PRODUCERS; p++) {
+        pthread_join(threads[p], NULL);
+        RTT_EXPECT(gPostNext[p] == TEST_HSM_EVENTS_PER_PRODUCER);
+    }
+    RTT_EXPECT(gPostErrors == 0);
+
+    event.id = EV_NEXT;
+    RTT_ASSERT(RTHsmPushEvent(&gPostHsm, &event));
+    RTT_ASSERT(RTHsmStep(&gPostHsm, NULL) == RTHSM_STEP_RESULT_OK);
+    RTT_ASSERT(gPostHsm.current->id == STATE_ID_FINISHED);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(HsmMpscConcurrentPost,
+        hsm_mpsc_should_process_events_posted_from_several_threads)
@@ -0,0 +1,171 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/** Effect of huge pages and NUMA placement on random accesses to a big buffer
+ *
+ * A random cycle is laid out over a 256 MiB buffer, one link per cache line,
+ * and followed for a number of steps. Every step is a cache miss and, with
+ * 4 KiB pages, most of them are TLB misses as well. The buffer is allocated:
+ *  - "4k-pages": with `mmap()`, transparent huge pages disabled, and faulted
+ *    in when the cycle is laid out
+ *  - "bigmem-local": with `RTBigMemCreate()` on the node of the calling CPU
+ *  - "bigmem-remote": with `RTBigMemCreate()` on another node (only if the
+ *    system has more than one NUMA node)
+ *
+ * For each case, the time taken to allocate the buffer and lay out the cycle
+ * is printed along with the average time of one step.
+ */
+
+#define _GNU_SOURCE
+#include "rtplf.h"
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+
+#define BENCH_BUFFER_B (256u * 1024u * 1024u)
+#define BENCH_STEPS 10000000u
+#define BENCH_STRIDE (RTCACHELINE_B / sizeof(size_t))
+
+
+static double benchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+
+static void benchPin(long cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((int)cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+
+static uint64_t benchRandom(uint64_t* state)
+{
+    /* xorshift64 */
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+
+/** Lay out a single random cycle through all the cache lines (Sattolo) */
+static void benchLayout(size_t* buffer, size_t lines)
+{
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    size_t i;
+    size_t j;
+    size_t tmp;
+
+    for (i = 0; i < lines; i++) {
+        buffer[i * BENCH_STRIDE] = i;
+    }
+    for (i = lines - 1u; i > 0; i--) {
+        j = (size_t)(benchRandom(&state) % i);
+        tmp = buffer[i * BENCH_STRIDE];
+        buffer[i * BENCH_STRIDE] = buffer[j * BENCH_STRIDE];
+        buffer[j * BENCH_STRIDE] = tmp;
+    }
+}
+
+
+static double benchChase(const size_t* buffer)
+{
+    size_t next = 0;
+    double start;
+    uint32_t i;
+
+    start = benchNow();
+    for (i = 0; i < BENCH_STEPS; i++) {
+        next = buffer[next * BENCH_STRIDE];
+    }
+    /* Make sure the loop is not optimised away */
+    RTASSERT(next < BENCH_BUFFER_B);
+    return ((benchNow() - start) * 1e9) / (double)BENCH_STEPS;
+}
+
+
+static void benchReport(const char* name, RTBool hugePages, int node,
+        double setup_s, double step_ns)
+{
+    printf("%-14s hugepages=%d node=%-2d setup_ms=%.1f ns/step=%.2f\n", name,
+            (int)hugePages, node, setup_s * 1e3, step_ns);
+    fflush(stdout);
+}
+
+
+static void benchSmallPages(void)
+{
+    double start;
+    double setup;
+    size_t* buffer;
+
+    start = benchNow();
+    buffer = mmap(NULL, BENCH_BUFFER_B, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    RTASSERT(buffer != MAP_FAILED);
+    (void)madvise(buffer, BENCH_BUFFER_B, MADV_NOHUGEPAGE);
+    benchLayout(buffer, BENCH_BUFFER_B / RTCACHELINE_B);
+    setup = benchNow() - start;
+    benchReport("4k-pages", RTFalse, -1, setup, benchChase(buffer));
+    munmap(buffer, BENCH_BUFFER_B);
+}
+
+
+static void benchBigMem(const char* name, int node)
+{
+    RTBigMem mem;
+    double start;
+    double setup;
+
+    start = benchNow();
+    RTASSERT(RTBigMemCreate(&mem, BENCH_BUFFER_B, node));
+    benchLayout((size_t*)mem.addr, BENCH_BUFFER_B / RTCACHELINE_B);
+    setup = benchNow() - start;
+    benchReport(name, mem.hugePages, mem.node, setup,
+            benchChase((size_t*)mem.addr));
+    RTBigMemDestroy(&mem);
+}
+
+
+int main(void)
+{
+    unsigned cpu = 0;
+    unsigned node = 0;
+    char path[64];
+
+    /* Stay on the same CPU, so "local" keeps meaning the same node */
+    (void)getcpu(&cpu, &node);
+    benchPin((long)cpu);
+
+    benchSmallPages();
+    benchBigMem("bigmem-local", RTBIGMEM_LOCAL_NODE);
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%u",
+            (node == 0) ? 1u : 0u);
+    if (access(path, F_OK) == 0) {
+        benchBigMem("bigmem-remote", (node == 0) ? 1 : 0);
+    }
+    return 0;
+}
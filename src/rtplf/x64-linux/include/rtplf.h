@@ -69,10 +69,11 @@
  * maybe resetting the board or restarting the software. You should pretty much
  * treat such a situation as if a watchdog timeout occurred.
  *
- * There is only one external dependency: stdint.h, to provide with standard
- * types for fixed-size integers. If you don't want any dependency on the C
- * standard library, you can provide this header file yourself, just make sure
- * all the standard integer types are provided.
+ * There are only two external dependencies: stdint.h, to provide with standard
+ * types for fixed-size integers, and stddef.h, to provide with `size_t`. If you
+ * don't want any dependency on the C standard library, you can provide these
+ * header files yourself, just make sure all the standard integer types are
+ * provided.
  */
 
 
@@ -80,6 +81,7 @@
 #define RTPLF_X64_LINUX_h_
 
 #include <stdint.h>
+#include <stddef.h>
 
 
 /*----------------+
@@ -139,6 +141,123 @@ void RTPanic(void);
 #define RTARRAYSIZE(_array) (sizeof(_array) / sizeof((_array)[0]))
 
 
+/** Evaluate to 0, or fail to compile if the constant `_cond` is false
+ *
+ * This is meant to check the arguments of macro initialisers, by adding it to
+ * one of the initialised fields.
+ */
+#define RTSTATIC_CHECK(_cond) (0 * sizeof(char[(_cond) ? 1 : -1]))
+
+
+/** Test if `_x` is a non-zero power of two <= 2^15 */
+#define RTIS_POW2_15(_x) \
+    (((_x) != 0) && (((_x) & ((_x) - 1)) == 0) && ((_x) <= 0x8000u))
+
+
+/** Qualifiers for small functions defined in header files
+ *
+ * Such functions are `static` (so each translation unit gets its own copy), the
+ * compiler is invited to inline them, and they don't trigger a warning if a
+ * translation unit doesn't use them.
+ */
+#define RTINLINE static __inline__ __attribute__((unused))
+
+
+/** Size of a cache line, in bytes
+ *
+ * Data written by different CPUs should be kept at least that far apart to
+ * avoid false sharing. Set this to 1 on platforms without a data cache.
+ */
+#define RTCACHELINE_B 64u
+
+
+/** Size of a huge page, in bytes */
+#define RTHUGEPAGE_B (2u * 1024u * 1024u)
+
+
+/** Node value for `RTBigMemCreate()` meaning "the node of the calling CPU" */
+#define RTBIGMEM_LOCAL_NODE (-1)
+
+
+/** Timeout value for `RTWait()` meaning "wait forever" */
+#define RTWAIT_FOREVER 0xFFFFFFFFu
+
+
+
+/*-------------------+
+ | Atomic operations |
+ +-------------------*/
+
+
+/** Atomically load `*_ptr` with acquire semantics
+ *
+ * Memory accesses placed after this load can't be moved before it.
+ * `_ptr` must point to a naturally aligned integer of up to 32 bits.
+ */
+#define RTATOMIC_LOAD_ACQUIRE(_ptr) __atomic_load_n((_ptr), __ATOMIC_ACQUIRE)
+
+
+/** Atomically load `*_ptr` without any ordering constraint */
+#define RTATOMIC_LOAD_RELAXED(_ptr) __atomic_load_n((_ptr), __ATOMIC_RELAXED)
+
+
+/** Atomically store `_val` into `*_ptr` with release semantics
+ *
+ * Memory accesses placed before this store can't be moved after it.
+ * `_ptr` must point to a naturally aligned integer of up to 32 bits.
+ */
+#define RTATOMIC_STORE_RELEASE(_ptr, _val) \
+    __atomic_store_n((_ptr), (_val), __ATOMIC_RELEASE)
+
+
+/** Atomically store `_val` into `*_ptr` without any ordering constraint */
+#define RTATOMIC_STORE_RELAXED(_ptr, _val) \
+    __atomic_store_n((_ptr), (_val), __ATOMIC_RELAXED)
+
+
+/** Atomic compare-and-swap with acquire/release semantics
+ *
+ * If `*_ptr` is equal to `*_expectedPtr`, `_desired` is written into `*_ptr`
+ * and the macro evaluates to non-zero. Otherwise, the current value of `*_ptr`
+ * is written into `*_expectedPtr` and the macro evaluates to 0.
+ */
+#define RTATOMIC_CAS(_ptr, _expectedPtr, _desired) \
+    __atomic_compare_exchange_n((_ptr), (_expectedPtr), (_desired), 0, \
+            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+
+/** Atomically add `_val` to `*_ptr` and evaluate to the previous value
+ *
+ * This is a full memory barrier.
+ */
+#define RTATOMIC_FETCH_ADD(_ptr, _val) \
+    __atomic_fetch_add((_ptr), (_val), __ATOMIC_SEQ_CST)
+
+
+/** Atomically subtract `_val` from `*_ptr` and evaluate to the previous value
+ *
+ * This is a full memory barrier.
+ */
+#define RTATOMIC_FETCH_SUB(_ptr, _val) \
+    __atomic_fetch_sub((_ptr), (_val), __ATOMIC_SEQ_CST)
+
+
+/** Full memory barrier
+ *
+ * No memory access can be moved across this barrier, in either direction.
+ */
+#define RTATOMIC_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+
+/** Count the trailing zero bits of a 32-bit unsigned integer
+ *
+ * In other words, evaluate to the index of the least significant bit set in
+ * `_x`. This is a single instruction on most architectures. `_x` must not be 0,
+ * otherwise the result is undefined.
+ */
+#define RTCTZ32(_x) __builtin_ctz((uint32_t)(_x))
+
+
 
 /*-------+
  | Types |
@@ -159,6 +278,71 @@ typedef enum {
 } RTBool;
 
 
+/** Notifier
+ *
+ * A notifier is a flag that can be raised by `RTNotifierSignal()` and that
+ * another thread can wait on. On x64-linux, this is an eventfd, so a notifier
+ * can be watched with poll/epoll like any other file descriptor.
+ */
+typedef struct {
+    int fd; /**< eventfd file descriptor */
+} RTNotifier;
+
+
+/** Memory area that can be shared between processes
+ *
+ * On x64-linux, this is backed by a memfd. Other processes can map the same
+ * memory by getting hold of the file descriptor, eg: by inheriting it across
+ * `fork()` or receiving it over a UNIX socket.
+ */
+typedef struct {
+    int    fd;     /**< memfd file descriptor */
+    void*  addr;   /**< Where the memory is mapped in this process */
+    size_t size_B; /**< Size of the memory area, in bytes */
+} RTSharedMem;
+
+
+/** Mirrored memory area
+ *
+ * A mirrored memory area of `size_B` bytes is mapped twice, back-to-back, so
+ * that `addr[i]` and `addr[i + size_B]` are the same byte. Any span of up to
+ * `size_B` bytes starting in the first half is thus contiguous, even if it
+ * goes past the end of the first half.
+ */
+typedef struct {
+    RTByte* addr;   /**< Start of the first mapping */
+    size_t  size_B; /**< Size of the memory area (ie: of one mapping) */
+} RTMirror;
+
+
+/** Large memory area for big buffers
+ *
+ * This memory is meant to hold the buffer of a large FIFO or ring: it is
+ * backed by huge pages if the system has some available, it is placed on a
+ * given NUMA node, and all its pages are faulted in when it is created.
+ */
+typedef struct {
+    RTByte* addr;      /**< Start of the memory area */
+    size_t  size_B;    /**< Size of the memory area, in bytes */
+    RTBool  hugePages; /**< Whether the area is backed by huge pages */
+    int     node;      /**< NUMA node the area has been placed on, or -1 */
+} RTBigMem;
+
+
+/** File mapped in memory
+ *
+ * Changes made to the memory are written back to the file. They survive the
+ * death of the process as soon as they are made, and a system crash once they
+ * have been synced with `RTMappedFileSync()`.
+ */
+typedef struct {
+    int     fd;      /**< File descriptor of the file */
+    RTByte* addr;    /**< Where the file is mapped in this process */
+    size_t  size_B;  /**< Size of the mapping, in bytes */
+    RTBool  created; /**< Whether the file was empty when it was opened */
+} RTMappedFile;
+
+
 /** Numerical bases */
 typedef enum {
     RTBASE_AUTO,
@@ -202,6 +386,242 @@ uint32_t RTTickFrequency_Hz(void);
 uint32_t RTNow_us(void);
 
 
+/** Get the index of the CPU the calling thread is currently running on
+ *
+ * Unless the calling thread is pinned to a single CPU, the result may already
+ * be out of date when this function returns. It is thus only a hint, e.g. to
+ * pick a per-CPU data structure that is likely to be local.
+ *
+ * @return Index of the current CPU, or 0 if it can't be determined
+ */
+uint32_t RTCurrentCpu(void);
+
+
+/** Block the calling thread while a 32-bit word holds a given value
+ *
+ * This function returns immediately if `*word` is not equal to `value`.
+ * Otherwise, the calling thread is blocked until another thread calls
+ * `RTWake()` on the same word, or the timeout expires. This function may also
+ * return for no reason, so the caller must always re-check its condition.
+ *
+ * Checking `*word` and blocking is atomic with respect to `RTWake()`: if
+ * another thread changes `*word` and then calls `RTWake()`, the wake-up can't
+ * be missed.
+ *
+ * @param word       [in] Word to wait on; must not be NULL and must be
+ *                        naturally aligned
+ * @param value      [in] Value `*word` must have for the thread to block
+ * @param timeout_ms [in] Maximum time to block, in ms, or `RTWAIT_FOREVER`
+ *
+ * @return `RTFalse` if the timeout expired, `RTTrue` otherwise
+ */
+RTBool RTWait(const uint32_t* word, uint32_t value, uint32_t timeout_ms);
+
+
+/** Wake up all the threads blocked in `RTWait()` on a word
+ *
+ * This function always makes a system call, so it should only be called when
+ * there is a thread to wake up.
+ *
+ * @param word [in] Word threads are waiting on; must not be NULL
+ *
+ * @return Nothing
+ */
+void RTWake(uint32_t* word);
+
+
+/** Initialise a notifier
+ *
+ * @param notifier [out] Notifier to initialise; must not be NULL
+ *
+ * @return `RTTrue` if success, `RTFalse` if the system ran out of resources
+ */
+RTBool RTNotifierInit(RTNotifier* notifier);
+
+
+/** Release the resources held by a notifier
+ *
+ * @param notifier [in,out] Notifier to destroy; must not be NULL
+ *
+ * @return Nothing
+ */
+void RTNotifierDestroy(RTNotifier* notifier);
+
+
+/** Raise a notifier
+ *
+ * Raising a notifier which is already raised has no effect.
+ *
+ * @param notifier [in,out] Notifier to raise; must not be NULL
+ *
+ * @return Nothing
+ */
+void RTNotifierSignal(RTNotifier* notifier);
+
+
+/** Lower a notifier
+ *
+ * @param notifier [in,out] Notifier to lower; must not be NULL
+ *
+ * @return `RTTrue` if the notifier was raised, `RTFalse` if not
+ */
+RTBool RTNotifierClear(RTNotifier* notifier);
+
+
+/** Get the file descriptor of a notifier
+ *
+ * The file descriptor is readable while the notifier is raised. Use this to
+ * watch the notifier with poll/epoll; do not read from or write to it.
+ *
+ * @param notifier [in] Notifier to query; must not be NULL
+ *
+ * @return The file descriptor of the notifier
+ */
+int RTNotifierFd(const RTNotifier* notifier);
+
+
+/** Create a shared memory area and map it
+ *
+ * The memory area is zero-filled and page-aligned.
+ *
+ * @param shm    [out] Shared memory descriptor to initialise; must not be NULL
+ * @param name   [in]  Name of the memory area, for debugging purposes only;
+ *                     must not be NULL
+ * @param size_B [in]  Size of the memory area, in bytes; must be > 0
+ *
+ * @return `RTTrue` if success, `RTFalse` if the system ran out of resources
+ */
+RTBool RTSharedMemCreate(RTSharedMem* shm, const char* name, size_t size_B);
+
+
+/** Map an existing shared memory area
+ *
+ * Use this to map a memory area created by `RTSharedMemCreate()`, possibly in
+ * another process. The memory area is likely to be mapped at a different
+ * address than in the process which created it.
+ *
+ * @param shm [out] Shared memory descriptor to initialise; must not be NULL
+ * @param fd  [in]  File descriptor of the memory area; ownership is not
+ *                  transferred, `shm` will use its own copy
+ *
+ * @return `RTTrue` if success, `RTFalse` if `fd` can't be mapped
+ */
+RTBool RTSharedMemMap(RTSharedMem* shm, int fd);
+
+
+/** Unmap a shared memory area and close its file descriptor
+ *
+ * The memory area itself is freed when no process maps it any more.
+ *
+ * @param shm [in,out] Shared memory descriptor; must not be NULL
+ *
+ * @return Nothing
+ */
+void RTSharedMemDestroy(RTSharedMem* shm);
+
+
+/** Create a mirrored memory area
+ *
+ * The size of the memory area is rounded up to a multiple of the page size.
+ *
+ * @param mirror     [out] Mirrored memory area to initialise; must not be NULL
+ * @param minSize_B  [in]  Minimum size of the memory area, in bytes; must be
+ *                         > 0
+ *
+ * @return `RTTrue` if success, `RTFalse` if the system ran out of resources
+ */
+RTBool RTMirrorCreate(RTMirror* mirror, size_t minSize_B);
+
+
+/** Release a mirrored memory area
+ *
+ * @param mirror [in,out] Mirrored memory area to release; must not be NULL
+ *
+ * @return Nothing
+ */
+void RTMirrorDestroy(RTMirror* mirror);
+
+
+/** Create a large memory area for a big buffer
+ *
+ * The memory area is zero-filled, aligned on a huge page boundary, and its size
+ * is rounded up to a multiple of the huge page size (`RTHUGEPAGE_B`).
+ *
+ * The memory area is backed by huge pages if the system has some available
+ * (see `/proc/sys/vm/nr_hugepages`); otherwise it falls back to normal pages,
+ * which the kernel is then advised to merge into transparent huge pages. In
+ * both cases, the memory is preferably placed on `node` and every page is
+ * faulted in before this function returns, so the first accesses to the buffer
+ * do not incur any page fault.
+ *
+ * @param mem       [out] Memory area to initialise; must not be NULL
+ * @param minSize_B [in]  Minimum size of the memory area, in bytes; must be > 0
+ * @param node      [in]  NUMA node where to place the memory area, or
+ *                        `RTBIGMEM_LOCAL_NODE` for the node of the CPU this
+ *                        function is running on
+ *
+ * @return `RTTrue` if success, `RTFalse` if the system ran out of resources
+ */
+RTBool RTBigMemCreate(RTBigMem* mem, size_t minSize_B, int node);
+
+
+/** Release a large memory area
+ *
+ * @param mem [in,out] Memory area to release; must not be NULL
+ *
+ * @return Nothing
+ */
+void RTBigMemDestroy(RTBigMem* mem);
+
+
+/** Open a file and map it in memory
+ *
+ * The file is created if it does not exist. If it is empty, it is extended
+ * with zeros to `newSize_B` bytes and `file->created` is set. Otherwise, its
+ * size and content are left untouched, and it is up to the caller to check
+ * that the file is large enough. The whole file is mapped, at a page-aligned
+ * address.
+ *
+ * @param file      [out] Mapped file descriptor to initialise; must not be NULL
+ * @param path      [in]  Path to the file; must not be NULL
+ * @param newSize_B [in]  Size to give to the file if it is empty, in bytes;
+ *                        must be > 0
+ *
+ * @return `RTTrue` if success, `RTFalse` if the file can't be opened, extended
+ *         or mapped
+ */
+RTBool RTMappedFileOpen(RTMappedFile* file, const char* path, size_t newSize_B);
+
+
+/** Write part of a mapped file to its storage device
+ *
+ * This function blocks until the data is on the storage device, so it is
+ * slow; it should be called once for a batch of changes rather than for every
+ * change. The range is extended to whole pages.
+ *
+ * @param file     [in] Mapped file; must not be NULL
+ * @param offset_B [in] Start of the range to sync, in bytes
+ * @param size_B   [in] Size of the range to sync, in bytes; `offset_B` +
+ *                      `size_B` must be <= the size of the mapping
+ *
+ * @return `RTTrue` if success, `RTFalse` if the data could not be written
+ */
+RTBool RTMappedFileSync(const RTMappedFile* file, size_t offset_B,
+        size_t size_B);
+
+
+/** Unmap and close a mapped file
+ *
+ * Changes that have not been synced are still written back to the file
+ * eventually, unless the system crashes.
+ *
+ * @param file [in,out] Mapped file; must not be NULL
+ *
+ * @return Nothing
+ */
+void RTMappedFileClose(RTMappedFile* file);
+
+
 /** Converts a 32-bit signed integer into a string
  *
  * If the provided buffer is too small, the string is truncated. In any case,
@@ -313,6 +733,34 @@ void RTMemcpy(RTByte* dst, uint16_t dstSize_B,
 		const RTByte* src, uint16_t srcSize_B);
 
 
+/** Fast memory copy of a large memory area
+ *
+ * Copy `size_B` bytes from `src` to `dst`. The memory areas must not overlap
+ * (if they do, the behaviour of this function is undefined).
+ *
+ * @param dst    [out] Where to copy the data; must not be NULL unless `size_B`
+ *                     is 0.
+ * @param src    [in]  Data source; must not be NULL unless `size_B` is 0.
+ * @param size_B [in]  Number of bytes to copy. This argument is allowed to be
+ *                     0, in which case no action is taken.
+ */
+void RTMemcpy32(RTByte* dst, const RTByte* src, uint32_t size_B);
+
+
+/** Fast memory copy of a memory area of any size
+ *
+ * Same as `RTMemcpy32()`, but `size_B` can be as large as the address space
+ * allows.
+ *
+ * @param dst    [out] Where to copy the data; must not be NULL unless `size_B`
+ *                     is 0.
+ * @param src    [in]  Data source; must not be NULL unless `size_B` is 0.
+ * @param size_B [in]  Number of bytes to copy. This argument is allowed to be
+ *                     0, in which case no action is taken.
+ */
+void RTMemcpyLarge(RTByte* dst, const RTByte* src, size_t size_B);
+
+
 /** Compute the length of a string
  *
  * The length of a string is the number of characters until the null character.
@@ -20,11 +20,37 @@
  * using Linux is such a case anyway.
  */
 
+#define _GNU_SOURCE
 #include "rtplf.h"
 #include <stdlib.h>
 #include <sys/time.h>
 #include <string.h>
 #include <stdio.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <linux/mempolicy.h>
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Highest number of NUMA nodes `RTBigMemCreate()` can place memory on
+ *
+ * This is the number of bits of an `unsigned long` nodemask, minus the one the
+ * kernel ignores.
+ */
+#define RTPLF_MAX_NODES 63
 
 
 
@@ -94,6 +120,376 @@ uint32_t RTNow_us(void)
 }
 
 
+uint32_t RTCurrentCpu(void)
+{
+    uint32_t cpu = 0;
+    int ret = sched_getcpu();
+    if (ret > 0) {
+        cpu = (uint32_t)ret;
+    }
+    return cpu;
+}
+
+
+RTBool RTWait(const uint32_t* word, uint32_t value, uint32_t timeout_ms)
+{
+    RTBool woken = RTTrue;
+    struct timespec timeout;
+    struct timespec* ptimeout = NULL;
+    long ret;
+
+    RTASSERT(word != NULL);
+
+    if (timeout_ms != RTWAIT_FOREVER) {
+        timeout.tv_sec = (time_t)(timeout_ms / 1000u);
+        timeout.tv_nsec = (long)(timeout_ms % 1000u) * 1000000L;
+        ptimeout = &timeout;
+    }
+    ret = syscall(SYS_futex, word, FUTEX_WAIT, value, ptimeout, NULL, 0);
+    if (ret != 0) {
+        RTASSERT((errno == EAGAIN) || (errno == EINTR)
+                || (errno == ETIMEDOUT));
+        if (errno == ETIMEDOUT) {
+            woken = RTFalse;
+        }
+    }
+    return woken;
+}
+
+
+void RTWake(uint32_t* word)
+{
+    long ret;
+
+    RTASSERT(word != NULL);
+
+    ret = syscall(SYS_futex, word, FUTEX_WAKE, 0x7FFFFFFF, NULL, NULL, 0);
+    RTASSERT(ret >= 0);
+}
+
+
+RTBool RTNotifierInit(RTNotifier* notifier)
+{
+    RTASSERT(notifier != NULL);
+    notifier->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    return notifier->fd >= 0;
+}
+
+
+void RTNotifierDestroy(RTNotifier* notifier)
+{
+    RTASSERT(notifier != NULL);
+    RTASSERT(notifier->fd >= 0);
+    close(notifier->fd);
+    notifier->fd = -1;
+}
+
+
+void RTNotifierSignal(RTNotifier* notifier)
+{
+    eventfd_t one = 1;
+    ssize_t ret;
+
+    RTASSERT(notifier != NULL);
+    RTASSERT(notifier->fd >= 0);
+
+    /* NB: EAGAIN means the counter is saturated, which can only happen after
+     * billions of signals without a clear; the notifier is raised anyway */
+    ret = write(notifier->fd, &one, sizeof(one));
+    RTASSERT((ret == (ssize_t)sizeof(one)) || (errno == EAGAIN));
+}
+
+
+RTBool RTNotifierClear(RTNotifier* notifier)
+{
+    eventfd_t value;
+    ssize_t ret;
+
+    RTASSERT(notifier != NULL);
+    RTASSERT(notifier->fd >= 0);
+
+    ret = read(notifier->fd, &value, sizeof(value));
+    RTASSERT((ret == (ssize_t)sizeof(value)) || (errno == EAGAIN));
+    return ret == (ssize_t)sizeof(value);
+}
+
+
+int RTNotifierFd(const RTNotifier* notifier)
+{
+    RTASSERT(notifier != NULL);
+    return notifier->fd;
+}
+
+
+RTBool RTSharedMemCreate(RTSharedMem* shm, const char* name, size_t size_B)
+{
+    RTBool ok = RTFalse;
+    int fd;
+
+    RTASSERT(shm != NULL);
+    RTASSERT(name != NULL);
+    RTASSERT(size_B > 0);
+
+    fd = memfd_create(name, MFD_CLOEXEC);
+    if (fd >= 0) {
+        if (ftruncate(fd, (off_t)size_B) == 0) {
+            ok = RTSharedMemMap(shm, fd);
+        }
+        close(fd);
+    }
+    return ok;
+}
+
+
+RTBool RTSharedMemMap(RTSharedMem* shm, int fd)
+{
+    RTBool ok = RTFalse;
+    struct stat st;
+
+    RTASSERT(shm != NULL);
+
+    shm->fd = -1;
+    shm->addr = NULL;
+    shm->size_B = 0;
+    if ((fstat(fd, &st) == 0) && (st.st_size > 0)) {
+        void* addr = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED, fd, 0);
+        if (addr != MAP_FAILED) {
+            shm->fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+            if (shm->fd >= 0) {
+                shm->addr = addr;
+                shm->size_B = (size_t)st.st_size;
+                ok = RTTrue;
+            } else {
+                munmap(addr, (size_t)st.st_size);
+            }
+        }
+    }
+    return ok;
+}
+
+
+void RTSharedMemDestroy(RTSharedMem* shm)
+{
+    RTASSERT(shm != NULL);
+    RTASSERT(shm->addr != NULL);
+
+    munmap(shm->addr, shm->size_B);
+    close(shm->fd);
+    shm->fd = -1;
+    shm->addr = NULL;
+    shm->size_B = 0;
+}
+
+
+RTBool RTMirrorCreate(RTMirror* mirror, size_t minSize_B)
+{
+    RTBool ok = RTFalse;
+    size_t page_B = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size_B;
+    int fd;
+
+    RTASSERT(mirror != NULL);
+    RTASSERT(minSize_B > 0);
+
+    mirror->addr = NULL;
+    mirror->size_B = 0;
+    size_B = ((minSize_B + page_B - 1u) / page_B) * page_B;
+
+    fd = memfd_create("rtmirror", MFD_CLOEXEC);
+    if (fd >= 0) {
+        if (ftruncate(fd, (off_t)size_B) == 0) {
+            /* Reserve the address range for both mappings, then map the same
+             * pages over each half */
+            RTByte* base = mmap(NULL, 2u * size_B, PROT_NONE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (base != MAP_FAILED) {
+                void* first = mmap(base, size_B, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_FIXED, fd, 0);
+                void* second = mmap(base + size_B, size_B,
+                        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+                if ((first == base) && (second == (base + size_B))) {
+                    mirror->addr = base;
+                    mirror->size_B = size_B;
+                    ok = RTTrue;
+                } else {
+                    munmap(base, 2u * size_B);
+                }
+            }
+        }
+        close(fd);
+    }
+    return ok;
+}
+
+
+void RTMirrorDestroy(RTMirror* mirror)
+{
+    RTASSERT(mirror != NULL);
+    RTASSERT(mirror->addr != NULL);
+
+    munmap(mirror->addr, 2u * mirror->size_B);
+    mirror->addr = NULL;
+    mirror->size_B = 0;
+}
+
+
+RTBool RTBigMemCreate(RTBigMem* mem, size_t minSize_B, int node)
+{
+    RTBool ok = RTFalse;
+    size_t size_B;
+    size_t step_B;
+    size_t offset;
+    size_t head_B;
+    RTByte* addr;
+    unsigned cpu;
+    unsigned cpuNode;
+
+    RTASSERT(mem != NULL);
+    RTASSERT(minSize_B > 0);
+    RTASSERT(node >= RTBIGMEM_LOCAL_NODE);
+
+    mem->addr = NULL;
+    mem->size_B = 0;
+    mem->hugePages = RTFalse;
+    mem->node = -1;
+    size_B = ((minSize_B + RTHUGEPAGE_B - 1u) / RTHUGEPAGE_B) * RTHUGEPAGE_B;
+
+    /* Try huge pages first, then fall back to normal pages */
+    step_B = RTHUGEPAGE_B;
+    addr = mmap(NULL, size_B, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (addr != MAP_FAILED) {
+        mem->hugePages = RTTrue;
+    } else {
+        /* Map one extra huge page and trim the mapping so it starts on a huge
+         * page boundary; otherwise the first and last partial huge pages could
+         * never become transparent huge pages */
+        step_B = (size_t)sysconf(_SC_PAGESIZE);
+        addr = mmap(NULL, size_B + RTHUGEPAGE_B, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr != MAP_FAILED) {
+            head_B = (RTHUGEPAGE_B - ((size_t)addr % RTHUGEPAGE_B))
+                % RTHUGEPAGE_B;
+            if (head_B > 0) {
+                munmap(addr, head_B);
+            }
+            munmap(addr + head_B + size_B, RTHUGEPAGE_B - head_B);
+            addr += head_B;
+            (void)madvise(addr, size_B, MADV_HUGEPAGE);
+        }
+    }
+
+    if (addr != MAP_FAILED) {
+        if (node == RTBIGMEM_LOCAL_NODE) {
+            if (syscall(SYS_getcpu, &cpu, &cpuNode, NULL) == 0) {
+                node = (int)cpuNode;
+            }
+        }
+        if ((node >= 0) && (node < RTPLF_MAX_NODES)) {
+            /* The memory policy must be set before the pages are faulted in */
+            unsigned long nodemask = 1ul << node;
+            if (syscall(SYS_mbind, addr, size_B, MPOL_PREFERRED, &nodemask,
+                        (unsigned long)RTPLF_MAX_NODES + 1u, 0) == 0) {
+                mem->node = node;
+            }
+        }
+
+        /* Pre-fault every page */
+        for (offset = 0; offset < size_B; offset += step_B) {
+            ((volatile RTByte*)addr)[offset] = 0;
+        }
+
+        mem->addr = addr;
+        mem->size_B = size_B;
+        ok = RTTrue;
+    }
+    return ok;
+}
+
+
+void RTBigMemDestroy(RTBigMem* mem)
+{
+    RTASSERT(mem != NULL);
+    RTASSERT(mem->addr != NULL);
+
+    munmap(mem->addr, mem->size_B);
+    mem->addr = NULL;
+    mem->size_B = 0;
+}
+
+
+RTBool RTMappedFileOpen(RTMappedFile* file, const char* path, size_t newSize_B)
+{
+    RTBool ok = RTFalse;
+    struct stat st;
+    int fd;
+
+    RTASSERT(file != NULL);
+    RTASSERT(path != NULL);
+    RTASSERT(newSize_B > 0);
+
+    file->fd = -1;
+    file->addr = NULL;
+    file->size_B = 0;
+    file->created = RTFalse;
+    fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd >= 0) {
+        if ((fstat(fd, &st) == 0)
+                && ((st.st_size > 0)
+                    || (ftruncate(fd, (off_t)newSize_B) == 0))) {
+            size_t size_B = (size_t)st.st_size;
+            void* addr;
+            if (size_B == 0) {
+                size_B = newSize_B;
+                file->created = RTTrue;
+            }
+            addr = mmap(NULL, size_B, PROT_READ | PROT_WRITE, MAP_SHARED,
+                    fd, 0);
+            if (addr != MAP_FAILED) {
+                file->fd = fd;
+                file->addr = (RTByte*)addr;
+                file->size_B = size_B;
+                ok = RTTrue;
+            }
+        }
+        if (!ok) {
+            close(fd);
+        }
+    }
+    return ok;
+}
+
+
+RTBool RTMappedFileSync(const RTMappedFile* file, size_t offset_B,
+        size_t size_B)
+{
+    size_t page_B = (size_t)sysconf(_SC_PAGESIZE);
+    size_t start_B;
+
+    RTASSERT(file != NULL);
+    RTASSERT(file->addr != NULL);
+    RTASSERT(offset_B + size_B <= file->size_B);
+
+    start_B = (offset_B / page_B) * page_B;
+    return msync(file->addr + start_B, (offset_B - start_B) + size_B,
+            MS_SYNC) == 0;
+}
+
+
+void RTMappedFileClose(RTMappedFile* file)
+{
+    RTASSERT(file != NULL);
+    RTASSERT(file->addr != NULL);
+
+    munmap(file->addr, file->size_B);
+    close(file->fd);
+    file->fd = -1;
+    file->addr = NULL;
+    file->size_B = 0;
+}
+
+
 uint16_t RT32ToString(int32_t x, char* buffer, uint16_t size)
 {
     uint16_t nchars = 0;
@@ -242,6 +638,22 @@ void RTMemcpy(RTByte* dst, uint16_t dstSize_B,
 }
 
 
+void RTMemcpy32(RTByte* dst, const RTByte* src, uint32_t size_B)
+{
+    RTMemcpyLarge(dst, src, size_B);
+}
+
+
+void RTMemcpyLarge(RTByte* dst, const RTByte* src, size_t size_B)
+{
+    if (size_B > 0) {
+        RTASSERT(dst != NULL);
+        RTASSERT(src != NULL);
+        memcpy(dst, src, size_B);
+    }
+}
+
+
 uint16_t RTStrlen(const char* str)
 {
     uint16_t len = 0;
@@ -16,6 +16,7 @@
 
 #include "rtplf.h"
 #include "rttest.h"
+#include <unistd.h>
 
 
 static uint16_t mystrlen(const char* str)
@@ -450,3 +451,137 @@ RTT_GROUP_END(TestStringToU32,
         strtou32_should_not_parse_empty_string,
         strtou32_should_not_parse_null_string,
         strtou32_should_take_null_arg)
+
+
+RTT_GROUP_START(TestWait, 0x00010005u, NULL, NULL)
+
+RTT_TEST_START(wait_should_return_immediately_if_value_differs)
+{
+    uint32_t word = 1u;
+    RTT_ASSERT(RTWait(&word, 0, RTWAIT_FOREVER));
+}
+RTT_TEST_END
+
+RTT_TEST_START(wait_should_time_out)
+{
+    uint32_t word = 0;
+    uint32_t start_us = RTNow_us();
+    RTT_ASSERT(!RTWait(&word, 0, 10));
+    RTT_EXPECT((RTNow_us() - start_us) >= 9000u);
+}
+RTT_TEST_END
+
+RTT_TEST_START(wake_should_not_fail_without_waiters)
+{
+    uint32_t word = 0;
+    RTWake(&word);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestWait,
+        wait_should_return_immediately_if_value_differs,
+        wait_should_time_out,
+        wake_should_not_fail_without_waiters)
+
+
+RTT_GROUP_START(TestMirror, 0x00010006u, NULL, NULL)
+
+RTT_TEST_START(mirror_should_round_size_up_and_alias_both_halves)
+{
+    RTMirror mirror;
+
+    RTT_ASSERT(RTMirrorCreate(&mirror, 100));
+    RTT_ASSERT(mirror.size_B >= 100u);
+    mirror.addr[0] = 0x5A;
+    mirror.addr[mirror.size_B - 1u] = 0xA5;
+    RTT_EXPECT(mirror.addr[mirror.size_B] == 0x5A);
+    mirror.addr[(2u * mirror.size_B) - 1u] = 0x3C;
+    RTT_EXPECT(mirror.addr[mirror.size_B - 1u] == 0x3C);
+    RTMirrorDestroy(&mirror);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestMirror,
+        mirror_should_round_size_up_and_alias_both_halves)
+
+
+RTT_GROUP_START(TestBigMem, 0x00010007u, NULL, NULL)
+
+RTT_TEST_START(bigmem_should_round_size_up_to_huge_pages)
+{
+    RTBigMem mem;
+    size_t i;
+    RTBool zero = RTTrue;
+
+    RTT_ASSERT(RTBigMemCreate(&mem, RTHUGEPAGE_B + 1u, RTBIGMEM_LOCAL_NODE));
+    RTT_ASSERT(mem.addr != NULL);
+    RTT_EXPECT(mem.size_B == (2u * RTHUGEPAGE_B));
+    RTT_EXPECT(((size_t)mem.addr % RTHUGEPAGE_B) == 0);
+    RTT_EXPECT(mem.node >= -1);
+    for (i = 0; i < mem.size_B; i += 4096u) {
+        if (mem.addr[i] != 0) {
+            zero = RTFalse;
+        }
+    }
+    RTT_EXPECT(zero);
+    mem.addr[mem.size_B - 1u] = 0xA5;
+    RTT_EXPECT(mem.addr[mem.size_B - 1u] == 0xA5);
+    RTBigMemDestroy(&mem);
+    RTT_EXPECT(mem.addr == NULL);
+}
+RTT_TEST_END
+
+RTT_TEST_START(bigmem_should_place_memory_on_node_0)
+{
+    RTBigMem mem;
+
+    RTT_ASSERT(RTBigMemCreate(&mem, 100u, 0));
+    RTT_EXPECT(mem.size_B == RTHUGEPAGE_B);
+    RTT_EXPECT(((size_t)mem.addr % RTHUGEPAGE_B) == 0);
+    /* -1 if the kernel has no NUMA support, in which case mbind() fails */
+    RTT_EXPECT((mem.node == 0) || (mem.node == -1));
+    RTBigMemDestroy(&mem);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestBigMem,
+        bigmem_should_round_size_up_to_huge_pages,
+        bigmem_should_place_memory_on_node_0)
+
+
+RTT_GROUP_START(TestMappedFile, 0x00010008u, NULL, NULL)
+
+RTT_TEST_START(mapped_file_should_keep_its_size_and_content_across_opens)
+{
+    const char* path = "test-rtplf-mappedfile.bin";
+    RTMappedFile file;
+
+    (void)unlink(path);
+    RTT_ASSERT(RTMappedFileOpen(&file, path, 100));
+    RTT_EXPECT(file.created);
+    RTT_EXPECT(file.size_B == 100u);
+    RTT_EXPECT(file.addr[99] == 0);
+    file.addr[0] = 0x5A;
+    file.addr[99] = 0xA5;
+    RTT_EXPECT(RTMappedFileSync(&file, 50, 50));
+    RTMappedFileClose(&file);
+    RTT_EXPECT(file.addr == NULL);
+
+    RTT_ASSERT(RTMappedFileOpen(&file, path, 10));
+    RTT_EXPECT(!file.created);
+    RTT_EXPECT(file.size_B == 100u);
+    RTT_EXPECT(file.addr[0] == 0x5A);
+    RTT_EXPECT(file.addr[99] == 0xA5);
+    RTMappedFileClose(&file);
+
+    RTT_ASSERT(RTMappedFileOpen(&file, path, 8192));
+    RTT_EXPECT(!file.created);
+    RTT_EXPECT(file.size_B == 100u);
+    RTT_EXPECT(file.addr[99] == 0xA5);
+    RTMappedFileClose(&file);
+    RTT_EXPECT(unlink(path) == 0);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestMappedFile,
+        mapped_file_should_keep_its_size_and_content_across_opens)
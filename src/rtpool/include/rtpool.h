@@ -0,0 +1,267 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Fixed-block memory pools
+ *
+ * @defgroup rtpool Memory pools
+ * @addtogroup rtpool
+ * @{
+ *
+ * A memory pool hands out fixed-size blocks from a buffer provided by the
+ * user, in O(1) time and without calling `malloc()`. Freed blocks are kept in
+ * a free list which is stored inside the free blocks themselves, so the pool
+ * needs no memory besides its buffer and its own structure. Blocks that have
+ * never been handed out are not in the free list, so a pool can be initialised
+ * statically, without touching its buffer.
+ *
+ * Blocks can be handed out either as pointers or as indices. An index is
+ * smaller than a pointer, so it can be pushed into a FIFO instead of the
+ * block itself, for example to pass an event payload to another module. The
+ * size of indices is set by `RTPOOL_INDEX_BITS`, which can be 16 or 32 (the
+ * default). With 16-bit indices, a pool can have up to 65,535 blocks.
+ *
+ * When `RTPOOL_STATS` is set to 1, every pool maintains a set of counters
+ * that can be read and reset in one go with `RTPoolReadStats()`. When it is
+ * set to 0 (the default), the pool structures and functions are exactly the
+ * same as if this feature did not exist.
+ *
+ * `RTPOOL_INDEX_BITS` and `RTPOOL_STATS` must have the same values when
+ * compiling the library and when compiling the code that uses it. They are
+ * set by the `POOL_INDEX_BITS` and `POOL_STATS` parameters of the top-level
+ * Makefile.
+ *
+ * Like regular FIFOs, memory pools are not thread-safe.
+ */
+
+#ifndef RTPOOL_h_
+#define RTPOOL_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Size of block indices, in bits; must be 16 or 32 */
+#ifndef RTPOOL_INDEX_BITS
+#define RTPOOL_INDEX_BITS 32
+#endif
+
+
+/** Set to 1 to instrument memory pools */
+#ifndef RTPOOL_STATS
+#define RTPOOL_STATS 0
+#endif
+
+
+#if RTPOOL_INDEX_BITS == 16
+/** Index of a block in a memory pool */
+typedef uint16_t RTPoolIndex;
+
+/** Invalid block index */
+#define RTPOOL_NO_INDEX 0xFFFFu
+#elif RTPOOL_INDEX_BITS == 32
+/** Index of a block in a memory pool */
+typedef uint32_t RTPoolIndex;
+
+/** Invalid block index */
+#define RTPOOL_NO_INDEX 0xFFFFFFFFu
+#else
+#error "RTPOOL_INDEX_BITS must be 16 or 32"
+#endif
+
+
+/** Memory pool counters
+ *
+ * All the counters wrap around when they overflow, except `highWatermark`
+ * which can not exceed the capacity of the pool.
+ */
+typedef struct {
+    uint32_t allocs;        /**< Number of blocks allocated */
+    uint32_t frees;         /**< Number of blocks freed */
+    uint32_t allocFailures; /**< Number of allocations that failed */
+    uint32_t highWatermark; /**< Highest number of blocks in use at once */
+} RTPoolStats;
+
+
+#include "rtpool_priv.h"
+
+
+/** "Opaque" type that represents a memory pool
+ *
+ * Blocks can be up to 65,535 bytes, and must be at least as big as a block
+ * index.
+ *
+ * *Important note*: Never access the structure directly! Always use the
+ * memory pool functions.
+ */
+typedef struct RTPool RTPool;
+
+
+/** Macro initialiser for a statically-allocated memory pool
+ *
+ * This macro can be used to initialise a memory pool when the underlying
+ * buffer has been previously *statically* declared as an array; each element
+ * of the array is a block. Compilation will fail if the elements are smaller
+ * than a block index, or if there are too many of them for the block indices.
+ *
+ * The pool will then take ownership of the `_buffer`, which should then not be
+ * accessed by anything else than the users of the blocks.
+ *
+ * For example:
+ *   typedef struct { ... } MyStruct;
+ *   static MyStruct gMyBuffer[32];
+ *   static RTPool gMyPool = RT_POOL_INIT(gMyBuffer);
+ */
+#define RT_POOL_INIT(_buffer) RTPRIV_POOL_INIT(_buffer)
+
+
+
+/*------------------------------+
+ | Public function declarations |
+ +------------------------------*/
+
+
+/** Dynamically initialise a memory pool
+ *
+ * **DO NOT** call this function on a pool that has been already initialised
+ * with `RT_POOL_INIT()`, nor while any block is in use.
+ *
+ * @param pool        [in,out] Pool to initialise; must not be NULL.
+ * @param capacity    [in]     Number of blocks; must be > 0 and <
+ *                             `RTPOOL_NO_INDEX`.
+ * @param blockSize_B [in]     Size of a block, in bytes; must be >=
+ *                             `sizeof(RTPoolIndex)`. It should be a multiple
+ *                             of the alignment the blocks need.
+ * @param buffer      [in]     Where the blocks are; must not be NULL and must
+ *                             point to a memory area at least `capacity` *
+ *                             `blockSize_B` in size (in bytes).
+ *
+ * @return Nothing
+ */
+void RTPoolInit(RTPool* pool, uint32_t capacity, uint16_t blockSize_B,
+        RTByte* buffer);
+
+
+/** Get the capacity of a memory pool
+ *
+ * @param pool [in] Pool to query; must not be NULL.
+ *
+ * @return The number of blocks in the pool
+ */
+uint32_t RTPoolCapacity(const RTPool* pool);
+
+
+/** Get the number of blocks in use in a memory pool
+ *
+ * @param pool [in] Pool to query; must not be NULL.
+ *
+ * @return The number of blocks allocated and not freed yet
+ */
+uint32_t RTPoolInUse(const RTPool* pool);
+
+
+/** Allocate a block from a memory pool
+ *
+ * The content of the block is undefined.
+ *
+ * @param pool [in,out] Pool to allocate from; must not be NULL.
+ *
+ * @return The block, or NULL if all the blocks are in use
+ */
+void* RTPoolAlloc(RTPool* pool);
+
+
+/** Give a block back to its memory pool
+ *
+ * @param pool  [in,out] Pool the block belongs to; must not be NULL.
+ * @param block [in]     Block to free; must have been returned by
+ *                       `RTPoolAlloc()` or `RTPoolBlock()` for this pool, and
+ *                       must not have been freed already.
+ *
+ * @return Nothing
+ */
+void RTPoolFree(RTPool* pool, void* block);
+
+
+/** Allocate a block from a memory pool and get its index
+ *
+ * The content of the block is undefined; use `RTPoolBlock()` to access it.
+ *
+ * @param pool [in,out] Pool to allocate from; must not be NULL.
+ *
+ * @return The index of the block, or `RTPOOL_NO_INDEX` if all the blocks are
+ *         in use
+ */
+RTPoolIndex RTPoolAllocIndex(RTPool* pool);
+
+
+/** Give a block back to its memory pool, by index
+ *
+ * @param pool  [in,out] Pool the block belongs to; must not be NULL.
+ * @param index [in]     Index of the block to free; must have been returned
+ *                       by `RTPoolAllocIndex()` or `RTPoolIndexOf()` for this
+ *                       pool, and must not have been freed already.
+ *
+ * @return Nothing
+ */
+void RTPoolFreeIndex(RTPool* pool, RTPoolIndex index);
+
+
+/** Get a block from its index
+ *
+ * @param pool  [in] Pool the block belongs to; must not be NULL.
+ * @param index [in] Index of the block; must be < the capacity of the pool.
+ *
+ * @return A pointer to the block
+ */
+void* RTPoolBlock(const RTPool* pool, RTPoolIndex index);
+
+
+/** Get the index of a block
+ *
+ * @param pool  [in] Pool the block belongs to; must not be NULL.
+ * @param block [in] The block; must be a block of `pool`.
+ *
+ * @return The index of the block
+ */
+RTPoolIndex RTPoolIndexOf(const RTPool* pool, const void* block);
+
+
+#if RTPOOL_STATS
+/** Read the counters of a memory pool, and optionally reset them
+ *
+ * This function is only available if `RTPOOL_STATS` is set to 1. Reading and
+ * resetting is done in one call, so no event can be missed in between. After a
+ * reset, the high watermark is set to the number of blocks in use and all the
+ * other counters are set to 0.
+ *
+ * @param pool  [in,out] Pool to query; must not be NULL.
+ * @param stats [out]    Where to write the counters; must not be NULL.
+ * @param reset [in]     Whether to reset the counters after reading them
+ *
+ * @return Nothing
+ */
+void RTPoolReadStats(RTPool* pool, RTPoolStats* stats, RTBool reset);
+#endif
+
+
+
+#endif /* RTPOOL_h_ */
+/* @} */
@@ -0,0 +1,75 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* You should not include this file directly; include "rtpool.h" instead. */
+
+#ifndef RTPOOL_PRIV_h_
+#define RTPOOL_PRIV_h_
+
+#include "rtplf.h"
+
+
+
+/*----------------+
+ | Types & Macros |
+ +----------------*/
+
+
+/** Initialiser for the `stats` field, including the leading comma, if any */
+#if RTPOOL_STATS
+#define RTPRIV_POOL_STATS_INIT , { 0, 0, 0, 0 }
+#else
+#define RTPRIV_POOL_STATS_INIT
+#endif
+
+
+/** Memory pool structure
+ *
+ * Blocks `fresh` to `capacity - 1` have never been handed out. The other free
+ * blocks are in the free list: the first bytes of each of them hold the index
+ * of the next one, the last one holding `RTPOOL_NO_INDEX`.
+ */
+struct RTPool {
+    uint32_t    capacity;    /**< Number of blocks */
+    uint16_t    blockSize_B; /**< Size of one block, in bytes */
+    uint32_t    inUse;       /**< Number of blocks in use */
+    uint32_t    fresh;       /**< Number of blocks ever handed out */
+    RTPoolIndex freeHead;    /**< First block of the free list */
+    RTByte*     buffer;      /**< Where the blocks are */
+#if RTPOOL_STATS
+    RTPoolStats stats;       /**< Usage counters */
+#endif
+};
+
+
+/** Macro initialiser for a statically-allocated memory pool */
+#define RTPRIV_POOL_INIT(_buffer)                                           \
+    {                                                                       \
+        RTARRAYSIZE(_buffer)                                                \
+            + RTSTATIC_CHECK(RTARRAYSIZE(_buffer) < RTPOOL_NO_INDEX),       \
+        sizeof((_buffer)[0])                                                \
+            + RTSTATIC_CHECK(                                               \
+                    sizeof((_buffer)[0]) >= sizeof(RTPoolIndex)),           \
+        0,                                                                  \
+        0,                                                                  \
+        RTPOOL_NO_INDEX,                                                    \
+        (RTByte*)(_buffer)                                                  \
+        RTPRIV_POOL_STATS_INIT                                              \
+    }
+
+
+
+#endif /* RTPOOL_PRIV_h_ */
@@ -0,0 +1,214 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtplf.h"
+#include "rtpool.h"
+
+
+
+/*-------------------------------+
+ | Private function declarations |
+ +-------------------------------*/
+
+
+/** Get a pointer to a block of a memory pool
+ *
+ * @param pool  [in] The pool the block belongs to
+ * @param index [in] Index of the block
+ *
+ * @return A pointer to the block
+ */
+static RTByte* rtpoolBlock(const RTPool* pool, RTPoolIndex index);
+
+
+#if RTPOOL_STATS
+/** Update the counters of a memory pool after an allocation
+ *
+ * @param pool [in,out] The pool
+ * @param ok   [in]     Whether the allocation succeeded
+ */
+static void rtpoolStatsAlloc(RTPool* pool, RTBool ok);
+#endif
+
+
+
+/*---------------------------------+
+ | Public function implementations |
+ +---------------------------------*/
+
+
+void RTPoolInit(RTPool* pool, uint32_t capacity, uint16_t blockSize_B,
+        RTByte* buffer)
+{
+    RTASSERT(pool != NULL);
+    RTASSERT(capacity > 0);
+    RTASSERT(capacity < RTPOOL_NO_INDEX);
+    RTASSERT(blockSize_B >= sizeof(RTPoolIndex));
+    RTASSERT(buffer != NULL);
+
+    pool->capacity = capacity;
+    pool->blockSize_B = blockSize_B;
+    pool->inUse = 0;
+    pool->fresh = 0;
+    pool->freeHead = RTPOOL_NO_INDEX;
+    pool->buffer = buffer;
+#if RTPOOL_STATS
+    pool->stats.allocs = 0;
+    pool->stats.frees = 0;
+    pool->stats.allocFailures = 0;
+    pool->stats.highWatermark = 0;
+#endif
+}
+
+
+uint32_t RTPoolCapacity(const RTPool* pool)
+{
+    RTASSERT(pool != NULL);
+    return pool->capacity;
+}
+
+
+uint32_t RTPoolInUse(const RTPool* pool)
+{
+    RTASSERT(pool != NULL);
+    return pool->inUse;
+}
+
+
+void* RTPoolAlloc(RTPool* pool)
+{
+    void* block = NULL;
+    RTPoolIndex index = RTPoolAllocIndex(pool);
+
+    if (index != RTPOOL_NO_INDEX) {
+        block = rtpoolBlock(pool, index);
+    }
+    return block;
+}
+
+
+void RTPoolFree(RTPool* pool, void* block)
+{
+    RTPoolFreeIndex(pool, RTPoolIndexOf(pool, block));
+}
+
+
+RTPoolIndex RTPoolAllocIndex(RTPool* pool)
+{
+    RTPoolIndex index = RTPOOL_NO_INDEX;
+
+    RTASSERT(pool != NULL);
+    RTASSERT(pool->buffer != NULL);
+
+    if (pool->freeHead != RTPOOL_NO_INDEX) {
+        index = pool->freeHead;
+        RTMemcpy((RTByte*)&(pool->freeHead), sizeof(pool->freeHead),
+                rtpoolBlock(pool, index), sizeof(pool->freeHead));
+    } else if (pool->fresh < pool->capacity) {
+        index = (RTPoolIndex)pool->fresh;
+        pool->fresh++;
+    }
+    if (index != RTPOOL_NO_INDEX) {
+        pool->inUse++;
+    }
+#if RTPOOL_STATS
+    rtpoolStatsAlloc(pool, index != RTPOOL_NO_INDEX);
+#endif
+    return index;
+}
+
+
+void RTPoolFreeIndex(RTPool* pool, RTPoolIndex index)
+{
+    RTASSERT(pool != NULL);
+    RTASSERT(index < pool->fresh);
+    RTASSERT(pool->inUse > 0);
+
+    /* The link may be unaligned, so it is copied byte by byte */
+    RTMemcpy(rtpoolBlock(pool, index), sizeof(pool->freeHead),
+            (const RTByte*)&(pool->freeHead), sizeof(pool->freeHead));
+    pool->freeHead = index;
+    pool->inUse--;
+#if RTPOOL_STATS
+    pool->stats.frees++;
+#endif
+}
+
+
+void* RTPoolBlock(const RTPool* pool, RTPoolIndex index)
+{
+    RTASSERT(pool != NULL);
+    RTASSERT(index < pool->capacity);
+    return rtpoolBlock(pool, index);
+}
+
+
+RTPoolIndex RTPoolIndexOf(const RTPool* pool, const void* block)
+{
+    size_t offset_B;
+
+    RTASSERT(pool != NULL);
+    RTASSERT((const RTByte*)block >= pool->buffer);
+
+    offset_B = (size_t)((const RTByte*)block - pool->buffer);
+    RTASSERT((offset_B % pool->blockSize_B) == 0);
+    RTASSERT((offset_B / pool->blockSize_B) < pool->capacity);
+    return (RTPoolIndex)(offset_B / pool->blockSize_B);
+}
+
+
+#if RTPOOL_STATS
+void RTPoolReadStats(RTPool* pool, RTPoolStats* stats, RTBool reset)
+{
+    RTASSERT(pool != NULL);
+    RTASSERT(stats != NULL);
+
+    *stats = pool->stats;
+    if (reset) {
+        pool->stats.allocs = 0;
+        pool->stats.frees = 0;
+        pool->stats.allocFailures = 0;
+        pool->stats.highWatermark = pool->inUse;
+    }
+}
+#endif
+
+
+
+/*----------------------------------+
+ | Private function implementations |
+ +----------------------------------*/
+
+
+static RTByte* rtpoolBlock(const RTPool* pool, RTPoolIndex index)
+{
+    return &(pool->buffer[(size_t)index * pool->blockSize_B]);
+}
+
+
+#if RTPOOL_STATS
+static void rtpoolStatsAlloc(RTPool* pool, RTBool ok)
+{
+    if (ok) {
+        pool->stats.allocs++;
+        if (pool->inUse > pool->stats.highWatermark) {
+            pool->stats.highWatermark = pool->inUse;
+        }
+    } else {
+        pool->stats.allocFailures++;
+    }
+}
+#endif
@@ -0,0 +1,164 @@
+/* Copyright (c) 2014-2016  Fabrice Triboix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "rtpool.h"
+#include "rtfifo.h"
+#include "rttest.h"
+#include "rtplf.h"
+
+
+typedef struct {
+    uint16_t a;
+    uint16_t b;
+    uint16_t c;
+} TPoolBlock;
+
+static TPoolBlock gPoolBuffer[4];
+static RTPool gPool = RT_POOL_INIT(gPoolBuffer);
+
+static uint32_t gIndexBuffer[16];
+static RTPool gIndexPool;
+static RTPoolIndex gIndexFifoBuffer[16];
+static RTFifo gIndexFifo = RT_FIFO_INIT(gIndexFifoBuffer);
+
+#if RTPOOL_STATS
+static TPoolBlock gStatsBuffer[2];
+static RTPool gStatsPool = RT_POOL_INIT(gStatsBuffer);
+#endif
+
+
+RTT_GROUP_START(TestPool, 0x00050001u, NULL, NULL)
+
+RTT_TEST_START(pool_should_be_unused_after_creation)
+{
+    RTT_ASSERT(RTPoolCapacity(&gPool) == 4u);
+    RTT_ASSERT(RTPoolInUse(&gPool) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(pool_should_allocate_every_block_once)
+{
+    TPoolBlock* blocks[4];
+    uint32_t i;
+    uint32_t j;
+
+    for (i = 0; i < 4; i++) {
+        blocks[i] = (TPoolBlock*)RTPoolAlloc(&gPool);
+        RTT_ASSERT(blocks[i] != NULL);
+        RTT_ASSERT((blocks[i] >= &gPoolBuffer[0])
+                && (blocks[i] <= &gPoolBuffer[3]));
+        for (j = 0; j < i; j++) {
+            RTT_ASSERT(blocks[j] != blocks[i]);
+        }
+        blocks[i]->a = (uint16_t)i;
+        blocks[i]->b = 0xA5A5u;
+        blocks[i]->c = (uint16_t)~i;
+    }
+    RTT_ASSERT(RTPoolInUse(&gPool) == 4u);
+    RTT_ASSERT(RTPoolAlloc(&gPool) == NULL);
+    for (i = 0; i < 4; i++) {
+        RTT_EXPECT(blocks[i]->a == i);
+        RTT_EXPECT(blocks[i]->c == (uint16_t)~i);
+    }
+}
+RTT_TEST_END
+
+RTT_TEST_START(pool_should_reuse_freed_blocks)
+{
+    TPoolBlock* block1 = (TPoolBlock*)RTPoolBlock(&gPool, 1);
+    TPoolBlock* block3 = (TPoolBlock*)RTPoolBlock(&gPool, 3);
+
+    RTPoolFree(&gPool, block1);
+    RTPoolFree(&gPool, block3);
+    RTT_ASSERT(RTPoolInUse(&gPool) == 2u);
+    RTT_EXPECT(RTPoolAlloc(&gPool) == block3);
+    RTT_EXPECT(RTPoolAlloc(&gPool) == block1);
+    RTT_ASSERT(RTPoolAlloc(&gPool) == NULL);
+    RTT_ASSERT(RTPoolInUse(&gPool) == 4u);
+    for (block1 = gPoolBuffer; block1 < &gPoolBuffer[4]; block1++) {
+        RTPoolFree(&gPool, block1);
+    }
+    RTT_ASSERT(RTPoolInUse(&gPool) == 0);
+}
+RTT_TEST_END
+
+RTT_TEST_START(pool_should_pass_block_indices_through_a_fifo)
+{
+    RTPoolIndex index;
+    uint32_t* block;
+    uint32_t i;
+
+    RTPoolInit(&gIndexPool, RTARRAYSIZE(gIndexBuffer), sizeof(uint32_t),
+            (RTByte*)gIndexBuffer);
+    for (i = 0; i < 16; i++) {
+        index = RTPoolAllocIndex(&gIndexPool);
+        RTT_ASSERT(index != RTPOOL_NO_INDEX);
+        block = (uint32_t*)RTPoolBlock(&gIndexPool, index);
+        RTT_ASSERT(RTPoolIndexOf(&gIndexPool, block) == index);
+        *block = 1000u + i;
+        RTT_ASSERT(RTFifoPush(&gIndexFifo, &index, sizeof(index)));
+    }
+    RTT_ASSERT(RTPoolAllocIndex(&gIndexPool) == RTPOOL_NO_INDEX);
+
+    for (i = 0; i < 16; i++) {
+        RTT_ASSERT(RTFifoPop(&gIndexFifo, &index, sizeof(index)));
+        block = (uint32_t*)RTPoolBlock(&gIndexPool, index);
+        RTT_EXPECT(*block == (1000u + i));
+        RTPoolFreeIndex(&gIndexPool, index);
+    }
+    RTT_ASSERT(RTPoolInUse(&gIndexPool) == 0);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestPool,
+        pool_should_be_unused_after_creation,
+        pool_should_allocate_every_block_once,
+        pool_should_reuse_freed_blocks,
+        pool_should_pass_block_indices_through_a_fifo)
+
+
+#if RTPOOL_STATS
+RTT_GROUP_START(TestPoolStats, 0x00050002u, NULL, NULL)
+
+RTT_TEST_START(pool_stats_should_count_allocations_and_frees)
+{
+    RTPoolStats stats;
+    void* block1;
+    void* block2;
+
+    block1 = RTPoolAlloc(&gStatsPool);
+    block2 = RTPoolAlloc(&gStatsPool);
+    RTT_ASSERT((block1 != NULL) && (block2 != NULL));
+    RTT_ASSERT(RTPoolAlloc(&gStatsPool) == NULL);
+    RTPoolFree(&gStatsPool, block2);
+
+    RTPoolReadStats(&gStatsPool, &stats, RTTrue);
+    RTT_EXPECT(stats.allocs == 2u);
+    RTT_EXPECT(stats.frees == 1u);
+    RTT_EXPECT(stats.allocFailures == 1u);
+    RTT_EXPECT(stats.highWatermark == 2u);
+
+    RTPoolReadStats(&gStatsPool, &stats, RTFalse);
+    RTT_EXPECT(stats.allocs == 0);
+    RTT_EXPECT(stats.highWatermark == 1u);
+    RTPoolFree(&gStatsPool, block1);
+}
+RTT_TEST_END
+
+RTT_GROUP_END(TestPoolStats,
+        pool_stats_should_count_allocations_and_frees)
+#endif